@@ -13,10 +13,24 @@ using json = nlohmann::json;
 
 std::unordered_map<std::string, std::any> ramMap;
 
+// How long a deferred save waits for more changes before writing
+static constexpr auto saveDebounceDelay = std::chrono::milliseconds(500);
+
 Mercury::Mercury(std::string path) : path_(std::move(path)) {
     this->reload();
 }
 
+Mercury::~Mercury() {
+    {
+        std::lock_guard<std::mutex> lock(this->saveMutex_);
+        this->stopSaveThread_ = true;
+    }
+    this->saveCondition_.notify_all();
+    if (this->saveThread_.joinable()) {
+        this->saveThread_.join();
+    }
+}
+
 std::string Mercury::formatNestedKey(const std::string& key) {
     std::vector<std::string> dots = StringHelper::Split(key, ".");
 
@@ -121,7 +135,100 @@ void Mercury::reload() {
     }
 }
 
-void Mercury::save() const {
-    std::ofstream file(this->path_);
-    file << this->vjson.unflatten().dump(4);
+void Mercury::save() {
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(this->saveMutex_);
+        this->savePending_ = false;
+        this->pendingJson_ = nullptr;
+        generation = ++this->saveGeneration_;
+    }
+    this->write(this->vjson, generation);
+}
+
+void Mercury::saveDeferred() {
+    {
+        std::lock_guard<std::mutex> lock(this->saveMutex_);
+        // Copying the flat json is much cheaper than serializing it and writing it out
+        this->pendingJson_ = this->vjson;
+        this->savePending_ = true;
+        this->saveDeadline_ = std::chrono::steady_clock::now() + saveDebounceDelay;
+        ++this->saveGeneration_;
+        if (!this->saveThread_.joinable()) {
+            this->saveThread_ = std::thread(&Mercury::saveThreadMain, this);
+        }
+    }
+    this->saveCondition_.notify_all();
+}
+
+void Mercury::flush() {
+    nlohmann::json flat;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(this->saveMutex_);
+        if (!this->savePending_) {
+            return;
+        }
+        this->savePending_ = false;
+        flat = std::move(this->pendingJson_);
+        generation = this->saveGeneration_;
+    }
+    this->write(flat, generation);
+}
+
+void Mercury::saveThreadMain() {
+    std::unique_lock<std::mutex> lock(this->saveMutex_);
+    while (true) {
+        if (!this->savePending_) {
+            if (this->stopSaveThread_) {
+                return;
+            }
+            this->saveCondition_.wait(lock);
+            continue;
+        }
+
+        // Keep waiting while saves keep coming in, unless we are shutting down
+        if (!this->stopSaveThread_ && std::chrono::steady_clock::now() < this->saveDeadline_) {
+            this->saveCondition_.wait_until(lock, this->saveDeadline_);
+            continue;
+        }
+
+        nlohmann::json flat = std::move(this->pendingJson_);
+        uint64_t generation = this->saveGeneration_;
+        this->savePending_ = false;
+
+        lock.unlock();
+        this->write(flat, generation);
+        lock.lock();
+    }
+}
+
+void Mercury::write(const nlohmann::json& flat, uint64_t generation) {
+    std::lock_guard<std::mutex> lock(this->writeMutex_);
+    if (generation <= this->writtenGeneration_) {
+        return;
+    }
+
+    // Write to a temporary file first and rename it over the config, so a crash mid write never leaves a truncated file
+    const std::string tempPath = this->path_ + ".tmp";
+    // Serialized up front, so nothing that throws runs while the temporary file exists
+    const std::string contents = flat.unflatten().dump(4);
+    std::error_code error;
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        file << contents;
+        file.close();
+        if (file.fail()) {
+            fs::remove(tempPath, error);
+            return;
+        }
+    }
+
+    fs::rename(tempPath, this->path_, error);
+    if (error) {
+        fs::remove(tempPath, error);
+        return;
+    }
+
+    this->writtenGeneration_ = generation;
 }
@@ -2,6 +2,10 @@
 #include <any>
 #include <vector>
 #include <string>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <nlohmann/json.hpp>
 
 static const std::string mercuryRGBAObjectType = "RGBA";
@@ -10,8 +14,25 @@ static const std::string mercuryRGBObjectType = "RGB";
 class Mercury {
 protected:
     std::string path_;
+
+    // Deferred saves: the latest requested snapshot is written by saveThread_ once no new save was requested for the
+    // debounce delay. Every save gets a generation, so an older snapshot never overwrites a newer one.
+    std::mutex saveMutex_;
+    std::condition_variable saveCondition_;
+    std::thread saveThread_;
+    nlohmann::json pendingJson_;
+    bool savePending_ = false;
+    bool stopSaveThread_ = false;
+    std::chrono::steady_clock::time_point saveDeadline_;
+    uint64_t saveGeneration_ = 0;
+    std::mutex writeMutex_;
+    uint64_t writtenGeneration_ = 0;
+
+    void saveThreadMain();
+    void write(const nlohmann::json& flat, uint64_t generation);
 public:
     explicit Mercury(std::string path);
+    ~Mercury();
 
     nlohmann::json vjson;
     nlohmann::json rjson;
@@ -33,7 +54,12 @@ public:
     template< typename T > void setArray(const std::string& key, std::vector<T> array);
 
     void reload();
-    void save() const;
+    // Writes the file right away on the calling thread
+    void save();
+    // Writes the file on a background thread, coalescing saves requested in quick succession
+    void saveDeferred();
+    // Writes a pending deferred save right away
+    void flush();
     bool isNewInstance = false;
 };
 
@@ -203,12 +203,23 @@ static DWORD WriteDataToMpqFile(
                     // if they are unable to compress the data.
                     //
 
-                    if(pFileEntry->dwFlags & MPQ_FILE_IMPLODE)
+                    // OTR: The caller already compressed the sector, it is only copied
+                    if(hf->ppvPrecompressed != NULL)
+                    {
+                        nOutBuffer = (int)hf->pdwPrecompressedSizes[dwSectorIndex];
+                        if(nOutBuffer > nInBuffer)
+                        {
+                            dwErrCode = ERROR_INVALID_PARAMETER;
+                            break;
+                        }
+                        memcpy(pbCompressed, hf->ppvPrecompressed[dwSectorIndex], nOutBuffer);
+                    }
+                    else if(pFileEntry->dwFlags & MPQ_FILE_IMPLODE)
                     {
                         SCompImplode(pbCompressed, &nOutBuffer, hf->pbFileSector, nInBuffer);
                     }
 
-                    if(pFileEntry->dwFlags & MPQ_FILE_COMPRESS)
+                    if(hf->ppvPrecompressed == NULL && (pFileEntry->dwFlags & MPQ_FILE_COMPRESS))
                     {
                         // If this is the first sector, we need to override the given compression
                         // by the first sector compression. This is because the entire sector must
@@ -861,6 +872,47 @@ bool WINAPI SFileWriteFile(
     return (dwErrCode == ERROR_SUCCESS);
 }
 
+// OTR: Lets callers compress the sectors on other threads. The sectors only line up with the file when it is written
+// in a single call, and they must come from SCompCompress with the same compression and sector size.
+bool WINAPI SFileWriteFilePrecompressed(
+    HANDLE hFile,
+    const void * pvData,
+    DWORD dwSize,
+    DWORD dwCompression,
+    const void * const * ppvSectors,
+    const DWORD * pdwSectorSizes)
+{
+    TMPQFile * hf = (TMPQFile *)hFile;
+    DWORD dwErrCode = ERROR_SUCCESS;
+
+    // Check the proper parameters
+    if(!IsValidFileHandle(hFile))
+        dwErrCode = ERROR_INVALID_HANDLE;
+    if(dwErrCode == ERROR_SUCCESS && hf->bIsWriteHandle == false)
+        dwErrCode = ERROR_INVALID_HANDLE;
+    if(dwErrCode == ERROR_SUCCESS && (hf->dwFilePos != 0 || dwSize != hf->pFileEntry->dwFileSize))
+        dwErrCode = ERROR_INVALID_PARAMETER;
+    if(dwErrCode == ERROR_SUCCESS && (hf->pFileEntry->dwFlags & (MPQ_FILE_COMPRESS_MASK | MPQ_FILE_SINGLE_UNIT)) != MPQ_FILE_COMPRESS)
+        dwErrCode = ERROR_INVALID_PARAMETER;
+    if(ppvSectors == NULL || pdwSectorSizes == NULL)
+        dwErrCode = ERROR_INVALID_PARAMETER;
+
+    // Write the data to the file
+    if(dwErrCode == ERROR_SUCCESS)
+    {
+        hf->ppvPrecompressed = ppvSectors;
+        hf->pdwPrecompressedSizes = pdwSectorSizes;
+        dwErrCode = SFileAddFile_Write(hf, pvData, dwSize, dwCompression);
+        hf->ppvPrecompressed = NULL;
+        hf->pdwPrecompressedSizes = NULL;
+    }
+
+    // Deal with errors
+    if(dwErrCode != ERROR_SUCCESS)
+        SetLastError(dwErrCode);
+    return (dwErrCode == ERROR_SUCCESS);
+}
+
 bool WINAPI SFileFinishFile(HANDLE hFile)
 {
     TMPQFile * hf = (TMPQFile *)hFile;
@@ -901,6 +901,10 @@ typedef struct _TMPQFile
     bool           bLoadedSectorCRCs;           // If true, we already tried to load sector CRCs
     bool           bCheckSectorCRCs;            // If true, then SFileReadFile will check sector CRCs when reading the file
     bool           bIsWriteHandle;              // If true, this handle has been created by SFileCreateFile
+
+    // OTR
+    const void * const * ppvPrecompressed;      // Sectors compressed by the caller, see SFileWriteFilePrecompressed
+    const DWORD  * pdwPrecompressedSizes;       // Size of each precompressed sector
 } TMPQFile;
 
 // Structure for SFileFindFirstFile and SFileFindNextFile
@@ -1102,6 +1106,8 @@ DWORD  WINAPI SFileEnumLocales(HANDLE hMpq, const char * szFileName, LCID * PtrF
 
 bool   WINAPI SFileCreateFile(HANDLE hMpq, const char * szArchivedName, ULONGLONG FileTime, DWORD dwFileSize, LCID lcFileLocale, DWORD dwFlags, HANDLE * phFile);
 bool   WINAPI SFileWriteFile(HANDLE hFile, const void * pvData, DWORD dwSize, DWORD dwCompression);
+// OTR: Writes the whole file at once like SFileWriteFile, with each sector already compressed by SCompCompress
+bool   WINAPI SFileWriteFilePrecompressed(HANDLE hFile, const void * pvData, DWORD dwSize, DWORD dwCompression, const void * const * ppvSectors, const DWORD * pdwSectorSizes);
 bool   WINAPI SFileFinishFile(HANDLE hFile);
 
 bool   WINAPI SFileAddFileEx(HANDLE hMpq, const TCHAR * szFileName, const char * szArchivedName, DWORD dwFlags, DWORD dwCompression, DWORD dwCompressionNext);
@@ -178,6 +178,7 @@
 #define G_MTX_OTR 0x36
 #define G_TEXRECT_WIDE 0x37
 #define G_FILLWIDERECT 0x38
+#define G_INTERP_TAG 0x2a
 
 /* GFX Effects */
 
@@ -2659,6 +2660,21 @@ typedef union {
 #define gsSPGrayscale(state) \
     { (_SHIFTL(G_SETGRAYSCALE, 24, 8)), (state) }
 
+/*
+ * Tags the matrices and vertices loaded after it for frame interpolation, until the next tag or the end of the display
+ * list. Every object should use its own non zero tag that stays the same across game ticks, 0 removes the tag.
+ */
+#define gSPInterpolationTag(pkt, tag)                \
+    {                                                \
+        Gfx* _g = (Gfx*)(pkt);                       \
+                                                     \
+        _g->words.w0 = _SHIFTL(G_INTERP_TAG, 24, 8); \
+        _g->words.w1 = (unsigned int)(tag);          \
+    }
+
+#define gsSPInterpolationTag(tag) \
+    { (_SHIFTL(G_INTERP_TAG, 24, 8)), (unsigned int)(tag) }
+
 #ifdef F3DEX_GBI_2
 /*
  *  One gSPGeometryMode(pkt,c,s) GBI is equal to these two GBIs.
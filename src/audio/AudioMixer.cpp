@@ -0,0 +1,572 @@
+#include "AudioMixer.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define AUDIO_MIXER_SSE2
+#endif
+
+#define ROUND_UP_64(v) (((v) + 63) & ~63)
+#define ROUND_UP_32(v) (((v) + 31) & ~31)
+#define ROUND_UP_16(v) (((v) + 15) & ~15)
+#define ROUND_UP_8(v) (((v) + 7) & ~7)
+#define ROUND_DOWN_16(v) ((v) & ~0xF)
+
+namespace Ship {
+// Interpolation filter of the resample command, one row of 4 taps per 1/64th of a sample. Stored unsigned so the
+// negative taps can be written as they appear in the microcode data.
+static const uint16_t sResampleTable[64][4] = {
+    { 0x0c39, 0x66ad, 0x0d46, 0xffdf }, { 0x0b39, 0x6696, 0x0e5f, 0xffd8 },
+    { 0x0a44, 0x6669, 0x0f83, 0xffd0 }, { 0x095a, 0x6626, 0x10b4, 0xffc8 },
+    { 0x087d, 0x65cd, 0x11f0, 0xffbf }, { 0x07ab, 0x655e, 0x1338, 0xffb6 },
+    { 0x06e4, 0x64d9, 0x148c, 0xffac }, { 0x0628, 0x643f, 0x15eb, 0xffa1 },
+    { 0x0577, 0x638f, 0x1756, 0xff96 }, { 0x04d1, 0x62cb, 0x18cb, 0xff8a },
+    { 0x0435, 0x61f3, 0x1a4c, 0xff7e }, { 0x03a4, 0x6106, 0x1bd7, 0xff71 },
+    { 0x031c, 0x6007, 0x1d6c, 0xff64 }, { 0x029f, 0x5ef5, 0x1f0b, 0xff56 },
+    { 0x022a, 0x5dd0, 0x20b3, 0xff48 }, { 0x01be, 0x5c9a, 0x2264, 0xff3a },
+    { 0x015b, 0x5b53, 0x241e, 0xff2c }, { 0x0101, 0x59fc, 0x25e0, 0xff1e },
+    { 0x00ae, 0x5896, 0x27a9, 0xff10 }, { 0x0063, 0x5720, 0x297a, 0xff02 },
+    { 0x001f, 0x559d, 0x2b50, 0xfef4 }, { 0xffe2, 0x540d, 0x2d2c, 0xfee8 },
+    { 0xffac, 0x5270, 0x2f0d, 0xfedb }, { 0xff7c, 0x50c7, 0x30f3, 0xfed0 },
+    { 0xff53, 0x4f14, 0x32dc, 0xfec6 }, { 0xff2e, 0x4d57, 0x34c8, 0xfebd },
+    { 0xff0f, 0x4b91, 0x36b6, 0xfeb6 }, { 0xfef5, 0x49c2, 0x38a5, 0xfeb0 },
+    { 0xfedf, 0x47ed, 0x3a95, 0xfeac }, { 0xfece, 0x4611, 0x3c85, 0xfeab },
+    { 0xfec0, 0x4430, 0x3e74, 0xfeac }, { 0xfeb6, 0x424a, 0x4060, 0xfeaf },
+    { 0xfeaf, 0x4060, 0x424a, 0xfeb6 }, { 0xfeac, 0x3e74, 0x4430, 0xfec0 },
+    { 0xfeab, 0x3c85, 0x4611, 0xfece }, { 0xfeac, 0x3a95, 0x47ed, 0xfedf },
+    { 0xfeb0, 0x38a5, 0x49c2, 0xfef5 }, { 0xfeb6, 0x36b6, 0x4b91, 0xff0f },
+    { 0xfebd, 0x34c8, 0x4d57, 0xff2e }, { 0xfec6, 0x32dc, 0x4f14, 0xff53 },
+    { 0xfed0, 0x30f3, 0x50c7, 0xff7c }, { 0xfedb, 0x2f0d, 0x5270, 0xffac },
+    { 0xfee8, 0x2d2c, 0x540d, 0xffe2 }, { 0xfef4, 0x2b50, 0x559d, 0x001f },
+    { 0xff02, 0x297a, 0x5720, 0x0063 }, { 0xff10, 0x27a9, 0x5896, 0x00ae },
+    { 0xff1e, 0x25e0, 0x59fc, 0x0101 }, { 0xff2c, 0x241e, 0x5b53, 0x015b },
+    { 0xff3a, 0x2264, 0x5c9a, 0x01be }, { 0xff48, 0x20b3, 0x5dd0, 0x022a },
+    { 0xff56, 0x1f0b, 0x5ef5, 0x029f }, { 0xff64, 0x1d6c, 0x6007, 0x031c },
+    { 0xff71, 0x1bd7, 0x6106, 0x03a4 }, { 0xff7e, 0x1a4c, 0x61f3, 0x0435 },
+    { 0xff8a, 0x18cb, 0x62cb, 0x04d1 }, { 0xff96, 0x1756, 0x638f, 0x0577 },
+    { 0xffa1, 0x15eb, 0x643f, 0x0628 }, { 0xffac, 0x148c, 0x64d9, 0x06e4 },
+    { 0xffb6, 0x1338, 0x655e, 0x07ab }, { 0xffbf, 0x11f0, 0x65cd, 0x087d },
+    { 0xffc8, 0x10b4, 0x6626, 0x095a }, { 0xffd0, 0x0f83, 0x6669, 0x0a44 },
+    { 0xffd8, 0x0e5f, 0x6696, 0x0b39 }, { 0xffdf, 0x0d46, 0x66ad, 0x0c39 },
+};
+
+static inline int16_t Clamp16(int32_t v) {
+    return (int16_t)std::clamp<int32_t>(v, INT16_MIN, INT16_MAX);
+}
+
+AudioMixer::AudioMixer() {
+    memset(mSegments, 0, sizeof(mSegments));
+    Reset();
+}
+
+void AudioMixer::Reset(void) {
+    mIn = 0;
+    mOut = 0;
+    mNumBytes = 0;
+    mVol[0] = mVol[1] = 0;
+    mRate[0] = mRate[1] = 0;
+    mVolWet = 0;
+    mRateWet = 0;
+    mAdpcmLoopState = nullptr;
+    memset(mAdpcmTable, 0, sizeof(mAdpcmTable));
+    mFilterCount = 0;
+    memset(mFilter, 0, sizeof(mFilter));
+    memset(mArena, 0, sizeof(mArena));
+}
+
+void AudioMixer::SetSegment(uint8_t segment, void* base) {
+    mSegments[segment & 0xF] = (uintptr_t)base;
+}
+
+void* AudioMixer::Resolve(uint32_t addr) {
+    const uintptr_t base = mSegments[(addr >> 24) & 0xF];
+    if (base != 0) {
+        return (void*)(base + (addr & 0xFFFFFF));
+    }
+
+    return (void*)(uintptr_t)addr;
+}
+
+uint8_t* AudioMixer::Dmem8(uint16_t addr) {
+    return mArena + AUDIO_MIXER_DMEM_GUARD + (addr & (AUDIO_MIXER_DMEM_SIZE - 1));
+}
+
+int16_t* AudioMixer::Dmem16(uint16_t addr) {
+    return (int16_t*)Dmem8(addr & ~1);
+}
+
+int16_t* AudioMixer::GetDmem(uint16_t addr) {
+    return Dmem16(addr);
+}
+
+void AudioMixer::Execute(const Acmd* cmds, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t w0 = cmds[i].words.w0;
+        const uint32_t w1 = cmds[i].words.w1;
+
+        switch (w0 >> 24) {
+            case A_CLEARBUFF:
+                ClearBuffer(w0 & 0xFFFF, w1 & 0xFFFF);
+                break;
+            case A_LOADBUFF:
+                LoadBuffer(Resolve(w1), w0 & 0xFFFF, ((w0 >> 16) & 0xFF) << 4);
+                break;
+            case A_SAVEBUFF:
+                SaveBuffer(w0 & 0xFFFF, Resolve(w1), ((w0 >> 16) & 0xFF) << 4);
+                break;
+            case A_LOADADPCM:
+                LoadADPCM(w0 & 0xFFFF, Resolve(w1));
+                break;
+            case A_SETBUFF:
+                mIn = w0 & 0xFFFF;
+                mOut = w1 >> 16;
+                mNumBytes = w1 & 0xFFFF;
+                break;
+            case A_INTERLEAVE:
+                Interleave(w0 & 0xFFFF, w1 >> 16, w1 & 0xFFFF, ((w0 >> 16) & 0xFF) << 4);
+                break;
+            case A_DMEMMOVE:
+                DMEMMove(w0 & 0xFFFF, w1 >> 16, w1 & 0xFFFF);
+                break;
+            case A_SETLOOP:
+                mAdpcmLoopState = (const int16_t*)Resolve(w1);
+                break;
+            case A_ADPCM:
+                ADPCMDecode((w0 >> 16) & 0xFF, (int16_t*)Resolve(w1));
+                break;
+            case A_S8DEC:
+                S8Decode((w0 >> 16) & 0xFF, (int16_t*)Resolve(w1));
+                break;
+            case A_RESAMPLE:
+                Resample((w0 >> 16) & 0xFF, w0 & 0xFFFF, (int16_t*)Resolve(w1));
+                break;
+            case A_RESAMPLE_ZOH:
+                ResampleZOH(w0 & 0xFFFF, w1 & 0xFFFF);
+                break;
+            case A_ENVSETUP1:
+                mVolWet = (uint16_t)(((w0 >> 16) & 0xFF) << 8);
+                mRateWet = w0 & 0xFFFF;
+                mRate[0] = w1 >> 16;
+                mRate[1] = w1 & 0xFFFF;
+                break;
+            case A_ENVSETUP2:
+                mVol[0] = w1 >> 16;
+                mVol[1] = w1 & 0xFFFF;
+                break;
+            case A_ENVMIXER:
+                // Buffer addresses are stored divided by 16 and the count is in samples. Bits 3 and 2 flip the left and
+                // right wet sends, bits 1 and 0 negate the left and right dry output.
+                EnvMixer(((w0 >> 16) & 0xFF) << 4, (w0 >> 8) & 0xFF, (w0 >> 4) & 1, (w0 >> 3) & 1, (w0 >> 2) & 1,
+                         (w0 >> 1) & 1, w0 & 1, (w1 >> 24) << 4, ((w1 >> 16) & 0xFF) << 4, ((w1 >> 8) & 0xFF) << 4,
+                         (w1 & 0xFF) << 4);
+                break;
+            case A_MIXER:
+                Mix((w0 >> 16) & 0xFF, (int16_t)(w0 & 0xFFFF), w1 >> 16, w1 & 0xFFFF);
+                break;
+            case A_ADDMIXER:
+                AddMixer(((w0 >> 16) & 0xFF) << 4, w1 >> 16, w1 & 0xFFFF);
+                break;
+            case A_DUPLICATE:
+                Duplicate((w0 >> 16) & 0xFF, w0 & 0xFFFF, w1 >> 16);
+                break;
+            case A_INTERL:
+                Interl(w1 >> 16, w1 & 0xFFFF, w0 & 0xFFFF);
+                break;
+            case A_FILTER:
+                Filter((w0 >> 16) & 0xFF, w0 & 0xFFFF, (int16_t*)Resolve(w1));
+                break;
+            case A_HILOGAIN:
+                HiLoGain((w0 >> 16) & 0xFF, w0 & 0xFFFF, w1 >> 16);
+                break;
+            case A_UNK19:
+                Unknown25((w0 >> 16) & 0xFF, w0 & 0xFFFF, w1 >> 16, w1 & 0xFFFF);
+                break;
+            case A_SPNOOP:
+            case A_UNK3:
+            default:
+                break;
+        }
+    }
+}
+
+void AudioMixer::ClearBuffer(uint16_t addr, int nbytes) {
+    memset(Dmem8(addr), 0, ROUND_UP_16(nbytes));
+}
+
+void AudioMixer::LoadBuffer(const void* src, uint16_t dest, int nbytes) {
+    memcpy(Dmem8(dest), src, ROUND_DOWN_16(nbytes));
+}
+
+void AudioMixer::SaveBuffer(uint16_t src, void* dest, int nbytes) {
+    memcpy(dest, Dmem8(src), ROUND_DOWN_16(nbytes));
+}
+
+void AudioMixer::LoadADPCM(int nbytes, const void* book) {
+    memcpy(mAdpcmTable, book, std::min<size_t>(nbytes, sizeof(mAdpcmTable)));
+}
+
+void AudioMixer::Interleave(uint16_t dest, uint16_t left, uint16_t right, int nbytes) {
+    const int16_t* l = Dmem16(left);
+    const int16_t* r = Dmem16(right);
+    int16_t* d = Dmem16(dest);
+    const int count = ROUND_UP_8(nbytes) / sizeof(int16_t);
+
+    // The output may overlap the inputs, so each group of 4 is read before it is written
+    for (int i = 0; i < count; i += 4) {
+        int16_t tmp[8];
+        for (int j = 0; j < 4; j++) {
+            tmp[j * 2] = l[i + j];
+            tmp[j * 2 + 1] = r[i + j];
+        }
+        memcpy(d + i * 2, tmp, sizeof(tmp));
+    }
+}
+
+void AudioMixer::DMEMMove(uint16_t in, uint16_t out, int nbytes) {
+    memmove(Dmem8(out), Dmem8(in), ROUND_UP_16(nbytes));
+}
+
+void AudioMixer::ADPCMDecode(uint8_t flags, int16_t* state) {
+    const uint8_t* in = Dmem8(mIn);
+    int16_t* out = Dmem16(mOut);
+    int nbytes = ROUND_UP_32(mNumBytes);
+
+    if (flags & A_INIT) {
+        memset(out, 0, 16 * sizeof(int16_t));
+    } else if ((flags & A_LOOP) && mAdpcmLoopState != nullptr) {
+        memcpy(out, mAdpcmLoopState, 16 * sizeof(int16_t));
+    } else {
+        memcpy(out, state, 16 * sizeof(int16_t));
+    }
+    out += 16;
+
+    while (nbytes > 0) {
+        const int shift = *in >> 4;
+        const int16_t(*book)[8] = mAdpcmTable[*in++ & 0x7];
+
+        for (int half = 0; half < 2; half++) {
+            int32_t ins[8];
+            if (flags & 4) {
+                // 2 bit samples
+                for (int j = 0; j < 2; j++) {
+                    ins[j * 4] = (int16_t)((int32_t)((uint32_t)*in << 24) >> 30 << shift);
+                    ins[j * 4 + 1] = (int16_t)((int32_t)((uint32_t)*in << 26) >> 30 << shift);
+                    ins[j * 4 + 2] = (int16_t)((int32_t)((uint32_t)*in << 28) >> 30 << shift);
+                    ins[j * 4 + 3] = (int16_t)((int32_t)((uint32_t)*in++ << 30) >> 30 << shift);
+                }
+            } else {
+                for (int j = 0; j < 4; j++) {
+                    ins[j * 2] = (int16_t)((int32_t)((uint32_t)*in << 24) >> 28 << shift);
+                    ins[j * 2 + 1] = (int16_t)((int32_t)((uint32_t)*in++ << 28) >> 28 << shift);
+                }
+            }
+
+            // Each output depends on the two previous frame outputs and the residuals before it. The inner sum over
+            // the residuals has no dependency between outputs, which lets the compiler vectorize it.
+            const int32_t prev2 = out[-2];
+            const int32_t prev1 = out[-1];
+            int32_t acc[8];
+            for (int j = 0; j < 8; j++) {
+                acc[j] = book[0][j] * prev2 + book[1][j] * prev1 + (ins[j] << 11);
+            }
+            for (int k = 0; k < 7; k++) {
+                for (int j = k + 1; j < 8; j++) {
+                    acc[j] += book[1][j - k - 1] * ins[k];
+                }
+            }
+            for (int j = 0; j < 8; j++) {
+                *out++ = Clamp16(acc[j] >> 11);
+            }
+        }
+        nbytes -= 16 * sizeof(int16_t);
+    }
+
+    memcpy(state, out - 16, 16 * sizeof(int16_t));
+}
+
+void AudioMixer::S8Decode(uint8_t flags, int16_t* state) {
+    const uint8_t* in = Dmem8(mIn);
+    int16_t* out = Dmem16(mOut);
+    int nbytes = ROUND_UP_32(mNumBytes);
+
+    if (flags & A_INIT) {
+        memset(out, 0, 16 * sizeof(int16_t));
+    } else if ((flags & A_LOOP) && mAdpcmLoopState != nullptr) {
+        memcpy(out, mAdpcmLoopState, 16 * sizeof(int16_t));
+    } else {
+        memcpy(out, state, 16 * sizeof(int16_t));
+    }
+    out += 16;
+
+    while (nbytes > 0) {
+        for (int i = 0; i < 16; i++) {
+            *out++ = (int16_t)(in[i] << 8);
+        }
+        in += 16;
+        nbytes -= 16 * sizeof(int16_t);
+    }
+
+    memcpy(state, out - 16, 16 * sizeof(int16_t));
+}
+
+void AudioMixer::Resample(uint8_t flags, uint16_t pitch, int16_t* state) {
+    int16_t tmp[16];
+    int16_t* inInitial = Dmem16(mIn);
+    int16_t* in = inInitial;
+    int16_t* out = Dmem16(mOut);
+    int nbytes = ROUND_UP_16(mNumBytes);
+
+    if (flags & A_INIT) {
+        memset(tmp, 0, sizeof(tmp));
+    } else {
+        memcpy(tmp, state, sizeof(tmp));
+    }
+    if (flags & 2) {
+        memcpy(in - 8, tmp + 8, 8 * sizeof(int16_t));
+        // The stored offset is in bytes and rounds towards negative infinity, like the unsigned division it replaces
+        in -= tmp[5] >> 1;
+    }
+    in -= 4;
+    uint32_t pitchAccumulator = (uint16_t)tmp[4];
+    memcpy(in, tmp, 4 * sizeof(int16_t));
+
+    do {
+        for (int i = 0; i < 8; i++) {
+            const uint16_t* tbl = sResampleTable[pitchAccumulator * 64 >> 16];
+            const int32_t sample = ((in[0] * (int16_t)tbl[0] + 0x4000) >> 15) +
+                                   ((in[1] * (int16_t)tbl[1] + 0x4000) >> 15) +
+                                   ((in[2] * (int16_t)tbl[2] + 0x4000) >> 15) +
+                                   ((in[3] * (int16_t)tbl[3] + 0x4000) >> 15);
+            *out++ = Clamp16(sample);
+
+            pitchAccumulator += (uint32_t)pitch << 1;
+            in += pitchAccumulator >> 16;
+            pitchAccumulator &= 0xFFFF;
+        }
+        nbytes -= 8 * sizeof(int16_t);
+    } while (nbytes > 0);
+
+    state[4] = (int16_t)pitchAccumulator;
+    memcpy(state, in, 4 * sizeof(int16_t));
+    int i = (in - inInitial + 4) & 7;
+    in -= i;
+    if (i != 0) {
+        i = -8 - i;
+    }
+    state[5] = i;
+    memcpy(state + 8, in, 8 * sizeof(int16_t));
+}
+
+void AudioMixer::ResampleZOH(uint16_t pitch, uint16_t startFract) {
+    const int16_t* in = Dmem16(mIn);
+    int16_t* out = Dmem16(mOut);
+    const int count = ROUND_UP_8(mNumBytes) / sizeof(int16_t);
+    uint32_t position = startFract;
+    const uint32_t step = (uint32_t)pitch << 2;
+
+    for (int i = 0; i < count; i++) {
+        out[i] = in[position >> 17];
+        position += step;
+    }
+}
+
+void AudioMixer::EnvMixer(uint16_t in, int count, bool swapReverb, bool wetNegLeft, bool wetNegRight, bool negLeft,
+                          bool negRight, uint16_t dryLeft, uint16_t dryRight, uint16_t wetLeft, uint16_t wetRight) {
+    const int16_t* src = Dmem16(in);
+    int16_t* dry[2] = { Dmem16(dryLeft), Dmem16(dryRight) };
+    int16_t* wet[2] = { Dmem16(wetLeft), Dmem16(wetRight) };
+    const int16_t negs[2] = { (int16_t)(negLeft ? -1 : 0), (int16_t)(negRight ? -1 : 0) };
+    // The microcode flips the wet sends with these masks rather than negating them
+    const int16_t wetNegs[2] = { (int16_t)(wetNegLeft ? -4 : 0), (int16_t)(wetNegRight ? -2 : 0) };
+    // The wet send of each side takes the scaled sample of the other side when the reverb is swapped
+    const int wetSource[2] = { swapReverb ? 1 : 0, swapReverb ? 0 : 1 };
+    uint16_t vols[2] = { mVol[0], mVol[1] };
+    uint16_t volWet = mVolWet;
+    int n = ROUND_UP_16(count);
+
+    // Volumes ramp once per group of 8 samples, within a group the gains are constant
+    do {
+#ifdef AUDIO_MIXER_SSE2
+        const __m128i samples = _mm_loadu_si128((const __m128i*)src);
+        __m128i scaled[2];
+        for (int j = 0; j < 2; j++) {
+            // Signed * unsigned high half: mulhi treats volumes >= 0x8000 as negative, adding the sample back fixes that
+            const __m128i vol = _mm_set1_epi16((int16_t)vols[j]);
+            __m128i hi = _mm_mulhi_epi16(samples, vol);
+            if (vols[j] & 0x8000) {
+                hi = _mm_add_epi16(hi, samples);
+            }
+            scaled[j] = _mm_xor_si128(hi, _mm_set1_epi16(negs[j]));
+        }
+        const __m128i volWetVec = _mm_set1_epi16((int16_t)volWet);
+        for (int j = 0; j < 2; j++) {
+            __m128i d = _mm_loadu_si128((const __m128i*)dry[j]);
+            _mm_storeu_si128((__m128i*)dry[j], _mm_adds_epi16(d, scaled[j]));
+
+            __m128i send = _mm_mulhi_epi16(scaled[wetSource[j]], volWetVec);
+            if (volWet & 0x8000) {
+                send = _mm_add_epi16(send, scaled[wetSource[j]]);
+            }
+            send = _mm_xor_si128(send, _mm_set1_epi16(wetNegs[j]));
+            __m128i w = _mm_loadu_si128((const __m128i*)wet[j]);
+            _mm_storeu_si128((__m128i*)wet[j], _mm_adds_epi16(w, send));
+        }
+#else
+        for (int i = 0; i < 8; i++) {
+            int16_t scaled[2];
+            for (int j = 0; j < 2; j++) {
+                scaled[j] = (int16_t)((src[i] * vols[j]) >> 16) ^ negs[j];
+            }
+            for (int j = 0; j < 2; j++) {
+                dry[j][i] = Clamp16(dry[j][i] + scaled[j]);
+                wet[j][i] = Clamp16(wet[j][i] + (((scaled[wetSource[j]] * volWet) >> 16) ^ wetNegs[j]));
+            }
+        }
+#endif
+        src += 8;
+        for (int j = 0; j < 2; j++) {
+            dry[j] += 8;
+            wet[j] += 8;
+        }
+        vols[0] += mRate[0];
+        vols[1] += mRate[1];
+        volWet += mRateWet;
+        n -= 8;
+    } while (n > 0);
+}
+
+void AudioMixer::Mix(int count, int16_t gain, uint16_t in, uint16_t out) {
+    const int16_t* src = Dmem16(in);
+    int16_t* dst = Dmem16(out);
+    const int samples = ROUND_UP_32(ROUND_DOWN_16(count << 4)) / sizeof(int16_t);
+    int i = 0;
+
+    if (gain == -0x8000) {
+        // Full negative gain subtracts the input
+        for (; i < samples; i++) {
+            dst[i] = Clamp16(dst[i] - src[i]);
+        }
+        return;
+    }
+
+#ifdef AUDIO_MIXER_SSE2
+    // madd on interleaved (out, in) pairs gives out * 0x7FFF + in * gain exactly in 32 bits
+    const __m128i gains = _mm_set1_epi32((int32_t)(((uint32_t)(uint16_t)gain << 16) | 0x7FFF));
+    const __m128i round = _mm_set1_epi32(0x4000);
+    for (; i + 8 <= samples; i += 8) {
+        const __m128i o = _mm_loadu_si128((const __m128i*)(dst + i));
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(o, s), gains);
+        __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(o, s), gains);
+        lo = _mm_srai_epi32(_mm_add_epi32(lo, round), 15);
+        hi = _mm_srai_epi32(_mm_add_epi32(hi, round), 15);
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_packs_epi32(lo, hi));
+    }
+#endif
+    for (; i < samples; i++) {
+        dst[i] = Clamp16((dst[i] * 0x7FFF + src[i] * gain + 0x4000) >> 15);
+    }
+}
+
+void AudioMixer::AddMixer(int nbytes, uint16_t in, uint16_t out) {
+    const int16_t* src = Dmem16(in);
+    int16_t* dst = Dmem16(out);
+    const int samples = ROUND_UP_64(ROUND_DOWN_16(nbytes)) / sizeof(int16_t);
+    int i = 0;
+
+#ifdef AUDIO_MIXER_SSE2
+    for (; i + 8 <= samples; i += 8) {
+        const __m128i o = _mm_loadu_si128((const __m128i*)(dst + i));
+        const __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_adds_epi16(o, s));
+    }
+#endif
+    for (; i < samples; i++) {
+        dst[i] = Clamp16(dst[i] + src[i]);
+    }
+}
+
+void AudioMixer::Duplicate(int count, uint16_t in, uint16_t out) {
+    uint8_t tmp[128];
+    memcpy(tmp, Dmem8(in), sizeof(tmp));
+
+    uint8_t* dst = Dmem8(out);
+    for (int i = 0; i <= count; i++) {
+        memcpy(dst + i * sizeof(tmp), tmp, sizeof(tmp));
+    }
+}
+
+void AudioMixer::Interl(uint16_t in, uint16_t out, int count) {
+    const int16_t* src = Dmem16(in);
+    int16_t* dst = Dmem16(out);
+    const int samples = ROUND_UP_8(count);
+
+    for (int i = 0; i < samples; i++) {
+        dst[i] = src[i * 2];
+    }
+}
+
+void AudioMixer::Filter(uint8_t flags, uint16_t countOrBuf, int16_t* stateOrFilter) {
+    if (flags > A_INIT) {
+        // Setup form: latch the sample count and the filter taps for the next call
+        mFilterCount = ROUND_UP_16(countOrBuf);
+        memcpy(mFilter, stateOrFilter, sizeof(mFilter));
+        return;
+    }
+
+    int16_t tmp[16];
+    int16_t tmp2[8];
+    int16_t* buf = Dmem16(countOrBuf);
+    int count = mFilterCount;
+
+    if (flags == A_INIT) {
+        std::fill_n(tmp, 8, 0);
+        memset(tmp2, 0, sizeof(tmp2));
+    } else {
+        memcpy(tmp, stateOrFilter, 8 * sizeof(int16_t));
+        memcpy(tmp2, stateOrFilter + 8, sizeof(tmp2));
+    }
+
+    for (int i = 0; i < 8; i++) {
+        mFilter[i] = (tmp2[i] + mFilter[i]) / 2;
+    }
+
+    do {
+        memcpy(tmp + 8, buf, 8 * sizeof(int16_t));
+        for (int i = 0; i < 8; i++) {
+            int64_t sample = 0x4000;
+            for (int j = 0; j < 8; j++) {
+                sample += tmp[i + j] * mFilter[7 - j];
+            }
+            buf[i] = Clamp16((int32_t)(sample >> 15));
+        }
+        memcpy(tmp, tmp + 8, 8 * sizeof(int16_t));
+        buf += 8;
+        count -= 8 * sizeof(int16_t);
+    } while (count > 0);
+
+    memcpy(stateOrFilter, tmp, 8 * sizeof(int16_t));
+    memcpy(stateOrFilter + 8, mFilter, 8 * sizeof(int16_t));
+}
+
+void AudioMixer::HiLoGain(uint8_t gain, int nbytes, uint16_t addr) {
+    int16_t* samples = Dmem16(addr);
+    const int count = ROUND_UP_32(nbytes) / sizeof(int16_t);
+
+    for (int i = 0; i < count; i++) {
+        samples[i] = Clamp16((samples[i] * gain) >> 4);
+    }
+}
+
+void AudioMixer::Unknown25(uint8_t offset, int nbytes, uint16_t out, uint16_t in) {
+    int16_t tbl[32];
+    memcpy(tbl, Dmem16(in + offset), sizeof(tbl));
+
+    int16_t* dst = Dmem16(out);
+    const int count = ROUND_UP_64(nbytes) / sizeof(int16_t);
+    for (int i = 0; i < count; i++) {
+        dst[i] = Clamp16(dst[i] * tbl[i & 31]);
+    }
+}
+} // namespace Ship
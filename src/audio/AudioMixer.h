@@ -0,0 +1,72 @@
+#pragma once
+
+#include "stdint.h"
+#include "stddef.h"
+#include "libultraship/libultra/abi.h"
+
+// DMEM is addressed with 12 bits like on the RSP
+#define AUDIO_MIXER_DMEM_SIZE 0x1000
+// Kernels round their counts up and the resampler reads behind its input, the guard areas keep that inside the arena
+#define AUDIO_MIXER_DMEM_GUARD 0x400
+
+namespace Ship {
+// Native implementation of the audio microcode command lists built with the abi.h macros. Each instance owns its own
+// DMEM arena and command state, so separate audio tasks can run on separate instances concurrently.
+class AudioMixer {
+  public:
+    AudioMixer();
+
+    // RDRAM addresses in commands are resolved as segment base + low 24 bits when the segment in bits 24-27 is set,
+    // otherwise they are used as host pointers directly. 64 bit hosts need segments since commands only hold 32 bits.
+    void SetSegment(uint8_t segment, void* base);
+    void Execute(const Acmd* cmds, size_t count);
+    void Reset(void);
+
+    // Direct DMEM access for callers that stage data without a load command
+    int16_t* GetDmem(uint16_t addr);
+
+  private:
+    void* Resolve(uint32_t addr);
+    int16_t* Dmem16(uint16_t addr);
+    uint8_t* Dmem8(uint16_t addr);
+
+    void ClearBuffer(uint16_t addr, int nbytes);
+    void LoadBuffer(const void* src, uint16_t dest, int nbytes);
+    void SaveBuffer(uint16_t src, void* dest, int nbytes);
+    void LoadADPCM(int nbytes, const void* book);
+    void Interleave(uint16_t dest, uint16_t left, uint16_t right, int nbytes);
+    void DMEMMove(uint16_t in, uint16_t out, int nbytes);
+    void ADPCMDecode(uint8_t flags, int16_t* state);
+    void S8Decode(uint8_t flags, int16_t* state);
+    void Resample(uint8_t flags, uint16_t pitch, int16_t* state);
+    void ResampleZOH(uint16_t pitch, uint16_t startFract);
+    void EnvMixer(uint16_t in, int count, bool swapReverb, bool wetNegLeft, bool wetNegRight, bool negLeft,
+                  bool negRight, uint16_t dryLeft, uint16_t dryRight, uint16_t wetLeft, uint16_t wetRight);
+    void Mix(int count, int16_t gain, uint16_t in, uint16_t out);
+    void AddMixer(int nbytes, uint16_t in, uint16_t out);
+    void Duplicate(int count, uint16_t in, uint16_t out);
+    void Interl(uint16_t in, uint16_t out, int count);
+    void Filter(uint8_t flags, uint16_t countOrBuf, int16_t* stateOrFilter);
+    void HiLoGain(uint8_t gain, int nbytes, uint16_t addr);
+    void Unknown25(uint8_t offset, int nbytes, uint16_t out, uint16_t in);
+
+    uintptr_t mSegments[16];
+
+    uint16_t mIn;
+    uint16_t mOut;
+    uint16_t mNumBytes;
+
+    uint16_t mVol[2];
+    uint16_t mRate[2];
+    uint16_t mVolWet;
+    uint16_t mRateWet;
+
+    const int16_t* mAdpcmLoopState;
+    int16_t mAdpcmTable[8][2][8];
+
+    int mFilterCount;
+    int16_t mFilter[8];
+
+    alignas(16) uint8_t mArena[AUDIO_MIXER_DMEM_GUARD + AUDIO_MIXER_DMEM_SIZE + AUDIO_MIXER_DMEM_GUARD];
+};
+} // namespace Ship
@@ -1,7 +1,16 @@
 #include "AudioPlayer.h"
+#include <algorithm>
+#include <cstring>
+
+// 4 is sizeof(int16_t) * num_channels (2 for stereo)
+#define AUDIO_FRAME_SIZE 4
+// About 185ms at 44100Hz, well above anything the game keeps buffered
+#define AUDIO_RING_BUFFER_SIZE (8192 * AUDIO_FRAME_SIZE)
 
 namespace Ship {
-AudioPlayer::AudioPlayer() : mInitialized(false){};
+AudioPlayer::AudioPlayer()
+    : mInitialized(false), mRingBuffer(AUDIO_RING_BUFFER_SIZE), mUnderruns(0), mOverruns(0), mDesiredBuffered(2480),
+      mDeviceSampleRate(GetSampleRate()){};
 
 bool AudioPlayer::Init(void) {
     mInitialized = DoInit();
@@ -12,4 +21,59 @@ bool AudioPlayer::IsInitialized(void) {
     return mInitialized;
 }
 
+int AudioPlayer::GetDesiredBuffered(void) {
+    return mDesiredBuffered;
+}
+
+void AudioPlayer::SetDesiredBuffered(int frames) {
+    mDesiredBuffered = std::max(frames, 1);
+}
+
+int AudioPlayer::GetDeviceSampleRate() const {
+    return mDeviceSampleRate;
+}
+
+void AudioPlayer::SetDeviceSampleRate(int rate) {
+    mDeviceSampleRate = rate;
+    mResampler.Reset();
+    mLatencyController.Reset();
+}
+
+void AudioPlayer::QueueSamples(const uint8_t* buf, size_t len) {
+    const double ratio = mLatencyController.Update((double)mDeviceSampleRate / GetSampleRate(), RingBuffered(),
+                                                   GetDesiredBuffered());
+
+    mResampled.clear();
+    mResampler.Process((const int16_t*)buf, len / AUDIO_FRAME_SIZE, ratio, mResampled);
+
+    const size_t size = mResampled.size() * sizeof(int16_t);
+    if (mRingBuffer.Write((const uint8_t*)mResampled.data(), size) < size) {
+        mOverruns.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AudioPlayer::PullSamples(uint8_t* buf, size_t len) {
+    size_t read = mRingBuffer.Read(buf, len);
+    if (read < len) {
+        memset(buf + read, 0, len - read);
+        mUnderruns.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+int AudioPlayer::RingBuffered(void) {
+    return (int64_t)(mRingBuffer.Size() / AUDIO_FRAME_SIZE) * GetSampleRate() / mDeviceSampleRate;
+}
+
+int AudioPlayer::DeviceBuffered(void) {
+    return 0;
+}
+
+AudioPlayerStats AudioPlayer::GetStats(void) {
+    AudioPlayerStats stats;
+    stats.Underruns = mUnderruns.load(std::memory_order_relaxed);
+    stats.Overruns = mOverruns.load(std::memory_order_relaxed);
+    stats.LatencyFrames = Buffered() + (int64_t)DeviceBuffered() * GetSampleRate() / mDeviceSampleRate;
+    return stats;
+}
+
 } // namespace Ship
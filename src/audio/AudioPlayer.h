@@ -1,16 +1,32 @@
 #pragma once
 #include "stdint.h"
 #include "stddef.h"
+#include <atomic>
+#include <vector>
+#include "AudioRingBuffer.h"
+#include "AudioResampler.h"
 
 namespace Ship {
+struct AudioPlayerStats {
+    // Times the device asked for more samples than were queued, the difference was filled with silence
+    uint64_t Underruns;
+    // Times queued samples were dropped because the ring buffer was full
+    uint64_t Overruns;
+    // Estimated time in frames between queueing a sample and hearing it
+    int32_t LatencyFrames;
+};
+
 class AudioPlayer {
 
   public:
     AudioPlayer();
+    virtual ~AudioPlayer() = default;
 
     bool Init(void);
     virtual int Buffered(void) = 0;
-    virtual int GetDesiredBuffered(void) = 0;
+    // Latency target in frames at GetSampleRate(), the game keeps about this much audio buffered
+    virtual int GetDesiredBuffered(void);
+    void SetDesiredBuffered(int frames);
     virtual void Play(const uint8_t* buf, size_t len) = 0;
 
     bool IsInitialized(void);
@@ -18,12 +34,36 @@ class AudioPlayer {
     constexpr int GetSampleRate() const {
         return 44100;
     }
+    // Rate the device actually runs at, samples are resampled from GetSampleRate() when it differs
+    int GetDeviceSampleRate() const;
+
+    // Consumer side of the ring buffer, called from the backend's audio thread. Always fills len bytes, padding with
+    // silence on underrun. Can also be called directly to drain the player into a fake sink.
+    void PullSamples(uint8_t* buf, size_t len);
+    AudioPlayerStats GetStats(void);
 
   protected:
     virtual bool DoInit(void) = 0;
+    // Producer side of the ring buffer, for backends whose device pulls samples through PullSamples. Samples are
+    // resampled to the device rate, with a small rate correction that steers the queued amount towards
+    // GetDesiredBuffered() so latency neither grows nor runs dry when the game and device clocks drift apart.
+    void QueueSamples(const uint8_t* buf, size_t len);
+    // Frames currently queued in the ring buffer, converted to GetSampleRate().
+    int RingBuffered(void);
+    void SetDeviceSampleRate(int rate);
+    // Frames buffered past the ring buffer, inside the device or the sound server.
+    virtual int DeviceBuffered(void);
 
   private:
     bool mInitialized;
+    AudioRingBuffer mRingBuffer;
+    std::atomic<uint64_t> mUnderruns;
+    std::atomic<uint64_t> mOverruns;
+    int mDesiredBuffered;
+    int mDeviceSampleRate;
+    AudioResampler mResampler;
+    AudioLatencyController mLatencyController;
+    std::vector<int16_t> mResampled;
 };
 } // namespace Ship
 
@@ -34,3 +74,4 @@ class AudioPlayer {
 #endif
 
 #include "SDLAudioPlayer.h"
+#include "NullAudioPlayer.h"
@@ -0,0 +1,95 @@
+#include "AudioResampler.h"
+#include <algorithm>
+#include <cmath>
+
+// Largest playback speed correction, 0.5% is far below what can be heard as a pitch change
+#define AUDIO_MAX_RATE_CORRECTION 0.005
+// Weight of the newest measurement in the smoothed latency error
+#define AUDIO_LATENCY_SMOOTHING 0.05
+
+namespace Ship {
+AudioResampler::AudioResampler() {
+    Reset();
+}
+
+void AudioResampler::Reset() {
+    std::fill(&mHistory[0][0], &mHistory[0][0] + 6, 0.0f);
+    mPosition = 1.0;
+}
+
+void AudioResampler::Process(const int16_t* in, size_t inFrames, double ratio, std::vector<int16_t>& out) {
+    if (inFrames == 0 || ratio <= 0.0) {
+        return;
+    }
+
+    // Planar float copy of the history followed by the new frames, so both channels run through the same loop
+    const size_t total = inFrames + 3;
+    mWork.resize(total * 2);
+    float* left = mWork.data();
+    float* right = left + total;
+    for (size_t i = 0; i < 3; i++) {
+        left[i] = mHistory[i][0];
+        right[i] = mHistory[i][1];
+    }
+    for (size_t i = 0; i < inFrames; i++) {
+        left[i + 3] = in[i * 2];
+        right[i + 3] = in[i * 2 + 1];
+    }
+
+    // Every output frame whose position falls before the last input frame that has two frames after it. Positions are
+    // computed from the frame index rather than accumulated, so the loop carries nothing from one frame to the next.
+    const double step = 1.0 / ratio;
+    const double end = (double)inFrames + 1.0;
+    size_t count = mPosition < end ? (size_t)std::ceil((end - mPosition) / step) : 0;
+    while (count > 0 && mPosition + (count - 1) * step >= end) {
+        count--;
+    }
+    while (mPosition + count * step < end) {
+        count++;
+    }
+
+    const size_t first = out.size();
+    out.resize(first + count * 2);
+    int16_t* dst = out.data() + first;
+    for (size_t n = 0; n < count; n++) {
+        const double position = mPosition + n * step;
+        const size_t i = (size_t)position;
+        const float t = (float)(position - i);
+        const float t2 = t * t;
+        const float t3 = t2 * t;
+
+        // Hermite basis weights for the points at i - 1, i, i + 1 and i + 2
+        const float w0 = -0.5f * t3 + t2 - 0.5f * t;
+        const float w1 = 1.5f * t3 - 2.5f * t2 + 1.0f;
+        const float w2 = -1.5f * t3 + 2.0f * t2 + 0.5f * t;
+        const float w3 = 0.5f * t3 - 0.5f * t2;
+
+        const float l = w0 * left[i - 1] + w1 * left[i] + w2 * left[i + 1] + w3 * left[i + 2];
+        const float r = w0 * right[i - 1] + w1 * right[i] + w2 * right[i + 1] + w3 * right[i + 2];
+        dst[n * 2] = (int16_t)std::clamp(std::lrint(l), -32768L, 32767L);
+        dst[n * 2 + 1] = (int16_t)std::clamp(std::lrint(r), -32768L, 32767L);
+    }
+
+    mPosition = mPosition + count * step - inFrames;
+    for (size_t i = 0; i < 3; i++) {
+        mHistory[i][0] = left[inFrames + i];
+        mHistory[i][1] = right[inFrames + i];
+    }
+}
+
+AudioLatencyController::AudioLatencyController() {
+    Reset();
+}
+
+void AudioLatencyController::Reset() {
+    mError = 0.0;
+}
+
+double AudioLatencyController::Update(double ratio, int queued, int desired) {
+    const double error = std::clamp((queued - (double)desired) / desired, -1.0, 1.0);
+    mError += (error - mError) * AUDIO_LATENCY_SMOOTHING;
+
+    // Play slightly faster while too much is queued and slightly slower while too little is
+    return ratio * (1.0 - mError * AUDIO_MAX_RATE_CORRECTION);
+}
+} // namespace Ship
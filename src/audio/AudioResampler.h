@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include "stdint.h"
+#include "stddef.h"
+
+namespace Ship {
+// Streaming stereo int16 resampler using 4 point cubic Hermite interpolation. The ratio can change between calls, which
+// is what the latency controller uses to nudge the playback speed.
+class AudioResampler {
+  public:
+    AudioResampler();
+
+    // Appends the resampled frames to out. Ratio is output frames per input frame.
+    void Process(const int16_t* in, size_t inFrames, double ratio, std::vector<int16_t>& out);
+    void Reset();
+
+  private:
+    // The last three input frames of the previous call, interpolation needs one frame before and two after a position
+    float mHistory[3][2];
+    // Position of the next output frame, in input frames relative to mHistory[0]
+    double mPosition;
+    std::vector<float> mWork;
+};
+
+// Dynamic rate control: corrects the resampling ratio by a small amount that steers the queued amount towards a target,
+// so latency neither grows nor runs dry when the producer and device clocks drift apart.
+class AudioLatencyController {
+  public:
+    AudioLatencyController();
+
+    // Returns the ratio to resample the next block with. Queued and desired are in the same unit.
+    double Update(double ratio, int queued, int desired);
+    void Reset();
+
+  private:
+    // Smoothed difference between the queued and desired amount, relative to the desired amount
+    double mError;
+};
+} // namespace Ship
@@ -0,0 +1,57 @@
+#include "AudioRingBuffer.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Ship {
+AudioRingBuffer::AudioRingBuffer(size_t capacity) : mReadPos(0), mWritePos(0) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    mData = std::make_unique<uint8_t[]>(size);
+    mMask = size - 1;
+}
+
+size_t AudioRingBuffer::Write(const uint8_t* buf, size_t len) {
+    const size_t writePos = mWritePos.load(std::memory_order_relaxed);
+    const size_t readPos = mReadPos.load(std::memory_order_acquire);
+
+    len = std::min(len, Capacity() - (writePos - readPos));
+    const size_t offset = writePos & mMask;
+    const size_t first = std::min(len, Capacity() - offset);
+    memcpy(&mData[offset], buf, first);
+    memcpy(&mData[0], buf + first, len - first);
+
+    mWritePos.store(writePos + len, std::memory_order_release);
+    return len;
+}
+
+size_t AudioRingBuffer::Read(uint8_t* buf, size_t len) {
+    const size_t readPos = mReadPos.load(std::memory_order_relaxed);
+    const size_t writePos = mWritePos.load(std::memory_order_acquire);
+
+    len = std::min(len, writePos - readPos);
+    const size_t offset = readPos & mMask;
+    const size_t first = std::min(len, Capacity() - offset);
+    memcpy(buf, &mData[offset], first);
+    memcpy(buf + first, &mData[0], len - first);
+
+    mReadPos.store(readPos + len, std::memory_order_release);
+    return len;
+}
+
+size_t AudioRingBuffer::Size() const {
+    return mWritePos.load(std::memory_order_acquire) - mReadPos.load(std::memory_order_acquire);
+}
+
+size_t AudioRingBuffer::Capacity() const {
+    return mMask + 1;
+}
+
+void AudioRingBuffer::Clear() {
+    // Only safe while neither side is running.
+    mReadPos.store(0, std::memory_order_relaxed);
+    mWritePos.store(0, std::memory_order_relaxed);
+}
+} // namespace Ship
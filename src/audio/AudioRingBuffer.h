@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include "stdint.h"
+#include "stddef.h"
+
+namespace Ship {
+// Lock-free ring buffer for exactly one producer thread and one consumer thread. The capacity is rounded up to a power
+// of two so the read and write positions can run freely and wrap with a mask.
+class AudioRingBuffer {
+  public:
+    explicit AudioRingBuffer(size_t capacity);
+
+    // Producer side. Returns how many bytes were written, which is less than len when the buffer is full.
+    size_t Write(const uint8_t* buf, size_t len);
+    // Consumer side. Returns how many bytes were read, which is less than len when the buffer runs empty.
+    size_t Read(uint8_t* buf, size_t len);
+
+    // Bytes that can currently be read. Exact on the consumer thread, a lower bound on the producer thread.
+    size_t Size() const;
+    size_t Capacity() const;
+    void Clear();
+
+  private:
+    std::unique_ptr<uint8_t[]> mData;
+    size_t mMask;
+    // Kept on separate cache lines so the two threads don't invalidate each other's writes.
+    alignas(64) std::atomic<size_t> mReadPos;
+    alignas(64) std::atomic<size_t> mWritePos;
+};
+} // namespace Ship
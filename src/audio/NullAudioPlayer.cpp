@@ -0,0 +1,148 @@
+#include "NullAudioPlayer.h"
+#include <algorithm>
+#include <cstring>
+#include <spdlog/spdlog.h>
+#include "debug/TraceEvents.h"
+
+// 4 is sizeof(int16_t) * num_channels (2 for stereo)
+#define NULL_AUDIO_FRAME_SIZE 4
+#define WAV_HEADER_SIZE 44
+// About 95 seconds of audio. Past it the oldest quarter is dropped at once, so a full capture isn't shifted every frame.
+#define NULL_AUDIO_CAPTURE_LIMIT (16 * 1024 * 1024)
+
+namespace Ship {
+static void WriteLE16(uint8_t* dst, uint16_t value) {
+    dst[0] = value & 0xFF;
+    dst[1] = value >> 8;
+}
+
+static void WriteLE32(uint8_t* dst, uint32_t value) {
+    dst[0] = value & 0xFF;
+    dst[1] = (value >> 8) & 0xFF;
+    dst[2] = (value >> 16) & 0xFF;
+    dst[3] = value >> 24;
+}
+
+static void BuildWavHeader(uint8_t* header, uint32_t sampleRate, uint32_t dataSize) {
+    memcpy(header + 0, "RIFF", 4);
+    WriteLE32(header + 4, WAV_HEADER_SIZE - 8 + dataSize);
+    memcpy(header + 8, "WAVE", 4);
+    memcpy(header + 12, "fmt ", 4);
+    WriteLE32(header + 16, 16);
+    WriteLE16(header + 20, 1); // PCM
+    WriteLE16(header + 22, 2); // Stereo
+    WriteLE32(header + 24, sampleRate);
+    WriteLE32(header + 28, sampleRate * NULL_AUDIO_FRAME_SIZE);
+    WriteLE16(header + 32, NULL_AUDIO_FRAME_SIZE);
+    WriteLE16(header + 34, 16);
+    memcpy(header + 36, "data", 4);
+    WriteLE32(header + 40, dataSize);
+}
+
+NullAudioPlayer::NullAudioPlayer(std::string wavPath, bool manualClock)
+    : mWavPath(std::move(wavPath)), mWavFile(nullptr), mWavDataSize(0), mManualClock(manualClock),
+      mCaptureEnabled(false), mQueuedFrames(0), mConsumedFrames(0) {
+}
+
+NullAudioPlayer::~NullAudioPlayer() {
+    FinishWav();
+}
+
+bool NullAudioPlayer::DoInit(void) {
+    if (!mWavPath.empty()) {
+        mWavFile = fopen(mWavPath.c_str(), "wb");
+        if (mWavFile == nullptr) {
+            SPDLOG_ERROR("Could not open {} for audio output", mWavPath);
+            return false;
+        }
+
+        // Sizes are filled in when the file is finished
+        uint8_t header[WAV_HEADER_SIZE];
+        BuildWavHeader(header, GetSampleRate(), 0);
+        fwrite(header, 1, sizeof(header), mWavFile);
+    }
+
+    mClockStart = std::chrono::steady_clock::now();
+    return true;
+}
+
+void NullAudioPlayer::FinishWav(void) {
+    if (mWavFile == nullptr) {
+        return;
+    }
+
+    uint8_t header[WAV_HEADER_SIZE];
+    BuildWavHeader(header, GetSampleRate(), mWavDataSize);
+    fseek(mWavFile, 0, SEEK_SET);
+    fwrite(header, 1, sizeof(header), mWavFile);
+    fclose(mWavFile);
+    mWavFile = nullptr;
+}
+
+void NullAudioPlayer::UpdateClock(void) {
+    if (!mManualClock) {
+        auto elapsed = std::chrono::steady_clock::now() - mClockStart;
+        mConsumedFrames =
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() * GetSampleRate() / 1000000;
+    }
+
+    if (mConsumedFrames > mQueuedFrames) {
+        // The virtual device ran dry. Restart the clock from here so the gap isn't made up by queueing extra frames.
+        if (!mManualClock) {
+            mClockStart = std::chrono::steady_clock::now() -
+                          std::chrono::microseconds(mQueuedFrames * 1000000 / GetSampleRate());
+        }
+        mConsumedFrames = mQueuedFrames;
+    }
+}
+
+int NullAudioPlayer::Buffered(void) {
+    UpdateClock();
+    return mQueuedFrames - mConsumedFrames;
+}
+
+void NullAudioPlayer::Play(const uint8_t* buf, size_t len) {
+    LUS_TRACE_SPAN("AudioPlayer::Play", "audio");
+    UpdateClock();
+
+    if (mWavFile != nullptr) {
+        fwrite(buf, 1, len, mWavFile);
+        mWavDataSize += len;
+    }
+    {
+        const std::lock_guard<std::mutex> lock(mCaptureMutex);
+        if (mCaptureEnabled) {
+            mCaptured.insert(mCaptured.end(), buf, buf + len);
+            if (mCaptured.size() > NULL_AUDIO_CAPTURE_LIMIT) {
+                size_t drop = mCaptured.size() - NULL_AUDIO_CAPTURE_LIMIT * 3 / 4;
+                drop -= drop % NULL_AUDIO_FRAME_SIZE;
+                mCaptured.erase(mCaptured.begin(), mCaptured.begin() + drop);
+            }
+        }
+    }
+
+    mQueuedFrames += len / NULL_AUDIO_FRAME_SIZE;
+}
+
+void NullAudioPlayer::AdvanceClock(uint32_t frames) {
+    mConsumedFrames += frames;
+    UpdateClock();
+}
+
+void NullAudioPlayer::SetCaptureEnabled(bool enabled) {
+    const std::lock_guard<std::mutex> lock(mCaptureMutex);
+    mCaptureEnabled = enabled;
+}
+
+size_t NullAudioPlayer::TakeCapturedSamples(uint8_t* buf, size_t len) {
+    const std::lock_guard<std::mutex> lock(mCaptureMutex);
+    len = std::min(len, mCaptured.size());
+    if (len == 0) {
+        return 0;
+    }
+
+    memcpy(buf, mCaptured.data(), len);
+    mCaptured.erase(mCaptured.begin(), mCaptured.begin() + len);
+    return len;
+}
+} // namespace Ship
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "AudioPlayer.h"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Ship {
+// Player without a device. Samples are consumed by a virtual clock at GetSampleRate() and go to a WAV file, memory, or
+// nowhere. With a manual clock nothing is consumed until AdvanceClock, which makes runs fully deterministic.
+class NullAudioPlayer : public AudioPlayer {
+  public:
+    explicit NullAudioPlayer(std::string wavPath = "", bool manualClock = false);
+    ~NullAudioPlayer();
+
+    int Buffered(void) override;
+    void Play(const uint8_t* buf, size_t len) override;
+
+    void AdvanceClock(uint32_t frames);
+    // Capture keeps about the latest 95 seconds. Taking samples copies out up to len of the oldest captured bytes and
+    // removes them, it is safe while another thread plays.
+    void SetCaptureEnabled(bool enabled);
+    size_t TakeCapturedSamples(uint8_t* buf, size_t len);
+
+  protected:
+    bool DoInit(void) override;
+
+  private:
+    void UpdateClock(void);
+    void FinishWav(void);
+
+    std::string mWavPath;
+    FILE* mWavFile;
+    uint32_t mWavDataSize;
+    bool mManualClock;
+    std::mutex mCaptureMutex;
+    bool mCaptureEnabled;
+    std::vector<uint8_t> mCaptured;
+    std::chrono::steady_clock::time_point mClockStart;
+    uint64_t mQueuedFrames;
+    uint64_t mConsumedFrames;
+};
+} // namespace Ship
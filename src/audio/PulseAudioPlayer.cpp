@@ -2,78 +2,72 @@
 
 #include "PulseAudioPlayer.h"
 #include <spdlog/spdlog.h>
+#include "debug/TraceEvents.h"
 
 namespace Ship {
 static void PasContextStateCb(pa_context* c, void* userData) {
-    switch (pa_context_get_state(c)) {
-        case PA_CONTEXT_READY:
-        case PA_CONTEXT_TERMINATED:
-        case PA_CONTEXT_FAILED:
-            *(bool*)userData = true;
-            break;
-        default:
-            break;
-    }
+    pa_threaded_mainloop_signal((pa_threaded_mainloop*)userData, 0);
 }
 
 static void PasStreamStateCb(pa_stream* s, void* userData) {
-    switch (pa_stream_get_state(s)) {
-        case PA_STREAM_READY:
-        case PA_STREAM_FAILED:
-        case PA_STREAM_TERMINATED:
-            *(bool*)userData = true;
-            break;
-        default:
-            break;
-    }
+    pa_threaded_mainloop_signal((pa_threaded_mainloop*)userData, 0);
 }
 
 static void PasStreamWriteCb(pa_stream* s, size_t length, void* userData) {
-}
+    void* data = nullptr;
+    size_t size = length;
+    if (pa_stream_begin_write(s, &data, &size) < 0 || data == nullptr) {
+        SPDLOG_ERROR("pa_stream_begin_write failed");
+        return;
+    }
 
-static void PasUpdateComplete(pa_stream* stream, int success, void* userData) {
-    *(bool*)userData = true;
+    ((PulseAudioPlayer*)userData)->PullSamples((uint8_t*)data, size);
+    pa_stream_write(s, data, size, NULL, 0LL, PA_SEEK_RELATIVE);
 }
 
-static void PasWriteComplete(void* userData) {
-    *(bool*)userData = true;
+PulseAudioPlayer::PulseAudioPlayer() {
 }
 
-PulseAudioPlayer::PulseAudioPlayer() {
+PulseAudioPlayer::~PulseAudioPlayer() {
+    Shutdown();
 }
 
 bool PulseAudioPlayer::DoInit() {
-    bool done = false;
     const pa_buffer_attr* appliedAttr = nullptr;
+    pa_sample_spec ss;
+    pa_buffer_attr attr;
 
     // Create mainloop
-    mMainLoop = pa_mainloop_new();
+    mMainLoop = pa_threaded_mainloop_new();
     if (mMainLoop == NULL) {
         return false;
     }
 
     // Create context and connect
-    mContext = pa_context_new(pa_mainloop_get_api(mMainLoop), "Ocarina of Time");
+    mContext = pa_context_new(pa_threaded_mainloop_get_api(mMainLoop), "Ocarina of Time");
     if (mContext == NULL) {
         goto fail;
     }
 
-    pa_context_set_state_callback(mContext, PasContextStateCb, &done);
+    pa_context_set_state_callback(mContext, PasContextStateCb, mMainLoop);
 
     if (pa_context_connect(mContext, NULL, PA_CONTEXT_NOFLAGS, NULL) < 0) {
         goto fail;
     }
 
-    while (!done) {
-        pa_mainloop_iterate(mMainLoop, true, NULL);
+    pa_threaded_mainloop_lock(mMainLoop);
+    if (pa_threaded_mainloop_start(mMainLoop) < 0) {
+        goto fail_locked;
     }
-    pa_context_set_state_callback(mContext, NULL, NULL);
-    if (pa_context_get_state(mContext) != PA_CONTEXT_READY) {
-        goto fail;
+
+    while (pa_context_get_state(mContext) != PA_CONTEXT_READY) {
+        if (!PA_CONTEXT_IS_GOOD(pa_context_get_state(mContext))) {
+            goto fail_locked;
+        }
+        pa_threaded_mainloop_wait(mMainLoop);
     }
 
     // Create stream
-    pa_sample_spec ss;
     ss.format = PA_SAMPLE_S16LE;
     ss.rate = this->GetSampleRate();
     ss.channels = 2;
@@ -81,7 +75,6 @@ bool PulseAudioPlayer::DoInit() {
 #define SAMPLES_HIGH 752
 #define SAMPLES_LOW 720
 
-    pa_buffer_attr attr;
     // set the max length to the desired buffered level, plus
     // 3x the high sample rate, which is what the n64 audio engine
     // can output at one time, x2 to avoid overflow in case of the
@@ -89,33 +82,31 @@ bool PulseAudioPlayer::DoInit() {
     // by 4 because each sample is 4 bytes
     attr.maxlength = (GetDesiredBuffered() + 3 * SAMPLES_HIGH * 2) * 4;
 
-    // slightly more than one double audio update
-    attr.prebuf = SAMPLES_HIGH * 3 * 1.5 * 4;
-
+    // the ring buffer holds the game's samples, the server only needs enough to cover the wake-up of the mainloop
+    // thread, like the 1024 sample device buffer of the SDL backend
+    attr.prebuf = (uint32_t)-1;
     attr.minreq = 222 * 4;
-    attr.tlength = (GetSampleRate() / 20) * 4;
+    attr.tlength = 1024 * 4;
 
     // initialize to a value that is deemed sensible by the server
     attr.fragsize = (uint32_t)-1;
 
     mStream = pa_stream_new(mContext, "zelda", &ss, NULL);
     if (mStream == NULL) {
-        goto fail;
+        goto fail_locked;
     }
 
-    done = false;
-    pa_stream_set_state_callback(mStream, PasStreamStateCb, &done);
-    pa_stream_set_write_callback(mStream, PasStreamWriteCb, NULL);
+    pa_stream_set_state_callback(mStream, PasStreamStateCb, mMainLoop);
+    pa_stream_set_write_callback(mStream, PasStreamWriteCb, this);
     if (pa_stream_connect_playback(mStream, NULL, &attr, PA_STREAM_ADJUST_LATENCY, NULL, NULL) < 0) {
-        goto fail;
+        goto fail_locked;
     }
 
-    while (!done) {
-        pa_mainloop_iterate(mMainLoop, true, NULL);
-    }
-    pa_stream_set_state_callback(mStream, NULL, NULL);
-    if (pa_stream_get_state(mStream) != PA_STREAM_READY) {
-        goto fail;
+    while (pa_stream_get_state(mStream) != PA_STREAM_READY) {
+        if (!PA_STREAM_IS_GOOD(pa_stream_get_state(mStream))) {
+            goto fail_locked;
+        }
+        pa_threaded_mainloop_wait(mMainLoop);
     }
 
     appliedAttr = pa_stream_get_buffer_attr(mStream);
@@ -123,10 +114,25 @@ bool PulseAudioPlayer::DoInit() {
                  appliedAttr->tlength, appliedAttr->prebuf, appliedAttr->minreq, appliedAttr->fragsize);
     mAttr = *appliedAttr;
 
+    pa_threaded_mainloop_unlock(mMainLoop);
     return true;
 
+fail_locked:
+    pa_threaded_mainloop_unlock(mMainLoop);
 fail:
+    Shutdown();
+
+    SPDLOG_ERROR("Failed to initialize PulseAudio stream!");
+    return false;
+}
+
+void PulseAudioPlayer::Shutdown() {
+    // Stopping the mainloop first guarantees the write callback no longer runs
+    if (mMainLoop != NULL) {
+        pa_threaded_mainloop_stop(mMainLoop);
+    }
     if (mStream != NULL) {
+        pa_stream_disconnect(mStream);
         pa_stream_unref(mStream);
         mStream = NULL;
     }
@@ -136,53 +142,22 @@ fail:
         mContext = NULL;
     }
     if (mMainLoop != NULL) {
-        pa_mainloop_free(mMainLoop);
+        pa_threaded_mainloop_free(mMainLoop);
         mMainLoop = NULL;
     }
-
-    SPDLOG_ERROR("Failed to initialize PulseAudio stream!");
-    return false;
 }
 
 int PulseAudioPlayer::Buffered() {
-    if (mStream == NULL) {
-        return 0;
-    }
-
-    bool done = false;
-    pa_stream_update_timing_info(mStream, PasUpdateComplete, &done);
-    while (!done) {
-        pa_mainloop_iterate(mMainLoop, true, NULL);
-    }
-
-    const pa_timing_info* info = pa_stream_get_timing_info(mStream);
-    if (info == NULL) {
-        SPDLOG_ERROR("pa_stream_get_timing_info failed, state is %d\n", pa_stream_get_state(mStream));
-    }
-    return (info->write_index - info->read_index) / 4;
+    return RingBuffered();
 }
 
-int PulseAudioPlayer::GetDesiredBuffered() {
-    return 2480;
+int PulseAudioPlayer::DeviceBuffered() {
+    return mAttr.tlength / 4;
 }
 
 void PulseAudioPlayer::Play(const uint8_t* buff, size_t len) {
-    if (mStream == NULL || mContext == NULL || mMainLoop == NULL) {
-        return;
-    }
-
-    size_t ws = mAttr.maxlength - Buffered() * 4;
-    if (ws < len) {
-        len = ws;
-    }
-    if (pa_stream_write_ext_free(mStream, buff, len, PasWriteComplete, &mWriteComplete, 0LL, PA_SEEK_RELATIVE) < 0) {
-        SPDLOG_ERROR("pa_stream_write failed");
-        return;
-    }
-    while (!mWriteComplete) {
-        pa_mainloop_iterate(mMainLoop, true, NULL);
-    }
-    mWriteComplete = false;
+    LUS_TRACE_SPAN("AudioPlayer::Play", "audio");
+    QueueSamples(buff, len);
 }
 } // namespace Ship
 
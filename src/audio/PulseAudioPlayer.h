@@ -9,18 +9,21 @@ namespace Ship {
 class PulseAudioPlayer : public AudioPlayer {
   public:
     PulseAudioPlayer();
+    ~PulseAudioPlayer();
     int Buffered() override;
-    int GetDesiredBuffered() override;
     void Play(const uint8_t* buff, size_t len) override;
 
   protected:
     bool DoInit() override;
+    int DeviceBuffered() override;
 
   private:
+    void Shutdown();
+
     pa_context* mContext = nullptr;
     pa_stream* mStream = nullptr;
-    pa_mainloop* mMainLoop = nullptr;
-    bool mWriteComplete = false;
+    // Runs its own thread, which pulls samples from the ring buffer whenever the stream wants more data
+    pa_threaded_mainloop* mMainLoop = nullptr;
     pa_buffer_attr mAttr = { 0 };
 };
 } // namespace Ship
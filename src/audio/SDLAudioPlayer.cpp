@@ -1,8 +1,20 @@
 #include "SDLAudioPlayer.h"
 #include <spdlog/spdlog.h>
+#include "debug/TraceEvents.h"
 
 namespace Ship {
-SDLAudioPlayer::SDLAudioPlayer() {
+static void SdlAudioCallback(void* userData, Uint8* stream, int len) {
+    ((SDLAudioPlayer*)userData)->PullSamples(stream, len);
+}
+
+SDLAudioPlayer::SDLAudioPlayer() : mDevice(0), mDeviceSamples(0) {
+}
+
+SDLAudioPlayer::~SDLAudioPlayer() {
+    // Stops the callback thread before the ring buffer goes away
+    if (mDevice != 0) {
+        SDL_CloseAudioDevice(mDevice);
+    }
 }
 
 bool SDLAudioPlayer::DoInit(void) {
@@ -16,29 +28,30 @@ bool SDLAudioPlayer::DoInit(void) {
     want.format = AUDIO_S16SYS;
     want.channels = 2;
     want.samples = 1024;
-    want.callback = NULL;
-    mDevice = SDL_OpenAudioDevice(NULL, 0, &want, &have, 0);
+    want.callback = SdlAudioCallback;
+    want.userdata = this;
+    // Let the device keep its native rate, the player resamples to it
+    mDevice = SDL_OpenAudioDevice(NULL, 0, &want, &have, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE);
     if (mDevice == 0) {
         SPDLOG_ERROR("SDL_OpenAudio error: {}", SDL_GetError());
         return false;
     }
+    mDeviceSamples = have.samples;
+    SetDeviceSampleRate(have.freq);
     SDL_PauseAudioDevice(mDevice, 0);
     return true;
 }
 
 int SDLAudioPlayer::Buffered(void) {
-    // 4 is sizeof(int16_t) * num_channels (2 for stereo)
-    return SDL_GetQueuedAudioSize(mDevice) / 4;
+    return RingBuffered();
 }
 
-int SDLAudioPlayer::GetDesiredBuffered(void) {
-    return 2480;
+int SDLAudioPlayer::DeviceBuffered(void) {
+    return mDeviceSamples;
 }
 
 void SDLAudioPlayer::Play(const uint8_t* buf, size_t len) {
-    if (Buffered() < 6000) {
-        // Don't fill the audio buffer too much in case this happens
-        SDL_QueueAudio(mDevice, buf, len);
-    }
+    LUS_TRACE_SPAN("AudioPlayer::Play", "audio");
+    QueueSamples(buf, len);
 }
 } // namespace Ship
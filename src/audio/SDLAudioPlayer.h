@@ -6,15 +6,17 @@ namespace Ship {
 class SDLAudioPlayer : public AudioPlayer {
   public:
     SDLAudioPlayer();
+    ~SDLAudioPlayer();
 
     int Buffered(void);
-    int GetDesiredBuffered(void);
     void Play(const uint8_t* buf, size_t len);
 
   protected:
     bool DoInit(void);
+    int DeviceBuffered(void) override;
 
   private:
     SDL_AudioDeviceID mDevice;
+    int mDeviceSamples;
 };
 } // namespace Ship
@@ -1,6 +1,7 @@
 #ifdef _WIN32
 #include "WasapiAudioPlayer.h"
 #include <spdlog/spdlog.h>
+#include "debug/TraceEvents.h"
 
 // These constants are currently missing from the MinGW headers.
 #ifndef AUDCLNT_STREAMFLAGS_AUTOCONVERTPCM
@@ -76,11 +77,8 @@ int WasapiAudioPlayer::Buffered(void) {
     } catch (HRESULT res) { return 0; }
 }
 
-int WasapiAudioPlayer::GetDesiredBuffered(void) {
-    return 2480;
-}
-
 void WasapiAudioPlayer::Play(const uint8_t* buf, size_t len) {
+    LUS_TRACE_SPAN("AudioPlayer::Play", "audio");
     if (!mInitialized) {
         if (!SetupStream()) {
             return;
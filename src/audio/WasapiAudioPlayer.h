@@ -15,7 +15,6 @@ class WasapiAudioPlayer : public AudioPlayer, public IMMNotificationClient {
     WasapiAudioPlayer();
 
     int Buffered(void);
-    int GetDesiredBuffered(void);
     void Play(const uint8_t* buf, size_t len);
 
   protected:
@@ -43,6 +43,10 @@ void Ship::BinaryReader::Read(char* buffer, int32_t length) {
     mStream->Read(buffer, length);
 }
 
+char* Ship::BinaryReader::ReadView(size_t length, std::shared_ptr<void>& owner) {
+    return mStream->ReadView(length, owner);
+}
+
 char Ship::BinaryReader::ReadChar() {
     return (char)mStream->ReadByte();
 }
@@ -30,6 +30,8 @@ class BinaryReader {
 
     void Read(int32_t length);
     void Read(char* buffer, int32_t length);
+    // See Stream::ReadView
+    char* ReadView(size_t length, std::shared_ptr<void>& owner);
     char ReadChar();
     int8_t ReadInt8();
     int16_t ReadInt16();
@@ -18,11 +18,30 @@ Ship::MemoryStream::MemoryStream(char* nBuffer, size_t nBufferSize) : MemoryStre
     mBaseAddress = 0;
 }
 
+Ship::MemoryStream::MemoryStream(char* nView, size_t nViewSize, std::shared_ptr<void> owner) : MemoryStream() {
+    mView = nView;
+    mViewOwner = owner;
+    mBufferSize = nViewSize;
+    mBaseAddress = 0;
+}
+
 Ship::MemoryStream::~MemoryStream() {
 }
 
+char* Ship::MemoryStream::GetData() {
+    return mView != nullptr ? mView : mBuffer.data();
+}
+
+void Ship::MemoryStream::DetachView() {
+    if (mView != nullptr) {
+        mBuffer = std::vector<char>(mView, mView + mBufferSize);
+        mView = nullptr;
+        mViewOwner = nullptr;
+    }
+}
+
 uint64_t Ship::MemoryStream::GetLength() {
-    return mBuffer.size();
+    return mView != nullptr ? mBufferSize : mBuffer.size();
 }
 
 void Ship::MemoryStream::Seek(int32_t offset, SeekOffsetType seekType) {
@@ -38,22 +57,34 @@ void Ship::MemoryStream::Seek(int32_t offset, SeekOffsetType seekType) {
 std::unique_ptr<char[]> Ship::MemoryStream::Read(size_t length) {
     std::unique_ptr<char[]> result = std::make_unique<char[]>(length);
 
-    memcpy_s(result.get(), length, &mBuffer[mBaseAddress], length);
+    memcpy_s(result.get(), length, GetData() + mBaseAddress, length);
     mBaseAddress += length;
 
     return result;
 }
 
 void Ship::MemoryStream::Read(const char* dest, size_t length) {
-    memcpy_s((void*)dest, length, &mBuffer[mBaseAddress], length);
+    memcpy_s((void*)dest, length, GetData() + mBaseAddress, length);
     mBaseAddress += length;
 }
 
 int8_t Ship::MemoryStream::ReadByte() {
-    return mBuffer[mBaseAddress++];
+    return GetData()[mBaseAddress++];
+}
+
+char* Ship::MemoryStream::ReadView(size_t length, std::shared_ptr<void>& owner) {
+    if (mView == nullptr || mBaseAddress + length > mBufferSize) {
+        return nullptr;
+    }
+
+    char* view = mView + mBaseAddress;
+    mBaseAddress += length;
+    owner = mViewOwner;
+    return view;
 }
 
 void Ship::MemoryStream::Write(char* srcBuffer, size_t length) {
+    DetachView();
     if (mBaseAddress + length >= mBuffer.size()) {
         mBuffer.resize(mBaseAddress + length);
         mBufferSize += length;
@@ -64,6 +95,7 @@ void Ship::MemoryStream::Write(char* srcBuffer, size_t length) {
 }
 
 void Ship::MemoryStream::WriteByte(int8_t value) {
+    DetachView();
     if (mBaseAddress >= mBuffer.size()) {
         mBuffer.resize(mBaseAddress + 1);
         mBufferSize = mBaseAddress;
@@ -73,6 +105,10 @@ void Ship::MemoryStream::WriteByte(int8_t value) {
 }
 
 std::vector<char> Ship::MemoryStream::ToVector() {
+    if (mView != nullptr) {
+        return std::vector<char>(mView, mView + mBufferSize);
+    }
+
     return mBuffer;
 }
 
@@ -9,6 +9,8 @@ class MemoryStream : public Stream {
   public:
     MemoryStream();
     MemoryStream(char* nBuffer, size_t nBufferSize);
+    // Reads the memory in place instead of copying it, owner keeps it alive. Writing copies it first.
+    MemoryStream(char* nView, size_t nViewSize, std::shared_ptr<void> owner);
     ~MemoryStream();
 
     uint64_t GetLength() override;
@@ -18,6 +20,7 @@ class MemoryStream : public Stream {
     std::unique_ptr<char[]> Read(size_t length) override;
     void Read(const char* dest, size_t length) override;
     int8_t ReadByte() override;
+    char* ReadView(size_t length, std::shared_ptr<void>& owner) override;
 
     void Write(char* srcBuffer, size_t length) override;
     void WriteByte(int8_t value) override;
@@ -28,7 +31,12 @@ class MemoryStream : public Stream {
     void Close() override;
 
   protected:
+    char* GetData();
+    void DetachView();
+
     std::vector<char> mBuffer;
     std::size_t mBufferSize;
+    char* mView = nullptr;
+    std::shared_ptr<void> mViewOwner;
 };
 } // namespace Ship
@@ -3,3 +3,7 @@
 uint64_t Ship::Stream::GetBaseAddress() {
     return mBaseAddress;
 }
+
+char* Ship::Stream::ReadView(size_t length, std::shared_ptr<void>& owner) {
+    return nullptr;
+}
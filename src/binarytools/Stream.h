@@ -18,6 +18,9 @@ class Stream {
     virtual std::unique_ptr<char[]> Read(size_t length) = 0;
     virtual void Read(const char* dest, size_t length) = 0;
     virtual int8_t ReadByte() = 0;
+    // Streams over memory that can outlive them return the next length bytes in place and skip past them, owner is then
+    // set to what keeps that memory alive. Everything else returns nullptr and the bytes have to be Read.
+    virtual char* ReadView(size_t length, std::shared_ptr<void>& owner);
 
     virtual void Write(char* destBuffer, size_t length) = 0;
     virtual void WriteByte(int8_t value) = 0;
@@ -6,6 +6,8 @@
 #include <Utils/StringHelper.h>
 #include "core/bridge/consolevariablebridge.h"
 #include <imgui.h>
+#include <chrono>
+#include "misc/Hooks.h"
 
 #ifndef __WIIU__
 #include "controller/KeyboardController.h"
@@ -17,12 +19,29 @@
 
 namespace Ship {
 
+ControlDeck::~ControlDeck() {
+    StopPolling();
+    if (mControllerReadHookId != 0) {
+        UnregisterHook<ControllerRead>(mControllerReadHookId);
+    }
+}
+
 void ControlDeck::Init(uint8_t* bits) {
     ScanPhysicalDevices();
     mControllerBits = bits;
+
+    // Runs once per osContGetReadData, after the pads were written. That makes it the frame boundary for recording
+    // and replay.
+    if (mControllerReadHookId == 0) {
+        mControllerReadHookId = RegisterHook<ControllerRead>([this](OSContPad* pad) {
+            mInputRecorder->RecordFrame(pad);
+            mReplayController->AdvanceFrame();
+        });
+    }
 }
 
 void ControlDeck::ScanPhysicalDevices() {
+    const std::lock_guard<std::recursive_mutex> lock(mDevicesMutex);
 
     mVirtualDevices.clear();
     mPhysicalDevices.clear();
@@ -52,6 +71,7 @@ void ControlDeck::ScanPhysicalDevices() {
     }
 #endif
 
+    mPhysicalDevices.push_back(mReplayController);
     mPhysicalDevices.push_back(std::make_shared<DummyController>("Disconnected", "None", false));
 
     for (const auto& device : mPhysicalDevices) {
@@ -68,18 +88,66 @@ void ControlDeck::ScanPhysicalDevices() {
 }
 
 void ControlDeck::SetPhysicalDevice(int32_t slot, int32_t deviceSlot) {
+    const std::lock_guard<std::recursive_mutex> lock(mDevicesMutex);
     const std::shared_ptr<Controller> backend = mPhysicalDevices[deviceSlot];
     mVirtualDevices[slot] = deviceSlot;
     *mControllerBits |= (backend->Connected()) << slot;
 }
 
-void ControlDeck::WriteToPad(OSContPad* pad) const {
+// Combines the input of one more device into a pad, the same way Controller::Read does
+static void MergePad(OSContPad* pad, const OSContPad& from) {
+    pad->button |= from.button;
+    if (pad->stick_x == 0) {
+        pad->stick_x = from.stick_x;
+    }
+    if (pad->stick_y == 0) {
+        pad->stick_y = from.stick_y;
+    }
+    if (pad->gyro_x == 0) {
+        pad->gyro_x = from.gyro_x;
+    }
+    if (pad->gyro_y == 0) {
+        pad->gyro_y = from.gyro_y;
+    }
+    if (pad->right_stick_x == 0) {
+        pad->right_stick_x = from.right_stick_x;
+    }
+    if (pad->right_stick_y == 0) {
+        pad->right_stick_y = from.right_stick_y;
+    }
+}
+
+void ControlDeck::WriteToPad(OSContPad* pad) {
+    const bool wantPolling = CVarGetInteger("gInputPollingRate", 0) > 0;
+    if (wantPolling != mPolling) {
+        wantPolling ? StartPolling() : StopPolling();
+    }
+
+    if (mPolling) {
+        // Blocking depends on ImGui state, which is only safe to look at from this thread
+        mBlockKeyboardInput = ShouldBlockGameInput("Keyboard");
+        mBlockControllerInput = ShouldBlockGameInput("");
+        UpdateConnections();
+        WriteSnapshotToPad(pad);
+        return;
+    }
+
+    mInputTimestamp =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+
     for (size_t i = 0; i < mVirtualDevices.size(); i++) {
         const std::shared_ptr<Controller> backend = mPhysicalDevices[mVirtualDevices[i]];
 
         // If the controller backend is "Auto" we need to get the real device
         // we search for the real device to read input from it
         if (backend->GetGuid() == "Auto") {
+            // A replay stands in for every live device, mixing them in would make it play out differently
+            if (mReplayController->IsPlaying()) {
+                mReplayController->Read(&pad[i], i);
+                continue;
+            }
+
             for (const auto& device : mPhysicalDevices) {
                 if (ShouldBlockGameInput(device->GetGuid())) {
                     device->Read(nullptr, i);
@@ -100,10 +168,157 @@ void ControlDeck::WriteToPad(OSContPad* pad) const {
     }
 }
 
+void ControlDeck::UpdateConnections() {
+#ifndef __WIIU__
+    SDL_PumpEvents();
+#endif
+
+    // Devices may close here, the lock keeps the polling thread from sampling them meanwhile
+    const std::lock_guard<std::recursive_mutex> lock(mDevicesMutex);
+    for (const auto& device : mPhysicalDevices) {
+        device->UpdateConnection();
+    }
+}
+
+void ControlDeck::RefreshDevice(int32_t slot) {
+    const std::lock_guard<std::recursive_mutex> lock(mDevicesMutex);
+    const std::shared_ptr<Controller> backend = mPhysicalDevices[mVirtualDevices[slot]];
+    if (mPolling) {
+        backend->UpdateConnection();
+    } else {
+        backend->Read(nullptr, slot);
+    }
+}
+
+int32_t ControlDeck::ReadRawPress(std::shared_ptr<Controller> device) {
+    const std::lock_guard<std::recursive_mutex> lock(mDevicesMutex);
+    return device->ReadRawPress();
+}
+
+DeviceProfile ControlDeck::GetProfile(int32_t slot) {
+    const std::lock_guard<std::recursive_mutex> lock(mDevicesMutex);
+    return *mPhysicalDevices[mVirtualDevices[slot]]->getProfile(slot);
+}
+
+void ControlDeck::EditProfile(int32_t slot, const std::function<void(DeviceProfile&)>& edit) {
+    const std::lock_guard<std::recursive_mutex> lock(mDevicesMutex);
+    edit(*mPhysicalDevices[mVirtualDevices[slot]]->getProfile(slot));
+}
+
+void ControlDeck::SetButtonMapping(int32_t slot, int32_t n64Button, int32_t scancode) {
+    const std::lock_guard<std::recursive_mutex> lock(mDevicesMutex);
+    mPhysicalDevices[mVirtualDevices[slot]]->SetButtonMapping(slot, n64Button, scancode);
+}
+
+void ControlDeck::WriteSnapshotToPad(OSContPad* pad) {
+    mSnapshotHistory.push_front(mSnapshots.Read());
+
+    const auto& snapshot =
+        mSnapshotHistory[std::min(mSnapshotHistory.size() - 1, (size_t)CVarGetInteger("gSimulatedInputLag", 0))];
+    for (size_t i = 0; i < MAXCONTROLLERS; i++) {
+        MergePad(&pad[i], snapshot.Pads[i]);
+    }
+    mInputTimestamp = snapshot.Timestamp;
+
+    while (mSnapshotHistory.size() > 6) {
+        mSnapshotHistory.pop_back();
+    }
+}
+
+void ControlDeck::SamplePads(OSContPad* pads, bool blockKeyboard, bool blockController) {
+    const std::lock_guard<std::recursive_mutex> lock(mDevicesMutex);
+
+    for (size_t i = 0; i < mVirtualDevices.size(); i++) {
+        const std::shared_ptr<Controller> backend = mPhysicalDevices[mVirtualDevices[i]];
+
+        // Blocked devices are still sampled so their state doesn't jump once they are unblocked
+        if (backend->GetGuid() == "Auto") {
+            if (mReplayController->IsPlaying()) {
+                MergePad(&pads[i], mReplayController->Sample(i));
+                continue;
+            }
+
+            for (const auto& device : mPhysicalDevices) {
+                const OSContPad sample = device->Sample(i);
+                if (!(device->GetGuid() == "Keyboard" ? blockKeyboard : blockController)) {
+                    MergePad(&pads[i], sample);
+                }
+            }
+            continue;
+        }
+
+        const OSContPad sample = backend->Sample(i);
+        if (!(backend->GetGuid() == "Keyboard" ? blockKeyboard : blockController)) {
+            MergePad(&pads[i], sample);
+        }
+    }
+}
+
+void ControlDeck::PollingThread() {
+    uint64_t sequence = 0;
+    auto next = std::chrono::steady_clock::now();
+
+    while (mPolling) {
+        InputSnapshot& snapshot = mSnapshots.Back();
+        memset(snapshot.Pads, 0, sizeof(snapshot.Pads));
+        SamplePads(snapshot.Pads, mBlockKeyboardInput, mBlockControllerInput);
+        snapshot.Timestamp =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        snapshot.Sequence = ++sequence;
+        mSnapshots.Publish();
+
+        const int32_t rate = std::max(CVarGetInteger("gInputPollingRate", 0), 1);
+        next += std::chrono::nanoseconds(1000000000 / rate);
+        const auto now = std::chrono::steady_clock::now();
+        if (next < now) {
+            // Fell behind, don't try to catch up with a burst of samples
+            next = now;
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+void ControlDeck::StartPolling() {
+    if (mPolling) {
+        return;
+    }
+
+    mSnapshotHistory.clear();
+    mBlockKeyboardInput = ShouldBlockGameInput("Keyboard");
+    mBlockControllerInput = ShouldBlockGameInput("");
+    mPolling = true;
+    mPollingThread = std::thread(&ControlDeck::PollingThread, this);
+}
+
+void ControlDeck::StopPolling() {
+    mPolling = false;
+    if (mPollingThread.joinable()) {
+        mPollingThread.join();
+    }
+}
+
+bool ControlDeck::IsPolling() const {
+    return mPolling;
+}
+
+uint64_t ControlDeck::GetInputTimestamp() const {
+    return mInputTimestamp;
+}
+
+std::shared_ptr<InputRecorder> ControlDeck::GetInputRecorder() {
+    return mInputRecorder;
+}
+
+std::shared_ptr<ReplayController> ControlDeck::GetReplayController() {
+    return mReplayController;
+}
+
 #define NESTED(key, ...) \
     StringHelper::Sprintf("Controllers.%s.Slot_%d." key, device->GetGuid().c_str(), virtualSlot, __VA_ARGS__)
 
 void ControlDeck::LoadControllerSettings() {
+    const std::lock_guard<std::recursive_mutex> lock(mDevicesMutex);
     std::shared_ptr<Mercury> config = Window::GetInstance()->GetConfig();
 
     for (auto const& val : config->rjson["Controllers"]["Deck"].items()) {
@@ -195,6 +410,8 @@ void ControlDeck::LoadControllerSettings() {
 }
 
 void ControlDeck::SaveControllerSettings() {
+    // The polling thread updates the gyro drift in the profiles
+    const std::lock_guard<std::recursive_mutex> lock(mDevicesMutex);
     std::shared_ptr<Mercury> config = Window::GetInstance()->GetConfig();
 
     for (size_t i = 0; i < mVirtualDevices.size(); i++) {
@@ -245,7 +462,7 @@ void ControlDeck::SaveControllerSettings() {
         }
     }
 
-    config->save();
+    config->saveDeferred();
 }
 
 std::shared_ptr<Controller> ControlDeck::GetPhysicalDevice(int32_t deviceSlot) {
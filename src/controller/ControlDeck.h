@@ -1,16 +1,33 @@
 #pragma once
 
 #include "Controller.h"
+#include "InputRecorder.h"
+#include "ReplayController.h"
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include <vector>
 #include <Mercury.h>
+#include "misc/TripleBuffer.h"
 
 namespace Ship {
 
+// State of every virtual slot as sampled by the input polling thread
+struct InputSnapshot {
+    OSContPad Pads[MAXCONTROLLERS];
+    // steady_clock time of the sample in nanoseconds, 0 before the first sample
+    uint64_t Timestamp;
+    uint64_t Sequence;
+};
+
 class ControlDeck {
   public:
+    ~ControlDeck();
     void Init(uint8_t* controllerBits);
     void ScanPhysicalDevices();
-    void WriteToPad(OSContPad* pad) const;
+    void WriteToPad(OSContPad* pad);
     void LoadControllerSettings();
     void SaveControllerSettings();
     void SetPhysicalDevice(int32_t slot, int32_t deviceSlot);
@@ -23,8 +40,45 @@ class ControlDeck {
     void BlockGameInput();
     void UnblockGameInput();
     bool ShouldBlockGameInput(std::string inputDeviceGuid) const;
+    // When gInputPollingRate is above 0, devices are sampled at that rate in Hz on a background thread and WriteToPad
+    // only copies out the latest sample.
+    bool IsPolling() const;
+    // Sample time of the input returned by the last WriteToPad, in steady_clock nanoseconds
+    uint64_t GetInputTimestamp() const;
+    std::shared_ptr<InputRecorder> GetInputRecorder();
+    // Always part of the physical devices, plays nothing until a recording is loaded
+    std::shared_ptr<ReplayController> GetReplayController();
+    // For the input editor, which reads devices outside of WriteToPad. Both go through the lock the polling thread
+    // samples under, and while polling the device is left to the polling thread instead of being read again.
+    void RefreshDevice(int32_t slot);
+    int32_t ReadRawPress(std::shared_ptr<Controller> device);
+    // The polling thread reads the profile of the device in a slot while sampling it. The editor draws from a copy
+    // and applies each change it makes under the same lock.
+    DeviceProfile GetProfile(int32_t slot);
+    void EditProfile(int32_t slot, const std::function<void(DeviceProfile&)>& edit);
+    void SetButtonMapping(int32_t slot, int32_t n64Button, int32_t scancode);
 
   private:
+    void StartPolling();
+    void StopPolling();
+    void PollingThread();
+    void SamplePads(OSContPad* pads, bool blockKeyboard, bool blockController);
+    void WriteSnapshotToPad(OSContPad* pad);
+    void UpdateConnections();
+
+    // Guards the device lists against the polling thread
+    mutable std::recursive_mutex mDevicesMutex;
+    std::thread mPollingThread;
+    std::atomic<bool> mPolling = false;
+    std::atomic<bool> mBlockKeyboardInput = false;
+    std::atomic<bool> mBlockControllerInput = false;
+    TripleBuffer<InputSnapshot> mSnapshots;
+    std::deque<InputSnapshot> mSnapshotHistory;
+    uint64_t mInputTimestamp = 0;
+    std::shared_ptr<InputRecorder> mInputRecorder = std::make_shared<InputRecorder>();
+    std::shared_ptr<ReplayController> mReplayController = std::make_shared<ReplayController>();
+    size_t mControllerReadHookId = 0;
+
     std::vector<int32_t> mVirtualDevices = {};
     std::vector<std::shared_ptr<Controller>> mPhysicalDevices = {};
     uint8_t* mControllerBits = nullptr;
@@ -9,9 +9,6 @@
 #endif
 #include <spdlog/spdlog.h>
 
-#define M_TAU 6.2831853071795864769252867665590057 // 2 * pi
-#define MINIMUM_RADIUS_TO_MAP_NOTCH 0.9
-
 namespace Ship {
 
 Controller::Controller() : mIsRumbling(false) {
@@ -88,65 +85,28 @@ int8_t Controller::ReadStick(int32_t virtualSlot, Stick stick, Axis axis) {
     return 0;
 }
 
-void Controller::ProcessStick(int8_t& x, int8_t& y, float deadzoneX, float deadzoneY, int32_t notchProxmityThreshold) {
-    auto ux = fabs(x);
-    auto uy = fabs(y);
-
+void Controller::ProcessStick(int32_t virtualSlot, Stick stick, int8_t& x, int8_t& y, float deadzoneX,
+                              float deadzoneY, int32_t notchProxmityThreshold) {
     // TODO: handle deadzones separately for X and Y
     if (deadzoneX != deadzoneY) {
         SPDLOG_TRACE("Invalid Deadzone configured. Up/Down was {} and Left/Right is {}", deadzoneY, deadzoneX);
     }
 
-    // create scaled circular dead-zone in range {-15 ... +15}
-    auto len = sqrt(ux * ux + uy * uy);
-    if (len < deadzoneX) {
-        len = 0;
-    } else if (len > MAX_AXIS_RANGE) {
-        len = MAX_AXIS_RANGE / len;
-    } else {
-        len = (len - deadzoneX) * MAX_AXIS_RANGE / (MAX_AXIS_RANGE - deadzoneX) / len;
-    }
-    ux *= len;
-    uy *= len;
-
-    // bound diagonals to an octagonal range {-68 ... +68}
-    if (ux != 0.0 && uy != 0.0) {
-        auto slope = uy / ux;
-        auto edgex = copysign(MAX_AXIS_RANGE / (fabs(slope) + 16.0 / 69.0), ux);
-        auto edgey = copysign(std::min(fabs(edgex * slope), MAX_AXIS_RANGE / (1.0 / fabs(slope) + 16.0 / 69.0)), y);
-        edgex = edgey / slope;
-
-        auto scale = sqrt(edgex * edgex + edgey * edgey) / MAX_AXIS_RANGE;
-        ux *= scale;
-        uy *= scale;
-    }
-
-    // map to virtual notches
-    const double notchProximityValRadians = notchProxmityThreshold * M_TAU / 360;
-
-    const double distance = std::sqrt((ux * ux) + (uy * uy)) / MAX_AXIS_RANGE;
-    if (distance >= MINIMUM_RADIUS_TO_MAP_NOTCH) {
-        auto angle = atan2(uy, ux) + M_TAU;
-        auto newAngle = GetClosestNotch(angle, notchProximityValRadians);
-
-        ux = cos(newAngle) * distance * MAX_AXIS_RANGE;
-        uy = sin(newAngle) * distance * MAX_AXIS_RANGE;
+    auto& table = mStickResponses[virtualSlot][stick];
+    if (table == nullptr || table->Deadzone != deadzoneX || table->NotchProximityThreshold != notchProxmityThreshold) {
+        table = GetStickResponseTable(deadzoneX, notchProxmityThreshold);
     }
 
-    // assign back to original sign
-    x = copysign(ux, x);
-    y = copysign(uy, y);
+    const int8_t* response = table->Response[(uint8_t)x << 8 | (uint8_t)y];
+    x = response[0];
+    y = response[1];
 }
 
-void Controller::Read(OSContPad* pad, int32_t virtualSlot) {
+OSContPad Controller::Sample(int32_t virtualSlot) {
     ReadFromSource(virtualSlot);
 
     OSContPad padToBuffer = { 0 };
 
-#ifndef __WIIU__
-    SDL_PumpEvents();
-#endif
-
     // Button Inputs
     padToBuffer.button |= getPressedButtons(virtualSlot) & 0xFFFF;
 
@@ -157,15 +117,11 @@ void Controller::Read(OSContPad* pad, int32_t virtualSlot) {
     int8_t rightStickY = ReadStick(virtualSlot, RIGHT, Y);
 
     auto profile = getProfile(virtualSlot);
-    ProcessStick(leftStickX, leftStickY, profile->AxisDeadzones[0], profile->AxisDeadzones[1],
+    ProcessStick(virtualSlot, LEFT, leftStickX, leftStickY, profile->AxisDeadzones[0], profile->AxisDeadzones[1],
                  profile->NotchProximityThreshold);
-    ProcessStick(rightStickX, rightStickY, profile->AxisDeadzones[2], profile->AxisDeadzones[3],
+    ProcessStick(virtualSlot, RIGHT, rightStickX, rightStickY, profile->AxisDeadzones[2], profile->AxisDeadzones[3],
                  profile->NotchProximityThreshold);
 
-    if (pad == nullptr) {
-        return;
-    }
-
     padToBuffer.stick_x = leftStickX;
     padToBuffer.stick_y = leftStickY;
     padToBuffer.right_stick_x = rightStickX;
@@ -175,6 +131,24 @@ void Controller::Read(OSContPad* pad, int32_t virtualSlot) {
     padToBuffer.gyro_x = getGyroX(virtualSlot);
     padToBuffer.gyro_y = getGyroY(virtualSlot);
 
+    return padToBuffer;
+}
+
+void Controller::UpdateConnection() {
+}
+
+void Controller::Read(OSContPad* pad, int32_t virtualSlot) {
+#ifndef __WIIU__
+    SDL_PumpEvents();
+#endif
+
+    UpdateConnection();
+    OSContPad padToBuffer = Sample(virtualSlot);
+
+    if (pad == nullptr) {
+        return;
+    }
+
     mPadBuffer.push_front(padToBuffer);
     if (pad != nullptr) {
         auto& padFromBuffer =
@@ -254,11 +228,4 @@ bool Controller::IsRumbling() {
 std::string Controller::GetGuid() {
     return mGuid;
 }
-
-double Controller::GetClosestNotch(double angle, double approximationThreshold) {
-    constexpr auto octagonAngle = M_TAU / 8;
-    const auto closestNotch = std::round(angle / octagonAngle) * octagonAngle;
-    const auto distanceToNotch = std::abs(fmod(closestNotch - angle + M_PI, M_TAU) - M_PI);
-    return distanceToNotch < approximationThreshold / 2 ? closestNotch : angle;
-}
 } // namespace Ship
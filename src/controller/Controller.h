@@ -7,11 +7,11 @@
 #include <queue>
 #include "libultraship/libultra/controller.h"
 #include "attachment/ControllerAttachment.h"
+#include "StickResponse.h"
 #include <unordered_map>
 
 #define EXTENDED_SCANCODE_BIT (1 << 8)
 #define AXIS_SCANCODE_BIT (1 << 9)
-#define MAX_AXIS_RANGE 85.0f
 
 namespace Ship {
 enum GyroData { DRIFT_X, DRIFT_Y, GYRO_SENSITIVITY };
@@ -48,6 +48,12 @@ class Controller {
     virtual const std::string GetButtonName(int32_t virtualSlot, int32_t n64Button) = 0;
     virtual const std::string GetControllerName() = 0;
     void Read(OSContPad* pad, int32_t virtualSlot);
+    // Reads the device and returns the processed pad state, without the simulated input lag. Safe to call from the
+    // input polling thread.
+    virtual OSContPad Sample(int32_t virtualSlot);
+    // Opens or closes the device as it is plugged in or out. SDL expects this on the main thread, so unlike Sample it
+    // never runs on the input polling thread.
+    virtual void UpdateConnection();
     void SetButtonMapping(int32_t virtualSlot, int32_t n64Button, int32_t scancode);
     std::shared_ptr<ControllerAttachment> GetAttachment();
     std::shared_ptr<DeviceProfile> getProfile(int32_t virtualSlot);
@@ -68,7 +74,8 @@ class Controller {
 
     void LoadBinding();
     int8_t ReadStick(int32_t virtualSlot, Stick stick, Axis axis);
-    void ProcessStick(int8_t& x, int8_t& y, float deadzoneX, float deadzoneY, int32_t notchProxmityThreshold);
+    void ProcessStick(int32_t virtualSlot, Stick stick, int8_t& x, int8_t& y, float deadzoneX, float deadzoneY,
+                      int32_t notchProxmityThreshold);
 
   private:
     struct Buttons {
@@ -84,7 +91,8 @@ class Controller {
     std::unordered_map<int32_t, std::shared_ptr<DeviceProfile>> mProfiles;
     std::unordered_map<int32_t, std::shared_ptr<Buttons>> mButtonData = {};
     std::deque<OSContPad> mPadBuffer;
+    // Tables in use per virtual slot and stick, replaced when the profile's deadzone or notch setting changes
+    std::shared_ptr<const StickResponseTable> mStickResponses[MAXCONTROLLERS][2];
 
-    double GetClosestNotch(double angle, double approximationThreshold);
 };
 } // namespace Ship
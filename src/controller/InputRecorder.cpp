@@ -0,0 +1,244 @@
+#include "InputRecorder.h"
+#include <cstring>
+#include <spdlog/spdlog.h>
+
+// Buffered bytes are written out once this much has been collected
+#define INPUT_RECORDER_FLUSH_SIZE 4096
+
+namespace Ship {
+InputRecorder::~InputRecorder() {
+    Stop();
+}
+
+bool InputRecorder::Start(const std::string& path) {
+    Stop();
+
+    mFile = fopen(path.c_str(), "wb");
+    if (mFile == nullptr) {
+        SPDLOG_ERROR("Could not open {} to record input", path);
+        return false;
+    }
+
+    memset(mPrevious, 0, sizeof(mPrevious));
+    mFrame = 0;
+    mLastRecordFrame = 0;
+    mBuffer.clear();
+    mBuffer.insert(mBuffer.end(), INPUT_RECORDING_MAGIC, INPUT_RECORDING_MAGIC + 4);
+    mBuffer.push_back(INPUT_RECORDING_VERSION);
+    mBuffer.push_back(MAXCONTROLLERS);
+
+    SPDLOG_INFO("Recording input to {}", path);
+    return true;
+}
+
+void InputRecorder::Stop() {
+    if (mFile == nullptr) {
+        return;
+    }
+
+    WriteVarint(mFrame - mLastRecordFrame);
+    mBuffer.push_back(0);
+    Flush();
+    fclose(mFile);
+    mFile = nullptr;
+
+    SPDLOG_INFO("Recorded {} frames of input", mFrame);
+}
+
+bool InputRecorder::IsRecording() const {
+    return mFile != nullptr;
+}
+
+uint64_t InputRecorder::GetFrameCount() const {
+    return mFrame;
+}
+
+void InputRecorder::WriteVarint(uint64_t value) {
+    while (value >= 0x80) {
+        mBuffer.push_back((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    mBuffer.push_back(value);
+}
+
+static void WriteFloat(std::vector<uint8_t>& buffer, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; i++) {
+        buffer.push_back((bits >> (i * 8)) & 0xFF);
+    }
+}
+
+void InputRecorder::RecordFrame(const OSContPad* pads) {
+    if (mFile == nullptr) {
+        return;
+    }
+
+    uint8_t fieldMasks[MAXCONTROLLERS];
+    uint8_t slotMask = 0;
+    for (int32_t i = 0; i < MAXCONTROLLERS; i++) {
+        const OSContPad& pad = pads[i];
+        const OSContPad& prev = mPrevious[i];
+        uint8_t mask = 0;
+
+        mask |= pad.button != prev.button ? INPUT_FIELD_BUTTON : 0;
+        mask |= pad.stick_x != prev.stick_x ? INPUT_FIELD_STICK_X : 0;
+        mask |= pad.stick_y != prev.stick_y ? INPUT_FIELD_STICK_Y : 0;
+        mask |= pad.right_stick_x != prev.right_stick_x ? INPUT_FIELD_RIGHT_STICK_X : 0;
+        mask |= pad.right_stick_y != prev.right_stick_y ? INPUT_FIELD_RIGHT_STICK_Y : 0;
+        // Compare gyro bit patterns so that replaying reproduces them exactly
+        mask |= memcmp(&pad.gyro_x, &prev.gyro_x, sizeof(float)) != 0 ? INPUT_FIELD_GYRO_X : 0;
+        mask |= memcmp(&pad.gyro_y, &prev.gyro_y, sizeof(float)) != 0 ? INPUT_FIELD_GYRO_Y : 0;
+        mask |= pad.err_no != prev.err_no ? INPUT_FIELD_ERR_NO : 0;
+
+        fieldMasks[i] = mask;
+        slotMask |= mask != 0 ? 1 << i : 0;
+    }
+
+    if (slotMask != 0) {
+        WriteVarint(mFrame - mLastRecordFrame);
+        mBuffer.push_back(slotMask);
+
+        for (int32_t i = 0; i < MAXCONTROLLERS; i++) {
+            const OSContPad& pad = pads[i];
+            const uint8_t mask = fieldMasks[i];
+            if (mask == 0) {
+                continue;
+            }
+
+            mBuffer.push_back(mask);
+            if (mask & INPUT_FIELD_BUTTON) {
+                mBuffer.push_back(pad.button & 0xFF);
+                mBuffer.push_back(pad.button >> 8);
+            }
+            if (mask & INPUT_FIELD_STICK_X) {
+                mBuffer.push_back((uint8_t)pad.stick_x);
+            }
+            if (mask & INPUT_FIELD_STICK_Y) {
+                mBuffer.push_back((uint8_t)pad.stick_y);
+            }
+            if (mask & INPUT_FIELD_RIGHT_STICK_X) {
+                mBuffer.push_back((uint8_t)pad.right_stick_x);
+            }
+            if (mask & INPUT_FIELD_RIGHT_STICK_Y) {
+                mBuffer.push_back((uint8_t)pad.right_stick_y);
+            }
+            if (mask & INPUT_FIELD_GYRO_X) {
+                WriteFloat(mBuffer, pad.gyro_x);
+            }
+            if (mask & INPUT_FIELD_GYRO_Y) {
+                WriteFloat(mBuffer, pad.gyro_y);
+            }
+            if (mask & INPUT_FIELD_ERR_NO) {
+                mBuffer.push_back(pad.err_no);
+            }
+
+            mPrevious[i] = pad;
+        }
+
+        mLastRecordFrame = mFrame;
+        if (mBuffer.size() >= INPUT_RECORDER_FLUSH_SIZE) {
+            Flush();
+        }
+    }
+
+    mFrame++;
+}
+
+void InputRecorder::Flush() {
+    if (!mBuffer.empty()) {
+        fwrite(mBuffer.data(), 1, mBuffer.size(), mFile);
+        mBuffer.clear();
+    }
+}
+
+bool DecodeInputRecording(const std::vector<uint8_t>& data, std::vector<InputKeyframe>& keyframes,
+                          uint64_t& frameCount, bool& truncated) {
+    if (data.size() < 6 || memcmp(data.data(), INPUT_RECORDING_MAGIC, 4) != 0 ||
+        data[4] != INPUT_RECORDING_VERSION || data[5] != MAXCONTROLLERS) {
+        return false;
+    }
+
+    size_t pos = 6;
+    bool valid = true;
+    auto readByte = [&]() -> uint8_t {
+        if (pos >= data.size()) {
+            valid = false;
+            return 0;
+        }
+        return data[pos++];
+    };
+    auto readFloat = [&]() -> float {
+        uint32_t bits = 0;
+        for (int i = 0; i < 4; i++) {
+            bits |= (uint32_t)readByte() << (i * 8);
+        }
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    };
+
+    keyframes.clear();
+    std::array<OSContPad, MAXCONTROLLERS> pads = {};
+    uint64_t frame = 0;
+    while (valid) {
+        uint64_t delta = 0;
+        for (int shift = 0; valid; shift += 7) {
+            const uint8_t byte = readByte();
+            delta |= (uint64_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                break;
+            }
+        }
+        frame += delta;
+
+        const uint8_t slotMask = readByte();
+        if (!valid || slotMask == 0) {
+            break;
+        }
+
+        for (int32_t i = 0; i < MAXCONTROLLERS; i++) {
+            if (!(slotMask & (1 << i))) {
+                continue;
+            }
+
+            OSContPad& pad = pads[i];
+            const uint8_t mask = readByte();
+            if (mask & INPUT_FIELD_BUTTON) {
+                pad.button = readByte();
+                pad.button |= readByte() << 8;
+            }
+            if (mask & INPUT_FIELD_STICK_X) {
+                pad.stick_x = (int8_t)readByte();
+            }
+            if (mask & INPUT_FIELD_STICK_Y) {
+                pad.stick_y = (int8_t)readByte();
+            }
+            if (mask & INPUT_FIELD_RIGHT_STICK_X) {
+                pad.right_stick_x = (int8_t)readByte();
+            }
+            if (mask & INPUT_FIELD_RIGHT_STICK_Y) {
+                pad.right_stick_y = (int8_t)readByte();
+            }
+            if (mask & INPUT_FIELD_GYRO_X) {
+                pad.gyro_x = readFloat();
+            }
+            if (mask & INPUT_FIELD_GYRO_Y) {
+                pad.gyro_y = readFloat();
+            }
+            if (mask & INPUT_FIELD_ERR_NO) {
+                pad.err_no = readByte();
+            }
+        }
+
+        if (!valid) {
+            break;
+        }
+        keyframes.push_back({ frame, pads });
+    }
+
+    truncated = !valid;
+    frameCount = truncated ? (keyframes.empty() ? 0 : keyframes.back().Frame + 1) : frame;
+    return true;
+}
+} // namespace Ship
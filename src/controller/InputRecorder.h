@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "libultraship/libultra/controller.h"
+
+// Recorded input streams start with the magic, a version byte and the slot count. After that there is one record for
+// every frame where a pad changed: a varint with the frames since the previous record, a byte with a bit per changed
+// slot, and for each changed slot a byte with a bit per changed field followed by the new values of those fields. A
+// record with no changed slots ends the stream, its frame delta makes the total length come out right.
+#define INPUT_RECORDING_MAGIC "LUSI"
+#define INPUT_RECORDING_VERSION 1
+
+namespace Ship {
+enum InputRecordingField {
+    INPUT_FIELD_BUTTON = 1 << 0,
+    INPUT_FIELD_STICK_X = 1 << 1,
+    INPUT_FIELD_STICK_Y = 1 << 2,
+    INPUT_FIELD_RIGHT_STICK_X = 1 << 3,
+    INPUT_FIELD_RIGHT_STICK_Y = 1 << 4,
+    INPUT_FIELD_GYRO_X = 1 << 5,
+    INPUT_FIELD_GYRO_Y = 1 << 6,
+    INPUT_FIELD_ERR_NO = 1 << 7,
+};
+
+// Full pad state of every slot at a frame where something changed
+struct InputKeyframe {
+    uint64_t Frame;
+    std::array<OSContPad, MAXCONTROLLERS> Pads;
+};
+
+// Decodes a stream written by InputRecorder. Returns false if the header isn't supported. A stream cut short is decoded
+// up to where it ends and sets truncated, its frame count then ends with the last keyframe.
+bool DecodeInputRecording(const std::vector<uint8_t>& data, std::vector<InputKeyframe>& keyframes,
+                          uint64_t& frameCount, bool& truncated);
+
+// Writes the pads the game reads, one frame per osContGetReadData, to a file.
+class InputRecorder {
+  public:
+    ~InputRecorder();
+
+    bool Start(const std::string& path);
+    void Stop();
+    bool IsRecording() const;
+    // Called from the ControllerRead hook with the MAXCONTROLLERS pads the game is about to see
+    void RecordFrame(const OSContPad* pads);
+    uint64_t GetFrameCount() const;
+
+  private:
+    void WriteVarint(uint64_t value);
+    void Flush();
+
+    FILE* mFile = nullptr;
+    std::vector<uint8_t> mBuffer;
+    OSContPad mPrevious[MAXCONTROLLERS];
+    uint64_t mFrame = 0;
+    uint64_t mLastRecordFrame = 0;
+};
+} // namespace Ship
@@ -0,0 +1,138 @@
+#include "ReplayController.h"
+#include "InputRecorder.h"
+#include <fstream>
+#include <iterator>
+#include <spdlog/spdlog.h>
+
+namespace Ship {
+ReplayController::ReplayController() : mNextKeyframe(0), mFrame(0), mFrameCount(0), mPlaying(false) {
+    mGuid = "Replay";
+    mCurrent = {};
+}
+
+bool ReplayController::Load(const std::string& path) {
+    Stop();
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        SPDLOG_ERROR("Could not open input recording {}", path);
+        return false;
+    }
+    const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    std::vector<InputKeyframe> keyframes;
+    uint64_t frameCount;
+    bool truncated;
+    if (!DecodeInputRecording(data, keyframes, frameCount, truncated)) {
+        SPDLOG_ERROR("{} is not a supported input recording", path);
+        return false;
+    }
+    if (truncated) {
+        // A recording cut short by a crash is still worth playing up to where it ends
+        SPDLOG_WARN("Input recording {} is truncated", path);
+    }
+
+    const std::lock_guard<std::mutex> lock(mMutex);
+    StopLocked();
+    mKeyframes = std::move(keyframes);
+    mFrameCount = frameCount;
+    mPlaying = true;
+    ApplyKeyframes();
+
+    SPDLOG_INFO("Replaying {} frames of input from {}", mFrameCount, path);
+    return true;
+}
+
+void ReplayController::Stop() {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    StopLocked();
+}
+
+void ReplayController::StopLocked() {
+    mKeyframes.clear();
+    mCurrent = {};
+    mNextKeyframe = 0;
+    mFrame = 0;
+    mFrameCount = 0;
+    mPlaying = false;
+}
+
+bool ReplayController::IsPlaying() const {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    return mPlaying;
+}
+
+void ReplayController::ApplyKeyframes() {
+    while (mNextKeyframe < mKeyframes.size() && mKeyframes[mNextKeyframe].Frame <= mFrame) {
+        mCurrent = mKeyframes[mNextKeyframe++].Pads;
+    }
+}
+
+void ReplayController::AdvanceFrame() {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    if (!mPlaying) {
+        return;
+    }
+
+    mFrame++;
+    if (mFrame >= mFrameCount && mNextKeyframe >= mKeyframes.size()) {
+        SPDLOG_INFO("Input replay finished after {} frames", mFrame);
+        StopLocked();
+        return;
+    }
+
+    ApplyKeyframes();
+}
+
+uint64_t ReplayController::GetFrame() const {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    return mFrame;
+}
+
+uint64_t ReplayController::GetFrameCount() const {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    return mFrameCount;
+}
+
+OSContPad ReplayController::Sample(int32_t virtualSlot) {
+    // The recording already went through stick processing, so it is returned as is
+    const std::lock_guard<std::mutex> lock(mMutex);
+    return mCurrent[virtualSlot];
+}
+
+void ReplayController::ReadFromSource(int32_t virtualSlot) {
+}
+
+void ReplayController::WriteToSource(int32_t virtualSlot, ControllerCallback* controller) {
+}
+
+bool ReplayController::Connected() const {
+    return true;
+}
+
+bool ReplayController::CanRumble() const {
+    return false;
+}
+
+bool ReplayController::CanGyro() const {
+    return false;
+}
+
+void ReplayController::CreateDefaultBinding(int32_t virtualSlot) {
+}
+
+void ReplayController::ClearRawPress() {
+}
+
+int32_t ReplayController::ReadRawPress() {
+    return -1;
+}
+
+const std::string ReplayController::GetButtonName(int32_t virtualSlot, int32_t n64Button) {
+    return "Replay";
+}
+
+const std::string ReplayController::GetControllerName() {
+    return "Input Replay";
+}
+} // namespace Ship
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Controller.h"
+#include "InputRecorder.h"
+
+namespace Ship {
+// Plays back a stream written by InputRecorder. Assign it to a slot like any other device, every slot it is assigned to
+// gets the pad recorded for that slot. Playback advances one frame per osContGetReadData, so it is only frame exact with
+// background input polling turned off.
+class ReplayController final : public Controller {
+  public:
+    ReplayController();
+
+    bool Load(const std::string& path);
+    void Stop();
+    bool IsPlaying() const;
+    void AdvanceFrame();
+    uint64_t GetFrame() const;
+    uint64_t GetFrameCount() const;
+
+    OSContPad Sample(int32_t virtualSlot) override;
+    void ReadFromSource(int32_t virtualSlot) override;
+    void WriteToSource(int32_t virtualSlot, ControllerCallback* controller) override;
+    bool Connected() const override;
+    bool CanRumble() const override;
+    bool CanGyro() const override;
+    void CreateDefaultBinding(int32_t virtualSlot) override;
+    void ClearRawPress() override;
+    int32_t ReadRawPress() override;
+    const std::string GetButtonName(int32_t virtualSlot, int32_t n64Button) override;
+    const std::string GetControllerName() override;
+
+  private:
+    void ApplyKeyframes();
+
+    void StopLocked();
+
+    // Sample runs on the input polling thread while the game thread advances frames
+    mutable std::mutex mMutex;
+    // Full pad state at every frame where something changed
+    std::vector<InputKeyframe> mKeyframes;
+    std::array<OSContPad, MAXCONTROLLERS> mCurrent;
+    size_t mNextKeyframe;
+    uint64_t mFrame;
+    uint64_t mFrameCount;
+    bool mPlaying;
+};
+} // namespace Ship
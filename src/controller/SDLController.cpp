@@ -101,9 +101,7 @@ int32_t SDLController::ReadRawPress() {
     return -1;
 }
 
-void SDLController::ReadFromSource(int32_t virtualSlot) {
-    auto profile = getProfile(virtualSlot);
-
+void SDLController::UpdateConnection() {
     SDL_GameControllerUpdate();
 
     // If the controller is disconnected, close it.
@@ -113,10 +111,16 @@ void SDLController::ReadFromSource(int32_t virtualSlot) {
 
     // Attempt to load the controller if it's not loaded
     if (mController == nullptr) {
-        // If we failed to load the controller, don't process it.
-        if (!Open()) {
-            return;
-        }
+        Open();
+    }
+}
+
+void SDLController::ReadFromSource(int32_t virtualSlot) {
+    auto profile = getProfile(virtualSlot);
+
+    // If we failed to load the controller, don't process it.
+    if (mController == nullptr) {
+        return;
     }
 
     if (mSupportsGyro && profile->UseGyro) {
@@ -7,6 +7,7 @@ class SDLController : public Controller {
   public:
     SDLController(int32_t physicalSlot);
     void ReadFromSource(int32_t virtualSlot) override;
+    void UpdateConnection() override;
     const std::string GetControllerName() override;
     const std::string GetButtonName(int32_t virtualSlot, int32_t n64Button) override;
     void WriteToSource(int32_t virtualSlot, ControllerCallback* controller) override;
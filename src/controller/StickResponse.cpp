@@ -0,0 +1,97 @@
+#include "StickResponse.h"
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#define M_TAU 6.2831853071795864769252867665590057 // 2 * pi
+#define MINIMUM_RADIUS_TO_MAP_NOTCH 0.9
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace Ship {
+static double GetClosestNotch(double angle, double approximationThreshold) {
+    constexpr auto octagonAngle = M_TAU / 8;
+    const auto closestNotch = std::round(angle / octagonAngle) * octagonAngle;
+    const auto distanceToNotch = std::abs(fmod(closestNotch - angle + M_PI, M_TAU) - M_PI);
+    return distanceToNotch < approximationThreshold / 2 ? closestNotch : angle;
+}
+
+std::shared_ptr<const StickResponseTable> GetStickResponseTable(float deadzone, int32_t notchProxmityThreshold) {
+    static std::mutex tablesMutex;
+    static std::vector<std::weak_ptr<const StickResponseTable>> tables;
+
+    const std::lock_guard<std::mutex> lock(tablesMutex);
+    std::erase_if(tables, [](const auto& table) { return table.expired(); });
+    for (const auto& weak : tables) {
+        auto table = weak.lock();
+        if (table != nullptr && table->Deadzone == deadzone &&
+            table->NotchProximityThreshold == notchProxmityThreshold) {
+            return table;
+        }
+    }
+
+    auto table = std::make_shared<StickResponseTable>();
+    table->Deadzone = deadzone;
+    table->NotchProximityThreshold = notchProxmityThreshold;
+    for (int32_t rawX = INT8_MIN; rawX <= INT8_MAX; rawX++) {
+        for (int32_t rawY = INT8_MIN; rawY <= INT8_MAX; rawY++) {
+            int8_t x = rawX;
+            int8_t y = rawY;
+            ComputeStickResponse(x, y, deadzone, notchProxmityThreshold);
+            table->Response[(uint8_t)rawX << 8 | (uint8_t)rawY][0] = x;
+            table->Response[(uint8_t)rawX << 8 | (uint8_t)rawY][1] = y;
+        }
+    }
+
+    tables.push_back(table);
+    return table;
+}
+
+void ComputeStickResponse(int8_t& x, int8_t& y, float deadzone, int32_t notchProxmityThreshold) {
+    auto ux = fabs(x);
+    auto uy = fabs(y);
+
+    // create scaled circular dead-zone in range {-15 ... +15}
+    auto len = sqrt(ux * ux + uy * uy);
+    if (len < deadzone) {
+        len = 0;
+    } else if (len > MAX_AXIS_RANGE) {
+        len = MAX_AXIS_RANGE / len;
+    } else {
+        len = (len - deadzone) * MAX_AXIS_RANGE / (MAX_AXIS_RANGE - deadzone) / len;
+    }
+    ux *= len;
+    uy *= len;
+
+    // bound diagonals to an octagonal range {-68 ... +68}
+    if (ux != 0.0 && uy != 0.0) {
+        auto slope = uy / ux;
+        auto edgex = copysign(MAX_AXIS_RANGE / (fabs(slope) + 16.0 / 69.0), ux);
+        auto edgey = copysign(std::min(fabs(edgex * slope), MAX_AXIS_RANGE / (1.0 / fabs(slope) + 16.0 / 69.0)), y);
+        edgex = edgey / slope;
+
+        auto scale = sqrt(edgex * edgex + edgey * edgey) / MAX_AXIS_RANGE;
+        ux *= scale;
+        uy *= scale;
+    }
+
+    // map to virtual notches
+    const double notchProximityValRadians = notchProxmityThreshold * M_TAU / 360;
+
+    const double distance = std::sqrt((ux * ux) + (uy * uy)) / MAX_AXIS_RANGE;
+    if (distance >= MINIMUM_RADIUS_TO_MAP_NOTCH) {
+        auto angle = atan2(uy, ux) + M_TAU;
+        auto newAngle = GetClosestNotch(angle, notchProximityValRadians);
+
+        ux = cos(newAngle) * distance * MAX_AXIS_RANGE;
+        uy = sin(newAngle) * distance * MAX_AXIS_RANGE;
+    }
+
+    // assign back to original sign
+    x = copysign(ux, x);
+    y = copysign(uy, y);
+}
+} // namespace Ship
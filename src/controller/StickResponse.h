@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#define MAX_AXIS_RANGE 85.0f
+
+namespace Ship {
+// Output of the stick processing for every possible raw input at one deadzone and notch setting. Indexed by
+// (uint8_t)x << 8 | (uint8_t)y, each entry holds the processed x and y.
+struct StickResponseTable {
+    float Deadzone;
+    int32_t NotchProximityThreshold;
+    int8_t Response[256 * 256][2];
+};
+
+// Applies the circular deadzone, the octagonal gate and the notch snapping to one raw stick position
+void ComputeStickResponse(int8_t& x, int8_t& y, float deadzone, int32_t notchProxmityThreshold);
+// Shared between all controllers, a table is built once per setting and goes away when no controller uses it anymore
+std::shared_ptr<const StickResponseTable> GetStickResponseTable(float deadzone, int32_t notchProxmityThreshold);
+} // namespace Ship
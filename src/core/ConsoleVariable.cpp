@@ -1,5 +1,7 @@
 #include "ConsoleVariable.h"
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include <Utils/File.h>
 #include <misc/Utils.h>
@@ -8,12 +10,30 @@
 
 namespace Ship {
 
-ConsoleVariable::ConsoleVariable() {
+ConsoleVariable::ConsoleVariable()
+    : mVariables(std::make_shared<const VariableMap>()), mWriteDepth(0), mEpoch(0), mNextCallbackId(0) {
+}
+
+std::shared_ptr<const ConsoleVariable::VariableMap> ConsoleVariable::LoadVariables() const {
+#ifdef __cpp_lib_atomic_shared_ptr
+    return mVariables.load(std::memory_order_acquire);
+#else
+    return std::atomic_load(&mVariables);
+#endif
+}
+
+void ConsoleVariable::StoreVariables(std::shared_ptr<const VariableMap> variables) {
+#ifdef __cpp_lib_atomic_shared_ptr
+    mVariables.store(std::move(variables), std::memory_order_release);
+#else
+    std::atomic_store(&mVariables, std::move(variables));
+#endif
 }
 
 std::shared_ptr<CVar> ConsoleVariable::Get(const char* name) {
-    auto it = mVariables.find(name);
-    return it != mVariables.end() ? it->second : nullptr;
+    auto variables = LoadVariables();
+    auto it = variables->find(name);
+    return it != variables->end() ? it->second : nullptr;
 }
 
 int32_t ConsoleVariable::GetInteger(const char* name, int32_t defaultValue) {
@@ -80,95 +100,255 @@ Color_RGB8 ConsoleVariable::GetColor24(const char* name, Color_RGB8 defaultValue
 }
 
 void ConsoleVariable::SetInteger(const char* name, int32_t value) {
-    auto& variable = mVariables[name];
-    if (variable == nullptr) {
-        variable = std::make_shared<CVar>();
+    BeginWrite();
+    auto current = Find(name);
+    if (current == nullptr || current->Type != ConsoleVariableType::Integer || current->Integer != value) {
+        auto variable = Write(name);
+        variable->Type = ConsoleVariableType::Integer;
+        variable->Integer = value;
     }
-
-    variable->Type = ConsoleVariableType::Integer;
-    variable->Integer = value;
+    EndWrite();
 }
 
 void ConsoleVariable::SetFloat(const char* name, float value) {
-    auto& variable = mVariables[name];
-    if (variable == nullptr) {
-        variable = std::make_shared<CVar>();
+    BeginWrite();
+    auto current = Find(name);
+    if (current == nullptr || current->Type != ConsoleVariableType::Float || current->Float != value) {
+        auto variable = Write(name);
+        variable->Type = ConsoleVariableType::Float;
+        variable->Float = value;
     }
-
-    variable->Type = ConsoleVariableType::Float;
-    variable->Float = value;
+    EndWrite();
 }
 
 void ConsoleVariable::SetString(const char* name, const char* value) {
-    auto& variable = mVariables[name];
-    if (variable == nullptr) {
-        variable = std::make_shared<CVar>();
+    BeginWrite();
+    auto current = Find(name);
+    if (current == nullptr || current->Type != ConsoleVariableType::String || current->String != value) {
+        auto variable = Write(name);
+        variable->Type = ConsoleVariableType::String;
+        variable->String = std::string(value);
     }
-
-    variable->Type = ConsoleVariableType::String;
-    variable->String = std::string(value);
+    EndWrite();
 }
 
 void ConsoleVariable::SetColor(const char* name, Color_RGBA8 value) {
-    auto& variable = mVariables[name];
-    if (!variable) {
-        variable = std::make_shared<CVar>();
+    BeginWrite();
+    auto current = Find(name);
+    if (current == nullptr || current->Type != ConsoleVariableType::Color ||
+        memcmp(&current->Color, &value, sizeof(value)) != 0) {
+        auto variable = Write(name);
+        variable->Type = ConsoleVariableType::Color;
+        variable->Color = value;
     }
-
-    variable->Type = ConsoleVariableType::Color;
-    variable->Color = value;
+    EndWrite();
 }
 
 void ConsoleVariable::SetColor24(const char* name, Color_RGB8 value) {
-    auto& variable = mVariables[name];
-    if (!variable) {
-        variable = std::make_shared<CVar>();
+    BeginWrite();
+    auto current = Find(name);
+    if (current == nullptr || current->Type != ConsoleVariableType::Color24 ||
+        memcmp(&current->Color24, &value, sizeof(value)) != 0) {
+        auto variable = Write(name);
+        variable->Type = ConsoleVariableType::Color24;
+        variable->Color24 = value;
     }
-
-    variable->Type = ConsoleVariableType::Color24;
-    variable->Color24 = value;
+    EndWrite();
 }
 
 void ConsoleVariable::RegisterInteger(const char* name, int32_t defaultValue) {
-    if (Get(name) == nullptr) {
+    BeginWrite();
+    if (Find(name) == nullptr) {
         SetInteger(name, defaultValue);
     }
+    EndWrite();
 }
 
 void ConsoleVariable::RegisterFloat(const char* name, float defaultValue) {
-    if (Get(name) == nullptr) {
+    BeginWrite();
+    if (Find(name) == nullptr) {
         SetFloat(name, defaultValue);
     }
+    EndWrite();
 }
 
 void ConsoleVariable::RegisterString(const char* name, const char* defaultValue) {
-    if (Get(name) == nullptr) {
+    BeginWrite();
+    if (Find(name) == nullptr) {
         SetString(name, defaultValue);
     }
+    EndWrite();
 }
 
 void ConsoleVariable::RegisterColor(const char* name, Color_RGBA8 defaultValue) {
-    if (Get(name) == nullptr) {
+    BeginWrite();
+    if (Find(name) == nullptr) {
         SetColor(name, defaultValue);
     }
+    EndWrite();
 }
 
 void ConsoleVariable::RegisterColor24(const char* name, Color_RGB8 defaultValue) {
-    if (Get(name) == nullptr) {
+    BeginWrite();
+    if (Find(name) == nullptr) {
         SetColor24(name, defaultValue);
     }
+    EndWrite();
+}
+
+CVarHandle<int32_t> ConsoleVariable::GetIntegerHandle(const char* name, int32_t defaultValue) {
+    const std::lock_guard<std::recursive_mutex> lock(mWriteMutex);
+    auto& slot = mIntegerSlots[name];
+    if (slot == nullptr) {
+        slot = std::make_unique<CVarSlot<int32_t>>();
+        slot->DefaultValue = defaultValue;
+        slot->Value = GetInteger(name, defaultValue);
+    }
+
+    return CVarHandle<int32_t>(slot.get());
+}
+
+CVarHandle<float> ConsoleVariable::GetFloatHandle(const char* name, float defaultValue) {
+    const std::lock_guard<std::recursive_mutex> lock(mWriteMutex);
+    auto& slot = mFloatSlots[name];
+    if (slot == nullptr) {
+        slot = std::make_unique<CVarSlot<float>>();
+        slot->DefaultValue = defaultValue;
+        slot->Value = GetFloat(name, defaultValue);
+    }
+
+    return CVarHandle<float>(slot.get());
+}
+
+void ConsoleVariable::UpdateHandles(const char* name) {
+    auto integerSlot = mIntegerSlots.find(name);
+    if (integerSlot != mIntegerSlots.end()) {
+        integerSlot->second->Value = GetInteger(name, integerSlot->second->DefaultValue);
+    }
+
+    auto floatSlot = mFloatSlots.find(name);
+    if (floatSlot != mFloatSlots.end()) {
+        floatSlot->second->Value = GetFloat(name, floatSlot->second->DefaultValue);
+    }
 }
 
 void ConsoleVariable::ClearVariable(const char* name) {
     std::shared_ptr<Mercury> conf = Ship::Window::GetInstance()->GetConfig();
-    mVariables.erase(name);
+    BeginWrite();
+    if (Find(name) != nullptr) {
+        PendingVariables().erase(name);
+        mPendingChanges.emplace_back(name);
+    }
+    EndWrite();
     conf->erase(StringHelper::Sprintf("CVars.%s", name));
 }
 
+uint32_t ConsoleVariable::RegisterChangeCallback(const char* name, CVarChangeCallback callback) {
+    const std::lock_guard<std::mutex> lock(mCallbackMutex);
+    uint32_t id = mNextCallbackId++;
+    mChangeCallbacks[id] = { name, std::move(callback) };
+    return id;
+}
+
+void ConsoleVariable::UnregisterChangeCallback(uint32_t id) {
+    const std::lock_guard<std::mutex> lock(mCallbackMutex);
+    mChangeCallbacks.erase(id);
+}
+
+uint64_t ConsoleVariable::GetEpoch() {
+    return mEpoch.load(std::memory_order_acquire);
+}
+
+void ConsoleVariable::BeginBatch() {
+    BeginWrite();
+}
+
+void ConsoleVariable::EndBatch() {
+    EndWrite();
+}
+
+void ConsoleVariable::BeginWrite() {
+    mWriteMutex.lock();
+    mWriteDepth++;
+}
+
+ConsoleVariable::VariableMap& ConsoleVariable::PendingVariables() {
+    // Copied on the first actual change of a write, writes that change nothing publish nothing
+    if (mPendingVariables == nullptr) {
+        mPendingVariables = std::make_shared<VariableMap>(*LoadVariables());
+    }
+
+    return *mPendingVariables;
+}
+
+std::shared_ptr<CVar> ConsoleVariable::Find(const char* name) {
+    if (mPendingVariables == nullptr) {
+        return Get(name);
+    }
+
+    auto it = mPendingVariables->find(name);
+    return it != mPendingVariables->end() ? it->second : nullptr;
+}
+
+std::shared_ptr<CVar> ConsoleVariable::Write(const char* name) {
+    auto& variable = PendingVariables()[name];
+    // Published variables may be in use by readers, so they are never modified in place
+    variable = variable != nullptr ? std::make_shared<CVar>(*variable) : std::make_shared<CVar>();
+    mPendingChanges.emplace_back(name);
+    return variable;
+}
+
+void ConsoleVariable::EndWrite() {
+    std::vector<std::string> changes;
+
+    if (--mWriteDepth == 0 && mPendingVariables != nullptr) {
+        StoreVariables(std::move(mPendingVariables));
+        mPendingVariables = nullptr;
+        changes.swap(mPendingChanges);
+        std::sort(changes.begin(), changes.end());
+        changes.erase(std::unique(changes.begin(), changes.end()), changes.end());
+        for (const auto& name : changes) {
+            UpdateHandles(name.c_str());
+        }
+        if (!changes.empty()) {
+            mEpoch.fetch_add(1, std::memory_order_acq_rel);
+        }
+    }
+
+    mWriteMutex.unlock();
+
+    if (changes.empty()) {
+        return;
+    }
+
+    // Callbacks are copied so they can register, unregister or change variables themselves
+    std::vector<std::pair<std::string, CVarChangeCallback>> callbacks;
+    {
+        const std::lock_guard<std::mutex> lock(mCallbackMutex);
+        for (const auto& entry : mChangeCallbacks) {
+            if (std::binary_search(changes.begin(), changes.end(), entry.second.first)) {
+                callbacks.push_back(entry.second);
+            }
+        }
+    }
+    for (const auto& callback : callbacks) {
+        callback.second(callback.first.c_str());
+    }
+}
+
 void ConsoleVariable::Save() {
     std::shared_ptr<Mercury> conf = Ship::Window::GetInstance()->GetConfig();
+    const std::lock_guard<std::mutex> lock(mSaveMutex);
+
+    auto variables = LoadVariables();
+    for (const auto& variable : *variables) {
+        if (mSavedVariables != nullptr) {
+            auto saved = mSavedVariables->find(variable.first);
+            if (saved != mSavedVariables->end() && saved->second == variable.second) {
+                continue;
+            }
+        }
 
-    for (const auto& variable : mVariables) {
         const std::string key = StringHelper::Sprintf("CVars.%s", variable.first.c_str());
 
         if (variable.second->Type == ConsoleVariableType::String && variable.second != nullptr &&
@@ -194,16 +374,25 @@ void ConsoleVariable::Save() {
         }
     }
 
-    conf->save();
+    mSavedVariables = variables;
+    conf->saveDeferred();
 }
 
 void ConsoleVariable::Load() {
     std::shared_ptr<Mercury> conf = Ship::Window::GetInstance()->GetConfig();
+    conf->flush();
     conf->reload();
+    {
+        // The reloaded config may not contain everything saved so far, write everything on the next save
+        const std::lock_guard<std::mutex> lock(mSaveMutex);
+        mSavedVariables = nullptr;
+    }
 
+    // Publish everything that was loaded at once instead of copying the variables for each of them
+    BeginWrite();
     LoadFromPath("", conf->rjson["CVars"].items());
-
     LoadLegacy();
+    EndWrite();
 }
 
 void ConsoleVariable::LoadFromPath(
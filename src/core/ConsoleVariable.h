@@ -3,9 +3,13 @@
 #include "libultraship/color.h"
 #include <nlohmann/json.hpp>
 #include <stdint.h>
+#include <atomic>
+#include <functional>
 #include <memory>
 #include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace Ship {
 typedef enum class ConsoleVariableType { Integer, Float, String, Color, Color24 } ConsoleVariableType;
@@ -23,6 +27,40 @@ typedef struct CVar {
     Color_RGB8 Color24;
 } CVar;
 
+// Storage behind a CVarHandle. Holds the current value of the variable, or the default while the variable is unset or
+// of another type, so that reading it doesn't need a lookup by name.
+template <typename T> struct CVarSlot {
+    std::atomic<T> Value;
+    T DefaultValue;
+};
+
+// Stable reference to an integer or float variable, valid for the lifetime of the ConsoleVariable that created it.
+// Reading it is a single atomic load.
+template <typename T> class CVarHandle {
+  public:
+    CVarHandle() : mSlot(nullptr) {
+    }
+    explicit CVarHandle(const CVarSlot<T>* slot) : mSlot(slot) {
+    }
+
+    T Get() const {
+        return mSlot->Value.load(std::memory_order_relaxed);
+    }
+    operator T() const {
+        return Get();
+    }
+    bool IsValid() const {
+        return mSlot != nullptr;
+    }
+
+  private:
+    const CVarSlot<T>* mSlot;
+};
+
+typedef std::function<void(const char* name)> CVarChangeCallback;
+
+// Readers never wait for writers: they work on an immutable snapshot of the variables that writers replace as a whole.
+// A variable returned by Get is a snapshot as well and doesn't see later changes.
 class ConsoleVariable {
   public:
     ConsoleVariable();
@@ -47,8 +85,22 @@ class ConsoleVariable {
     void RegisterColor(const char* name, Color_RGBA8 defaultValue);
     void RegisterColor24(const char* name, Color_RGB8 defaultValue);
 
+    CVarHandle<int32_t> GetIntegerHandle(const char* name, int32_t defaultValue);
+    CVarHandle<float> GetFloatHandle(const char* name, float defaultValue);
+
     void ClearVariable(const char* name);
 
+    // Changes between BeginBatch and the matching EndBatch are published together, so the variables are copied once
+    // instead of on every change. Other writers wait until the batch ends, readers don't.
+    void BeginBatch();
+    void EndBatch();
+
+    // The callback runs on the thread that made the change, after the new value is visible to readers
+    uint32_t RegisterChangeCallback(const char* name, CVarChangeCallback callback);
+    void UnregisterChangeCallback(uint32_t id);
+    // Incremented on every change. Pollers can compare it to the value they saw last instead of rereading variables.
+    uint64_t GetEpoch();
+
     void Save();
     void Load();
 
@@ -56,8 +108,45 @@ class ConsoleVariable {
     void LoadFromPath(std::string path,
                       nlohmann::detail::iteration_proxy<nlohmann::detail::iter_impl<nlohmann::json>> items);
     void LoadLegacy();
+    void UpdateHandles(const char* name);
+
+    // Writes between BeginWrite and the matching EndWrite are published together. Find sees the writes made so far,
+    // Write returns a private copy of the variable to modify, creating it if needed.
+    void BeginWrite();
+    std::shared_ptr<CVar> Find(const char* name);
+    std::shared_ptr<CVar> Write(const char* name);
+    void EndWrite();
 
   private:
-    std::map<std::string, std::shared_ptr<CVar>, std::less<>> mVariables;
+    typedef std::map<std::string, std::shared_ptr<CVar>, std::less<>> VariableMap;
+
+    std::shared_ptr<const VariableMap> LoadVariables() const;
+    void StoreVariables(std::shared_ptr<const VariableMap> variables);
+    VariableMap& PendingVariables();
+
+#ifdef __cpp_lib_atomic_shared_ptr
+    std::atomic<std::shared_ptr<const VariableMap>> mVariables;
+#else
+    // libc++ doesn't have std::atomic<std::shared_ptr> yet
+    std::shared_ptr<const VariableMap> mVariables;
+#endif
+    std::shared_ptr<VariableMap> mPendingVariables;
+    std::vector<std::string> mPendingChanges;
+    int32_t mWriteDepth;
+    std::recursive_mutex mWriteMutex;
+    std::atomic<uint64_t> mEpoch;
+
+    // Snapshot written by the last Save. Variables are copied on every change, so any variable that is not the same
+    // object as in this snapshot changed since.
+    std::mutex mSaveMutex;
+    std::shared_ptr<const VariableMap> mSavedVariables;
+
+    std::mutex mCallbackMutex;
+    uint32_t mNextCallbackId;
+    std::map<uint32_t, std::pair<std::string, CVarChangeCallback>> mChangeCallbacks;
+
+    // Slots are never removed, handles to them stay valid when the variable is cleared
+    std::map<std::string, std::unique_ptr<CVarSlot<int32_t>>, std::less<>> mIntegerSlots;
+    std::map<std::string, std::unique_ptr<CVarSlot<float>>, std::less<>> mFloatSlots;
 };
 } // namespace Ship
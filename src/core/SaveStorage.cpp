@@ -0,0 +1,257 @@
+#include "SaveStorage.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// Writes within this long of each other go out together, a game saving in many small chunks touches the disk once
+#define SAVE_STORAGE_COALESCE_MS 100
+// Keeps a game that never stops writing from holding its save back forever
+#define SAVE_STORAGE_MAX_DELAY_MS 1000
+
+namespace Ship {
+SaveStorage::SaveStorage() : mWriteCount(0), mSynchronous(false), mStopping(false) {
+    mFlushThread = std::thread(&SaveStorage::FlushThreadMain, this);
+}
+
+SaveStorage::~SaveStorage() {
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    mFlushThread.join();
+
+    Flush();
+}
+
+SaveStorage::SaveImage& SaveStorage::GetImage(const std::filesystem::path& savePath) {
+    auto [it, inserted] = mImages.try_emplace(savePath.string());
+    SaveImage& image = it->second;
+    if (!inserted) {
+        return image;
+    }
+
+    image.Path = savePath;
+    std::ifstream saveFile(savePath, std::fstream::in | std::fstream::binary | std::fstream::ate);
+    if (saveFile.good()) {
+        image.Data.resize(saveFile.tellg());
+        saveFile.seekg(0);
+        saveFile.read((char*)image.Data.data(), image.Data.size());
+    }
+
+    return image;
+}
+
+void SaveStorage::Read(const std::filesystem::path& savePath, uintptr_t addr, void* dramAddr, size_t size) {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    const SaveImage& image = GetImage(savePath);
+
+    // Anything past the end of the file reads as zero, like a fresh save
+    const size_t available = addr < image.Data.size() ? std::min(size, image.Data.size() - addr) : 0;
+    if (available > 0) {
+        memcpy(dramAddr, image.Data.data() + addr, available);
+    }
+    memset((uint8_t*)dramAddr + available, 0, size - available);
+}
+
+void SaveStorage::Write(const std::filesystem::path& savePath, uintptr_t addr, const void* dramAddr, size_t size) {
+    bool synchronous;
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        SaveImage& image = GetImage(savePath);
+        if (image.Data.size() < addr + size) {
+            image.Data.resize(addr + size);
+        }
+        memcpy(image.Data.data() + addr, dramAddr, size);
+        image.Generation++;
+        mWriteCount++;
+        synchronous = mSynchronous;
+    }
+
+    if (synchronous) {
+        Flush();
+    } else {
+        mWake.notify_all();
+    }
+}
+
+bool SaveStorage::Flush() {
+    const std::lock_guard<std::mutex> flushLock(mFlushMutex);
+    std::unique_lock<std::mutex> lock(mMutex);
+
+    // Images are never removed, so the pointers stay valid while the lock is released for the file writes
+    std::vector<SaveImage*> dirty;
+    for (auto& [path, image] : mImages) {
+        if (image.Generation != image.FlushedGeneration) {
+            dirty.push_back(&image);
+        }
+    }
+
+    bool success = true;
+    for (SaveImage* image : dirty) {
+        const std::vector<uint8_t> data = image->Data;
+        const uint64_t generation = image->Generation;
+        const std::filesystem::path path = image->Path;
+
+        lock.unlock();
+        const bool written = WriteFileAtomic(path, data);
+        lock.lock();
+
+        if (written) {
+            image->FlushedGeneration = generation;
+        }
+        success &= written;
+    }
+
+    return success;
+}
+
+void SaveStorage::SetSynchronous(bool synchronous) {
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mSynchronous = synchronous;
+    }
+
+    if (synchronous) {
+        Flush();
+    }
+}
+
+bool SaveStorage::IsSynchronous() {
+    const std::lock_guard<std::mutex> lock(mMutex);
+    return mSynchronous;
+}
+
+bool SaveStorage::HasDirtyImages() {
+    for (const auto& [path, image] : mImages) {
+        if (image.Generation != image.FlushedGeneration) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SaveStorage::FlushThreadMain() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (true) {
+        mWake.wait(lock, [this] { return mStopping || HasDirtyImages(); });
+        if (mStopping) {
+            return;
+        }
+
+        // Wait for the writes to settle
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SAVE_STORAGE_MAX_DELAY_MS);
+        uint64_t seenWrites;
+        do {
+            seenWrites = mWriteCount;
+            mWake.wait_until(lock,
+                             std::min(deadline, std::chrono::steady_clock::now() +
+                                                    std::chrono::milliseconds(SAVE_STORAGE_COALESCE_MS)),
+                             [this] { return mStopping; });
+        } while (!mStopping && seenWrites != mWriteCount && std::chrono::steady_clock::now() < deadline);
+
+        if (mStopping) {
+            // The destructor flushes what is left
+            return;
+        }
+
+        lock.unlock();
+        if (!Flush()) {
+            // Try again later instead of spinning on a file that can't be written
+            std::this_thread::sleep_for(std::chrono::milliseconds(SAVE_STORAGE_MAX_DELAY_MS));
+        }
+        lock.lock();
+    }
+}
+
+// Writes the whole file and waits for it to reach the disk, a rename onto the save is only safe after that
+static bool WriteFileDurable(const std::filesystem::path& path, const std::vector<uint8_t>& data) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    DWORD written = 0;
+    bool success = WriteFile(file, data.data(), (DWORD)data.size(), &written, nullptr) && written == data.size();
+    success = success && FlushFileBuffers(file);
+    success &= CloseHandle(file) != 0;
+    return success;
+#else
+    const int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    size_t offset = 0;
+    while (offset < data.size()) {
+        const ssize_t written = write(fd, data.data() + offset, data.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        offset += written;
+    }
+
+    bool success = offset == data.size();
+#ifdef __APPLE__
+    // fsync on macOS leaves the data in the drive's cache, F_FULLFSYNC doesn't. Not every file system supports it.
+    success = success && (fcntl(fd, F_FULLFSYNC) == 0 || fsync(fd) == 0);
+#else
+    success = success && fsync(fd) == 0;
+#endif
+    success &= close(fd) == 0;
+    return success;
+#endif
+}
+
+// Makes the rename itself durable. Windows has no directory handle to flush, its renames are journaled by NTFS.
+static void SyncDirectory(const std::filesystem::path& path) {
+#ifndef _WIN32
+    const std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : ".";
+    const int fd = open(directory.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    // Some file systems refuse to sync directories, the file data is on disk either way
+    fsync(fd);
+    close(fd);
+#endif
+}
+
+bool SaveStorage::WriteFileAtomic(const std::filesystem::path& path, const std::vector<uint8_t>& data) {
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+
+    if (!WriteFileDurable(tempPath, data)) {
+        SPDLOG_ERROR("Failed to write save file {}", tempPath.string());
+        return false;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        SPDLOG_ERROR("Failed to replace save file {} ({})", path.string(), error.message());
+        return false;
+    }
+
+    SyncDirectory(path);
+    return true;
+}
+} // namespace Ship
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <stdint.h>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Ship {
+// Keeps every save file the game touches in memory. Reads and writes only copy to and from that image, writes mark it
+// dirty and a background thread writes it out once writes have settled. Files are replaced through a temporary file
+// that is synced to disk before the rename, so a crash or power loss during a write leaves the previous save intact.
+class SaveStorage {
+  public:
+    SaveStorage();
+    ~SaveStorage();
+
+    void Read(const std::filesystem::path& savePath, uintptr_t addr, void* dramAddr, size_t size);
+    void Write(const std::filesystem::path& savePath, uintptr_t addr, const void* dramAddr, size_t size);
+    // Writes every dirty image out before returning
+    bool Flush();
+    // In synchronous mode each write is on disk once Write returns
+    void SetSynchronous(bool synchronous);
+    bool IsSynchronous();
+
+  private:
+    struct SaveImage {
+        std::filesystem::path Path;
+        std::vector<uint8_t> Data;
+        // Bumped on every write, the flush only clears the dirty state if no write came in while it was writing
+        uint64_t Generation = 0;
+        uint64_t FlushedGeneration = 0;
+    };
+
+    // Loads the file on first use, the caller holds mMutex
+    SaveImage& GetImage(const std::filesystem::path& savePath);
+    bool HasDirtyImages();
+    void FlushThreadMain();
+    static bool WriteFileAtomic(const std::filesystem::path& path, const std::vector<uint8_t>& data);
+
+    std::mutex mMutex;
+    // Only one flush writes at a time, so a synchronous flush can't race the background thread on the same file
+    std::mutex mFlushMutex;
+    std::condition_variable mWake;
+    std::unordered_map<std::string, SaveImage> mImages;
+    std::thread mFlushThread;
+    uint64_t mWriteCount;
+    bool mSynchronous;
+    bool mStopping;
+};
+} // namespace Ship
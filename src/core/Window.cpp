@@ -6,6 +6,7 @@
 #include "controller/KeyboardController.h"
 #include "menu/Console.h"
 #include "misc/Hooks.h"
+#include "debug/TraceEvents.h"
 #include "resource/ResourceMgr.h"
 #include <string>
 #include "graphic/Fast3D/gfx_pc.h"
@@ -66,6 +67,8 @@ Window::Window(std::string Name)
 
 Window::~Window() {
     SPDLOG_DEBUG("destruct window");
+    // Writes out pending saves while the logger is still around to report failures
+    mSaveStorage = nullptr;
     spdlog::shutdown();
 }
 
@@ -104,6 +107,7 @@ void Window::Initialize(const std::vector<std::string>& otrFiles, const std::uno
     CreateDefaults();
     InitializeControlDeck();
     InitializeCrashHandler();
+    InitializeSaveStorage();
 
     bool steamDeckGameMode = false;
 
@@ -212,7 +216,17 @@ void Window::SetCursorVisibility(bool visible) {
 }
 
 void Window::MainLoop(void (*MainFunction)(void)) {
+#ifdef LUS_TRACE_EVENTS
+    // Wrapped so every iteration of the game loop gets its own span
+    static void (*sMainFunction)(void);
+    sMainFunction = MainFunction;
+    mWindowManagerApi->main_loop([]() {
+        LUS_TRACE_SPAN("Window::MainLoop", "frame");
+        sMainFunction();
+    });
+#else
     mWindowManagerApi->main_loop(MainFunction);
+#endif
 }
 
 bool Window::KeyUp(int32_t scancode) {
@@ -311,6 +325,13 @@ void Window::InitializeAudioPlayer(std::string_view audioBackend) {
         mAudioPlayer = std::make_shared<SDLAudioPlayer>();
         return;
     }
+    if (audioBackend == "null") {
+        // Writes to a WAV file when a path is configured, otherwise the samples are only consumed. With the manual
+        // clock samples are only consumed through AudioPlayerAdvanceClock.
+        mAudioPlayer = std::make_shared<NullAudioPlayer>(GetConfig()->getString("Window.AudioDumpPath"),
+                                                         GetConfig()->getBool("Window.AudioManualClock", false));
+        return;
+    }
 
     // Defaults if not on list above
 #ifdef _WIN32
@@ -509,26 +530,19 @@ void Window::InitializeSpeechSynthesis() {
 #endif
 }
 
+void Window::InitializeSaveStorage() {
+    mSaveStorage = std::make_shared<SaveStorage>();
+    mSaveStorage->SetSynchronous(GetConfig()->getBool("Window.SaveFileSync", false));
+}
+
 void Window::WriteSaveFile(const std::filesystem::path& savePath, const uintptr_t addr, void* dramAddr,
                            const size_t size) {
-    std::ofstream saveFile = std::ofstream(savePath, std::fstream::in | std::fstream::out | std::fstream::binary);
-    saveFile.seekp(addr);
-    saveFile.write((char*)dramAddr, size);
-    saveFile.close();
+    mSaveStorage->Write(savePath, addr, dramAddr, size);
 }
 
 void Window::ReadSaveFile(std::filesystem::path savePath, uintptr_t addr, void* dramAddr, size_t size) {
-    std::ifstream saveFile = std::ifstream(savePath, std::fstream::in | std::fstream::out | std::fstream::binary);
-
-    // If the file doesn't exist, initialize DRAM
-    if (saveFile.good()) {
-        saveFile.seekg(addr);
-        saveFile.read((char*)dramAddr, size);
-    } else {
-        memset(dramAddr, 0, size);
-    }
-
-    saveFile.close();
+    // If the file doesn't exist, DRAM is zeroed
+    mSaveStorage->Read(savePath, addr, dramAddr, size);
 }
 
 bool Window::IsFullscreen() {
@@ -555,6 +569,10 @@ std::shared_ptr<AudioPlayer> Window::GetAudioPlayer() {
     return mAudioPlayer;
 }
 
+std::string Window::GetAudioBackend() {
+    return mAudioBackend;
+}
+
 std::shared_ptr<ResourceMgr> Window::GetResourceManager() {
     return mResourceManager;
 }
@@ -571,6 +589,10 @@ std::shared_ptr<spdlog::logger> Window::GetLogger() {
     return mLogger;
 }
 
+std::shared_ptr<SaveStorage> Window::GetSaveStorage() {
+    return mSaveStorage;
+}
+
 std::shared_ptr<SpeechSynthesizer> Window::GetSpeechSynthesizer() {
     return mSpeechSynthesizer;
 }
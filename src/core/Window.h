@@ -6,6 +6,7 @@
 #include <spdlog/spdlog.h>
 #include "controller/ControlDeck.h"
 #include "core/ConsoleVariable.h"
+#include "core/SaveStorage.h"
 #include "debug/CrashHandler.h"
 #include "audio/AudioPlayer.h"
 #include "speechsynthesizer/SpeechSynthesizer.h"
@@ -53,12 +54,14 @@ class Window {
     std::string GetName();
     std::shared_ptr<ControlDeck> GetControlDeck();
     std::shared_ptr<AudioPlayer> GetAudioPlayer();
+    std::string GetAudioBackend();
     std::shared_ptr<ResourceMgr> GetResourceManager();
     std::shared_ptr<CrashHandler> GetCrashHandler();
     std::shared_ptr<Mercury> GetConfig();
     std::shared_ptr<spdlog::logger> GetLogger();
     std::shared_ptr<ConsoleVariable> GetConsoleVariables();
     std::shared_ptr<SpeechSynthesizer> GetSpeechSynthesizer();
+    std::shared_ptr<SaveStorage> GetSaveStorage();
     const char* GetKeyName(int32_t scancode);
     int32_t GetLastScancode();
     void SetLastScancode(int32_t scanCode);
@@ -84,6 +87,7 @@ class Window {
     void InitializeResourceManager(const std::vector<std::string>& otrFiles = {},
                                    const std::unordered_set<uint32_t>& validHashes = {});
     void InitializeSpeechSynthesis();
+    void InitializeSaveStorage();
 
     std::shared_ptr<spdlog::logger> mLogger;
     std::shared_ptr<Mercury> mConfig;
@@ -93,6 +97,7 @@ class Window {
     std::shared_ptr<ConsoleVariable> mConsoleVariables;
     std::shared_ptr<CrashHandler> mCrashHandler;
     std::shared_ptr<SpeechSynthesizer> mSpeechSynthesizer;
+    std::shared_ptr<SaveStorage> mSaveStorage;
 
     std::string mGfxBackend;
     std::string mGfxApi;
@@ -1,6 +1,8 @@
 #include "core/bridge/audioplayerbridge.h"
 #include "core/Window.h"
 #include "menu/ImGuiImpl.h"
+#include "audio/AudioMixer.h"
+#include "audio/NullAudioPlayer.h"
 
 extern "C" {
 
@@ -13,12 +15,22 @@ bool AudioPlayerInit(void) {
         return true;
     }
 
-    // loop over available audio apis if current fails
+    // loop over available audio apis if current fails. The fallback is only used for this run, the configured backend
+    // is kept so a device that is missing once doesn't switch the game to another backend for good.
     auto audioBackends = SohImGui::GetAvailableAudioBackends();
+    std::string failedBackend = Ship::Window::GetInstance()->GetAudioBackend();
+    if (failedBackend.empty()) {
+        // An empty backend picks the platform default, which is the first one in the list
+        failedBackend = audioBackends[0].first;
+    }
     for (uint8_t i = 0; i < audioBackends.size(); i++) {
-        SohImGui::SetCurrentAudioBackend(i, audioBackends[i]);
+        if (failedBackend == audioBackends[i].first) {
+            continue;
+        }
         Ship::Window::GetInstance()->InitializeAudioPlayer(audioBackends[i].first);
+        audio = Ship::Window::GetInstance()->GetAudioPlayer();
         if (audio->Init()) {
+            SohImGui::SetCurrentAudioBackend(i, audioBackends[i], false);
             return true;
         }
     }
@@ -44,6 +56,15 @@ int32_t AudioPlayerGetDesiredBuffered(void) {
     return audio->GetDesiredBuffered();
 }
 
+void AudioPlayerSetDesiredBuffered(int32_t frames) {
+    auto audio = Ship::Window::GetInstance()->GetAudioPlayer();
+    if (audio == nullptr) {
+        return;
+    }
+
+    audio->SetDesiredBuffered(frames);
+}
+
 void AudioPlayerPlayFrame(const uint8_t* buf, size_t len) {
     auto audio = Ship::Window::GetInstance()->GetAudioPlayer();
     if (audio == nullptr) {
@@ -52,4 +73,74 @@ void AudioPlayerPlayFrame(const uint8_t* buf, size_t len) {
 
     audio->Play(buf, len);
 }
+
+int32_t AudioPlayerGetLatency(void) {
+    auto audio = Ship::Window::GetInstance()->GetAudioPlayer();
+    if (audio == nullptr) {
+        return 0;
+    }
+
+    return audio->GetStats().LatencyFrames;
+}
+
+uint64_t AudioPlayerGetUnderruns(void) {
+    auto audio = Ship::Window::GetInstance()->GetAudioPlayer();
+    if (audio == nullptr) {
+        return 0;
+    }
+
+    return audio->GetStats().Underruns;
+}
+
+uint64_t AudioPlayerGetOverruns(void) {
+    auto audio = Ship::Window::GetInstance()->GetAudioPlayer();
+    if (audio == nullptr) {
+        return 0;
+    }
+
+    return audio->GetStats().Overruns;
+}
+
+void AudioPlayerAdvanceClock(uint32_t frames) {
+    auto audio = std::dynamic_pointer_cast<Ship::NullAudioPlayer>(Ship::Window::GetInstance()->GetAudioPlayer());
+    if (audio == nullptr) {
+        return;
+    }
+
+    audio->AdvanceClock(frames);
+}
+
+void AudioPlayerSetCaptureEnabled(bool enabled) {
+    auto audio = std::dynamic_pointer_cast<Ship::NullAudioPlayer>(Ship::Window::GetInstance()->GetAudioPlayer());
+    if (audio == nullptr) {
+        return;
+    }
+
+    audio->SetCaptureEnabled(enabled);
+}
+
+size_t AudioPlayerTakeCapturedSamples(uint8_t* buf, size_t len) {
+    auto audio = std::dynamic_pointer_cast<Ship::NullAudioPlayer>(Ship::Window::GetInstance()->GetAudioPlayer());
+    if (audio == nullptr) {
+        return 0;
+    }
+
+    return audio->TakeCapturedSamples(buf, len);
+}
+
+AudioMixerHandle* AudioMixerCreate(void) {
+    return (AudioMixerHandle*)new Ship::AudioMixer();
+}
+
+void AudioMixerDestroy(AudioMixerHandle* mixer) {
+    delete (Ship::AudioMixer*)mixer;
+}
+
+void AudioMixerSetSegment(AudioMixerHandle* mixer, uint8_t segment, void* base) {
+    ((Ship::AudioMixer*)mixer)->SetSegment(segment, base);
+}
+
+void AudioMixerExecute(AudioMixerHandle* mixer, const void* cmds, size_t count) {
+    ((Ship::AudioMixer*)mixer)->Execute((const Acmd*)cmds, count);
+}
 }
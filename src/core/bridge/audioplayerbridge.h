@@ -13,7 +13,25 @@ extern "C" {
 bool AudioPlayerInit(void);
 int32_t AudioPlayerBuffered(void);
 int32_t AudioPlayerGetDesiredBuffered(void);
+void AudioPlayerSetDesiredBuffered(int32_t frames);
 void AudioPlayerPlayFrame(const uint8_t* buf, size_t len);
+int32_t AudioPlayerGetLatency(void);
+uint64_t AudioPlayerGetUnderruns(void);
+uint64_t AudioPlayerGetOverruns(void);
+
+// Only act on the "null" backend. The clock only moves here when Window.AudioManualClock is set. Taking captured samples
+// copies up to len of the oldest captured bytes into buf, removes them and returns how many were copied.
+void AudioPlayerAdvanceClock(uint32_t frames);
+void AudioPlayerSetCaptureEnabled(bool enabled);
+size_t AudioPlayerTakeCapturedSamples(uint8_t* buf, size_t len);
+
+// Runs audio microcode command lists (Acmd, see abi.h) natively. Every mixer has its own DMEM and command state, use
+// one per audio task.
+typedef struct AudioMixerHandle AudioMixerHandle;
+AudioMixerHandle* AudioMixerCreate(void);
+void AudioMixerDestroy(AudioMixerHandle* mixer);
+void AudioMixerSetSegment(AudioMixerHandle* mixer, uint8_t segment, void* base);
+void AudioMixerExecute(AudioMixerHandle* mixer, const void* cmds, size_t count);
 
 #ifdef __cplusplus
 };
@@ -6,6 +6,22 @@ std::shared_ptr<Ship::CVar> CVarGet(const char* name) {
     return Ship::Window::GetInstance()->GetConsoleVariables()->Get(name);
 }
 
+Ship::CVarHandle<int32_t> CVarGetIntegerHandle(const char* name, int32_t defaultValue) {
+    return Ship::Window::GetInstance()->GetConsoleVariables()->GetIntegerHandle(name, defaultValue);
+}
+
+Ship::CVarHandle<float> CVarGetFloatHandle(const char* name, float defaultValue) {
+    return Ship::Window::GetInstance()->GetConsoleVariables()->GetFloatHandle(name, defaultValue);
+}
+
+uint32_t CVarRegisterChangeCallback(const char* name, Ship::CVarChangeCallback callback) {
+    return Ship::Window::GetInstance()->GetConsoleVariables()->RegisterChangeCallback(name, std::move(callback));
+}
+
+void CVarUnregisterChangeCallback(uint32_t id) {
+    Ship::Window::GetInstance()->GetConsoleVariables()->UnregisterChangeCallback(id);
+}
+
 extern "C" {
 int32_t CVarGetInteger(const char* name, int32_t defaultValue) {
     return Ship::Window::GetInstance()->GetConsoleVariables()->GetInteger(name, defaultValue);
@@ -71,6 +87,18 @@ void CVarClear(const char* name) {
     Ship::Window::GetInstance()->GetConsoleVariables()->ClearVariable(name);
 }
 
+void CVarBeginBatch() {
+    Ship::Window::GetInstance()->GetConsoleVariables()->BeginBatch();
+}
+
+void CVarEndBatch() {
+    Ship::Window::GetInstance()->GetConsoleVariables()->EndBatch();
+}
+
+uint64_t CVarGetEpoch() {
+    return Ship::Window::GetInstance()->GetConsoleVariables()->GetEpoch();
+}
+
 void CVarLoad() {
     Ship::Window::GetInstance()->GetConsoleVariables()->Load();
 }
@@ -10,6 +10,11 @@
 #include <memory>
 #include <core/ConsoleVariable.h>
 std::shared_ptr<Ship::CVar> CVarGet(const char* name);
+// Handles skip the lookup by name, use them for variables read every frame or per resource
+Ship::CVarHandle<int32_t> CVarGetIntegerHandle(const char* name, int32_t defaultValue);
+Ship::CVarHandle<float> CVarGetFloatHandle(const char* name, float defaultValue);
+uint32_t CVarRegisterChangeCallback(const char* name, Ship::CVarChangeCallback callback);
+void CVarUnregisterChangeCallback(uint32_t id);
 
 extern "C" {
 #endif
@@ -33,6 +38,10 @@ void CVarRegisterColor(const char* name, Color_RGBA8 defaultValue);
 void CVarRegisterColor24(const char* name, Color_RGB8 defaultValue);
 
 void CVarClear(const char* name);
+// Changes between the two are published together, wrap runs of sets like registering a menu's defaults
+void CVarBeginBatch();
+void CVarEndBatch();
+uint64_t CVarGetEpoch();
 
 void CVarLoad();
 void CVarSave();
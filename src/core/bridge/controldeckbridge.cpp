@@ -10,4 +10,18 @@ void BlockGameInput(void) {
 void UnblockGameInput(void) {
     Ship::Window::GetInstance()->GetControlDeck()->UnblockGameInput();
 }
+
+bool StartInputRecording(const char* path) {
+    return Ship::Window::GetInstance()->GetControlDeck()->GetInputRecorder()->Start(path);
+}
+
+bool StartInputReplay(const char* path) {
+    return Ship::Window::GetInstance()->GetControlDeck()->GetReplayController()->Load(path);
+}
+
+void StopInputRecording(void) {
+    auto controlDeck = Ship::Window::GetInstance()->GetControlDeck();
+    controlDeck->GetInputRecorder()->Stop();
+    controlDeck->GetReplayController()->Stop();
+}
 }
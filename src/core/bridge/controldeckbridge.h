@@ -9,6 +9,9 @@ extern "C" {
 
 void BlockGameInput(void);
 void UnblockGameInput(void);
+bool StartInputRecording(const char* path);
+bool StartInputReplay(const char* path);
+void StopInputRecording(void);
 
 #ifdef __cplusplus
 };
@@ -1,5 +1,6 @@
 #include "core/bridge/windowbridge.h"
 #include "core/Window.h"
+#include "graphic/Fast3D/gfx_pacing.h"
 
 extern "C" {
 
@@ -26,4 +27,12 @@ uint16_t GetPixelDepth(float x, float y) {
 uint32_t DoesOtrFileExist() {
     return Ship::Window::GetInstance()->DoesOtrFileExist();
 }
+
+void GetFramePacingStats(uint32_t metric, struct GfxPacingStats* stats) {
+    gfx_pacing_get_stats((enum GfxPacingMetric)metric, stats);
+}
+
+void ResetFramePacingStats() {
+    gfx_pacing_reset_stats();
+}
 }
@@ -9,12 +9,17 @@
 extern "C" {
 #endif
 
+// Defined in graphic/Fast3D/gfx_pacing.h
+struct GfxPacingStats;
+
 uint32_t GetWindowWidth();
 uint32_t GetWindowHeight();
 float GetWindowAspectRatio();
 void GetPixelDepthPrepare(float x, float y);
 uint16_t GetPixelDepth(float x, float y);
 uint32_t DoesOtrFileExist();
+void GetFramePacingStats(uint32_t metric, struct GfxPacingStats* stats);
+void ResetFramePacingStats();
 
 #ifdef __cplusplus
 };
@@ -0,0 +1,53 @@
+#include "libultraship/libultraship.h"
+
+#include <mutex>
+#include "misc/Hooks.h"
+
+// Events registered with osSetEventMesg are posted from the renderer: SP and DP once gfx_run has processed a task,
+// VI once a frame was swapped to the screen.
+
+struct EventMesg {
+    OSMesgQueue* Queue;
+    OSMesg Msg;
+};
+
+static std::mutex sEventsMutex;
+static EventMesg sEvents[OS_NUM_EVENTS];
+
+extern "C" int32_t osSendMesg(OSMesgQueue* mq, OSMesg msg, int32_t flag);
+
+static void PostEvent(OSEvent e) {
+    EventMesg event;
+    {
+        const std::lock_guard<std::mutex> lock(sEventsMutex);
+        event = sEvents[e];
+    }
+
+    if (event.Queue != nullptr) {
+        osSendMesg(event.Queue, event.Msg, OS_MESG_NOBLOCK);
+    }
+}
+
+extern "C" {
+void osSetEventMesg(OSEvent e, OSMesgQueue* mq, OSMesg msg) {
+    if (e >= OS_NUM_EVENTS) {
+        return;
+    }
+
+    static bool sHooksRegistered = false;
+    {
+        const std::lock_guard<std::mutex> lock(sEventsMutex);
+        sEvents[e] = { mq, msg };
+        if (sHooksRegistered) {
+            return;
+        }
+        sHooksRegistered = true;
+    }
+
+    Ship::RegisterHook<Ship::GfxTaskDone>([]() {
+        PostEvent(OS_EVENT_SP);
+        PostEvent(OS_EVENT_DP);
+    });
+    Ship::RegisterHook<Ship::GfxFrameEnd>([]() { PostEvent(OS_EVENT_VI); });
+}
+}
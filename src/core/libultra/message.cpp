@@ -0,0 +1,103 @@
+#include "libultraship/libultra/message.h"
+#include "os.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+// OSMesgQueue keeps its libultra layout since games read validCount directly, so the locks live in a table indexed by
+// the queue address instead. Queues sharing an entry only cost each other a spurious wake up.
+#define MESG_QUEUE_LOCK_COUNT 64
+
+struct MesgQueueLock {
+    std::mutex Mutex;
+    std::condition_variable NotEmpty;
+    std::condition_variable NotFull;
+};
+
+static MesgQueueLock sMesgQueueLocks[MESG_QUEUE_LOCK_COUNT];
+// Off by default: games that poll with OS_MESG_BLOCK on a single thread relied on it returning -1 and would hang
+static std::atomic<bool> sMesgQueueBlocking = false;
+
+static MesgQueueLock& GetMesgQueueLock(OSMesgQueue* mq) {
+    return sMesgQueueLocks[((uintptr_t)mq / sizeof(OSMesgQueue)) % MESG_QUEUE_LOCK_COUNT];
+}
+
+extern "C" {
+void osSetMesgQueueBlocking(int32_t enabled) {
+    sMesgQueueBlocking = enabled != 0;
+}
+
+int32_t osGetMesgQueueBlocking(void) {
+    return sMesgQueueBlocking;
+}
+
+void osCreateMesgQueue(OSMesgQueue* mq, OSMesg* msgBuf, int32_t count) {
+    MesgQueueLock& lock = GetMesgQueueLock(mq);
+    const std::lock_guard<std::mutex> guard(lock.Mutex);
+    mq->mtqueue = nullptr;
+    mq->fullqueue = nullptr;
+    mq->validCount = 0;
+    mq->first = 0;
+    mq->msgCount = count;
+    mq->msg = msgBuf;
+    return;
+}
+
+int32_t osSendMesg(OSMesgQueue* mq, OSMesg msg, int32_t flag) {
+    MesgQueueLock& lock = GetMesgQueueLock(mq);
+    std::unique_lock<std::mutex> guard(lock.Mutex);
+    if (flag == OS_MESG_BLOCK && sMesgQueueBlocking) {
+        lock.NotFull.wait(guard, [mq] { return mq->validCount < mq->msgCount; });
+    } else if (mq->validCount >= mq->msgCount) {
+        return -1;
+    }
+
+    int32_t index = (mq->first + mq->validCount) % mq->msgCount;
+    mq->msg[index] = msg;
+    mq->validCount++;
+    guard.unlock();
+
+    lock.NotEmpty.notify_all();
+    return 0;
+}
+
+int32_t osJamMesg(OSMesgQueue* mq, OSMesg msg, int32_t flag) {
+    MesgQueueLock& lock = GetMesgQueueLock(mq);
+    std::unique_lock<std::mutex> guard(lock.Mutex);
+    if (flag == OS_MESG_BLOCK && sMesgQueueBlocking) {
+        lock.NotFull.wait(guard, [mq] { return mq->validCount < mq->msgCount; });
+    } else if (mq->validCount >= mq->msgCount) {
+        return -1;
+    }
+
+    // Goes in front of the queued messages
+    mq->first = (mq->first + mq->msgCount - 1) % mq->msgCount;
+    mq->msg[mq->first] = msg;
+    mq->validCount++;
+    guard.unlock();
+
+    lock.NotEmpty.notify_all();
+    return 0;
+}
+
+int32_t osRecvMesg(OSMesgQueue* mq, OSMesg* msg, int32_t flag) {
+    MesgQueueLock& lock = GetMesgQueueLock(mq);
+    std::unique_lock<std::mutex> guard(lock.Mutex);
+    if (flag == OS_MESG_BLOCK && sMesgQueueBlocking) {
+        lock.NotEmpty.wait(guard, [mq] { return mq->validCount > 0; });
+    } else if (mq->validCount == 0) {
+        return -1;
+    }
+
+    if (msg != NULL) {
+        *msg = *(mq->first + mq->msg);
+    }
+    mq->first = (mq->first + 1) % mq->msgCount;
+    mq->validCount--;
+    guard.unlock();
+
+    lock.NotFull.notify_all();
+    return 0;
+}
+}
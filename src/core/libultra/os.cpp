@@ -1,4 +1,5 @@
 #include "libultraship/libultraship.h"
+#include "os.h"
 
 #include "core/Window.h"
 
@@ -7,8 +8,11 @@
 
 #include "menu/ImGuiImpl.h"
 #include "misc/Hooks.h"
+#include "debug/TraceEvents.h"
 
 extern "C" {
+int32_t osSendMesg(OSMesgQueue* mq, OSMesg msg, int32_t flag);
+
 uint8_t __osMaxControllers = MAXCONTROLLERS;
 
 int32_t osContInit(OSMesgQueue* mq, uint8_t* controllerBits, OSContStatus* status) {
@@ -37,10 +41,17 @@ int32_t osContInit(OSMesgQueue* mq, uint8_t* controllerBits, OSContStatus* statu
 }
 
 int32_t osContStartReadData(OSMesgQueue* mesg) {
+    // The read completes immediately, post the SI message a game waits on before osContGetReadData
+    if (mesg != nullptr && osGetMesgQueueBlocking()) {
+        OSMesg msg;
+        msg.ptr = nullptr;
+        osSendMesg(mesg, msg, OS_MESG_NOBLOCK);
+    }
     return 0;
 }
 
 void osContGetReadData(OSContPad* pad) {
+    LUS_TRACE_SPAN("osContGetReadData", "input");
     memset(pad, 0, sizeof(OSContPad) * __osMaxControllers);
 
     if (SohImGui::GetInputEditor()->IsOpened()) {
@@ -59,35 +70,4 @@ uint32_t osGetCount(void) {
     return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch())
         .count();
 }
-
-void osCreateMesgQueue(OSMesgQueue* mq, OSMesg* msgBuf, int32_t count) {
-    mq->validCount = 0;
-    mq->first = 0;
-    mq->msgCount = count;
-    mq->msg = msgBuf;
-    return;
-}
-
-int32_t osSendMesg(OSMesgQueue* mq, OSMesg msg, int32_t flag) {
-    int32_t index;
-    if (mq->validCount >= mq->msgCount) {
-        return -1;
-    }
-    index = (mq->first + mq->validCount) % mq->msgCount;
-    mq->msg[index] = msg;
-    mq->validCount++;
-    return 0;
-}
-
-int32_t osRecvMesg(OSMesgQueue* mq, OSMesg* msg, int32_t flag) {
-    if (mq->validCount == 0) {
-        return -1;
-    }
-    if (msg != NULL) {
-        *msg = *(mq->first + mq->msg);
-    }
-    mq->first = (mq->first + 1) % mq->msgCount;
-    mq->validCount--;
-    return 0;
 }
-}
\ No newline at end of file
@@ -4,8 +4,8 @@
 #define OS_H
 
 #include "stdint.h"
-#include "libultra/controller.h"
-#include "libultra/message.h"
+#include "libultraship/libultra/controller.h"
+#include "libultraship/libultra/message.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,6 +18,12 @@ void osContGetReadData(OSContPad* pad);
 uint64_t osGetTime(void);
 uint32_t osGetCount(void);
 
+// By default OS_MESG_BLOCK behaves like OS_MESG_NOBLOCK and a full or empty queue returns -1 right away. Games that send
+// and receive on different threads need blocking to wait like libultra does. osStartThread turns it on, so games using
+// the emulated threads get it without calling this, others can enable it themselves.
+void osSetMesgQueueBlocking(int32_t enabled);
+int32_t osGetMesgQueueBlocking(void);
+
 #ifdef __cplusplus
 };
 #endif
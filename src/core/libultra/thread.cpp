@@ -0,0 +1,187 @@
+#include "libultraship/libultraship.h"
+#include "os.h"
+
+#include <SDL2/SDL.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// Every started OSThread runs on a host thread of its own. libultra threads spend their lives blocked on message
+// queues, so they can't share workers without a cooperative scheduler. Priorities map onto the host scheduler and only
+// order threads relative to the rest of the system, not strictly against each other like on the N64.
+//
+// Threads talk through message queues with OS_MESG_BLOCK, which only waits once blocking is on. Blocking is off by
+// default for games that poll on a single thread, so starting the first thread turns it on. Without it a thread
+// waiting for a message would spin on -1 instead of sleeping until another thread sends.
+
+struct HostThread {
+    std::mutex Mutex;
+    std::condition_variable Resume;
+    void (*Entry)(void*);
+    void* Arg;
+    bool Started = false;
+    bool Stopped = false;
+};
+
+static std::mutex sThreadsMutex;
+static std::unordered_map<OSThread*, std::shared_ptr<HostThread>> sThreads;
+static thread_local OSThread* tCurrentThread = nullptr;
+
+static std::shared_ptr<HostThread> GetHostThread(OSThread* t) {
+    const std::lock_guard<std::mutex> lock(sThreadsMutex);
+    auto it = sThreads.find(t);
+    return it != sThreads.end() ? it->second : nullptr;
+}
+
+static void ApplyPriority(OSPri pri) {
+    SDL_ThreadPriority priority = SDL_THREAD_PRIORITY_NORMAL;
+    if (pri > OS_PRIORITY_APPMAX) {
+        // The VI, PI and SI managers, which the game threads wait on
+        priority = SDL_THREAD_PRIORITY_HIGH;
+    } else if (pri == OS_PRIORITY_IDLE) {
+        priority = SDL_THREAD_PRIORITY_LOW;
+    }
+
+    SDL_SetThreadPriority(priority);
+}
+
+// Parks the calling thread while it is stopped. Called from the points where a thread gives up the CPU.
+static void WaitWhileStopped(OSThread* t, HostThread* host) {
+    std::unique_lock<std::mutex> lock(host->Mutex);
+    if (!host->Stopped) {
+        return;
+    }
+
+    t->state = OS_STATE_STOPPED;
+    host->Resume.wait(lock, [host] { return !host->Stopped; });
+    t->state = OS_STATE_RUNNING;
+}
+
+static void ThreadMain(OSThread* t, std::shared_ptr<HostThread> host) {
+    tCurrentThread = t;
+    ApplyPriority(t->priority);
+
+    t->state = OS_STATE_RUNNING;
+    host->Entry(host->Arg);
+
+    const std::lock_guard<std::mutex> lock(host->Mutex);
+    host->Started = false;
+    t->state = OS_STATE_STOPPED;
+}
+
+extern "C" {
+void osCreateThread(OSThread* t, OSId id, void (*entry)(void*), void* arg, void* sp, OSPri pri) {
+    auto host = std::make_shared<HostThread>();
+    host->Entry = entry;
+    host->Arg = arg;
+
+    t->next = nullptr;
+    t->queue = nullptr;
+    t->tlnext = nullptr;
+    t->priority = pri;
+    t->id = id;
+    t->flags = 0;
+    t->state = OS_STATE_STOPPED;
+
+    // A thread still running on the old entry keeps its own reference
+    const std::lock_guard<std::mutex> lock(sThreadsMutex);
+    sThreads[t] = host;
+}
+
+void osStartThread(OSThread* t) {
+    auto host = GetHostThread(t);
+    if (host == nullptr) {
+        return;
+    }
+
+    osSetMesgQueueBlocking(1);
+
+    const std::lock_guard<std::mutex> lock(host->Mutex);
+    if (!host->Started) {
+        host->Started = true;
+        host->Stopped = false;
+        t->state = OS_STATE_RUNNABLE;
+        // Never joined, a libultra thread lives until the game exits
+        std::thread(ThreadMain, t, host).detach();
+    } else if (host->Stopped) {
+        host->Stopped = false;
+        t->state = OS_STATE_RUNNABLE;
+        host->Resume.notify_all();
+    }
+}
+
+void osStopThread(OSThread* t) {
+    if (t == nullptr) {
+        t = tCurrentThread;
+    }
+    auto host = GetHostThread(t);
+    if (host == nullptr) {
+        return;
+    }
+
+    {
+        const std::lock_guard<std::mutex> lock(host->Mutex);
+        host->Stopped = true;
+    }
+
+    // Another thread can't be suspended from outside, it stops at its next osYieldThread
+    if (t == tCurrentThread) {
+        WaitWhileStopped(t, host.get());
+    }
+}
+
+void osDestroyThread(OSThread* t) {
+    if (t == nullptr) {
+        t = tCurrentThread;
+    }
+
+    // Host threads can't be ended from outside either, a destroyed thread stays stopped until the game exits
+    osStopThread(t);
+}
+
+void osYieldThread(void) {
+    if (tCurrentThread != nullptr) {
+        auto host = GetHostThread(tCurrentThread);
+        if (host != nullptr) {
+            WaitWhileStopped(tCurrentThread, host.get());
+        }
+    }
+
+    std::this_thread::yield();
+}
+
+void osSetThreadPri(OSThread* t, OSPri pri) {
+    if (t == nullptr) {
+        t = tCurrentThread;
+    }
+    if (t == nullptr) {
+        // The thread the game booted on isn't an OSThread, only its host priority changes
+        ApplyPriority(pri);
+        return;
+    }
+
+    t->priority = pri;
+    // The host scheduler only lets a thread change its own priority, others pick it up when they start
+    if (t == tCurrentThread) {
+        ApplyPriority(pri);
+    }
+}
+
+OSPri osGetThreadPri(OSThread* t) {
+    if (t == nullptr) {
+        t = tCurrentThread;
+    }
+
+    return t != nullptr ? t->priority : OS_PRIORITY_APPMAX;
+}
+
+OSId osGetThreadId(OSThread* t) {
+    if (t == nullptr) {
+        t = tCurrentThread;
+    }
+
+    return t != nullptr ? t->id : 0;
+}
+}
@@ -0,0 +1,119 @@
+#include "libultraship/libultraship.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// One host thread fires every OSTimer. Pending timers are kept ordered by deadline, the thread sleeps until the
+// earliest one and sends its message without blocking, like the libultra timer interrupt does.
+
+typedef std::chrono::steady_clock TimerClock;
+
+struct TimerState {
+    std::mutex Mutex;
+    std::condition_variable Wake;
+    std::multimap<TimerClock::time_point, OSTimer*> Deadlines;
+    std::unordered_map<OSTimer*, std::multimap<TimerClock::time_point, OSTimer*>::iterator> Active;
+    std::thread Thread;
+    bool Stopping = false;
+
+    ~TimerState() {
+        if (Thread.joinable()) {
+            {
+                const std::lock_guard<std::mutex> lock(Mutex);
+                Stopping = true;
+            }
+            Wake.notify_all();
+            Thread.join();
+        }
+    }
+};
+
+static TimerState sTimers;
+
+extern "C" int32_t osSendMesg(OSMesgQueue* mq, OSMesg msg, int32_t flag);
+
+static TimerClock::duration CyclesToDuration(OSTime cycles) {
+    return std::chrono::nanoseconds(OS_CYCLES_TO_NSEC(cycles));
+}
+
+static void Schedule(OSTimer* t, TimerClock::time_point deadline) {
+    sTimers.Active[t] = sTimers.Deadlines.emplace(deadline, t);
+}
+
+static void TimerThreadMain() {
+    std::unique_lock<std::mutex> lock(sTimers.Mutex);
+    while (!sTimers.Stopping) {
+        if (sTimers.Deadlines.empty()) {
+            sTimers.Wake.wait(lock);
+            continue;
+        }
+
+        auto next = sTimers.Deadlines.begin();
+        if (TimerClock::now() < next->first) {
+            sTimers.Wake.wait_until(lock, next->first);
+            continue;
+        }
+
+        OSTimer* t = next->second;
+        const TimerClock::time_point deadline = next->first;
+        sTimers.Deadlines.erase(next);
+        sTimers.Active.erase(t);
+
+        // Periodic timers are rescheduled from their deadline so they don't drift
+        if (t->interval != 0) {
+            Schedule(t, deadline + CyclesToDuration(t->interval));
+        }
+
+        OSMesgQueue* mq = t->mq;
+        OSMesg msg = t->msg;
+        lock.unlock();
+        if (mq != nullptr) {
+            osSendMesg(mq, msg, OS_MESG_NOBLOCK);
+        }
+        lock.lock();
+    }
+}
+
+extern "C" {
+int32_t osSetTimer(OSTimer* t, OSTime countdown, OSTime interval, OSMesgQueue* mq, OSMesg msg) {
+    t->next = nullptr;
+    t->prev = nullptr;
+    t->interval = interval;
+    t->value = countdown != 0 ? countdown : interval;
+    t->mq = mq;
+    t->msg = msg;
+
+    {
+        const std::lock_guard<std::mutex> lock(sTimers.Mutex);
+        if (!sTimers.Thread.joinable()) {
+            sTimers.Thread = std::thread(TimerThreadMain);
+        }
+
+        auto active = sTimers.Active.find(t);
+        if (active != sTimers.Active.end()) {
+            sTimers.Deadlines.erase(active->second);
+            sTimers.Active.erase(active);
+        }
+        Schedule(t, TimerClock::now() + CyclesToDuration(t->value));
+    }
+
+    sTimers.Wake.notify_all();
+    return 0;
+}
+
+int32_t osStopTimer(OSTimer* t) {
+    const std::lock_guard<std::mutex> lock(sTimers.Mutex);
+    auto active = sTimers.Active.find(t);
+    if (active == sTimers.Active.end()) {
+        return -1;
+    }
+
+    sTimers.Deadlines.erase(active->second);
+    sTimers.Active.erase(active);
+    return 0;
+}
+}
@@ -0,0 +1,149 @@
+#ifdef LUS_TRACE_EVENTS
+
+#include "TraceEvents.h"
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <spdlog/spdlog.h>
+
+// Bounds the memory of a recording left running, later spans of that thread are dropped
+#define TRACE_EVENTS_MAX_PER_THREAD (1 << 20)
+
+namespace Ship {
+struct TraceEvent {
+    const char* Name;
+    const char* Category;
+    std::string Detail;
+    uint64_t Start;
+    uint64_t Duration;
+};
+
+// Only its own thread appends, the mutex is there for start and save which run on the console thread
+struct TraceThread {
+    std::mutex Mutex;
+    uint32_t Tid;
+    std::vector<TraceEvent> Events;
+};
+
+static std::atomic<bool> sRecording = false;
+static std::mutex sThreadsMutex;
+static std::vector<std::shared_ptr<TraceThread>> sThreads;
+
+static uint64_t NowMicroseconds() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static TraceThread* GetTraceThread() {
+    static thread_local std::shared_ptr<TraceThread> tThread;
+    if (tThread == nullptr) {
+        tThread = std::make_shared<TraceThread>();
+        const std::lock_guard<std::mutex> lock(sThreadsMutex);
+        tThread->Tid = sThreads.size() + 1;
+        sThreads.push_back(tThread);
+    }
+
+    return tThread.get();
+}
+
+TraceSpan::TraceSpan(const char* name, const char* category)
+    : mName(name), mCategory(category), mRecording(sRecording.load(std::memory_order_relaxed)) {
+    mStart = mRecording ? NowMicroseconds() : 0;
+}
+
+TraceSpan::TraceSpan(const char* name, const char* category, const std::string& detail)
+    : mName(name), mCategory(category), mRecording(sRecording.load(std::memory_order_relaxed)) {
+    if (mRecording) {
+        mDetail = detail;
+        mStart = NowMicroseconds();
+    } else {
+        mStart = 0;
+    }
+}
+
+TraceSpan::~TraceSpan() {
+    if (!mRecording || !sRecording.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const uint64_t end = NowMicroseconds();
+    TraceThread* thread = GetTraceThread();
+    const std::lock_guard<std::mutex> lock(thread->Mutex);
+    if (thread->Events.size() < TRACE_EVENTS_MAX_PER_THREAD) {
+        thread->Events.push_back({ mName, mCategory, std::move(mDetail), mStart, end - mStart });
+    }
+}
+
+void TraceEventsStart(void) {
+    const std::lock_guard<std::mutex> lock(sThreadsMutex);
+    for (const auto& thread : sThreads) {
+        const std::lock_guard<std::mutex> threadLock(thread->Mutex);
+        thread->Events.clear();
+    }
+    sRecording = true;
+}
+
+void TraceEventsStop(void) {
+    sRecording = false;
+}
+
+bool TraceEventsIsRecording(void) {
+    return sRecording;
+}
+
+static void WriteJsonString(std::ofstream& out, const char* str) {
+    out << '"';
+    for (; *str != '\0'; str++) {
+        const unsigned char c = *str;
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (c < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+bool TraceEventsSave(const std::string& path) {
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        SPDLOG_ERROR("Could not open trace file {}", path);
+        return false;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+
+    const std::lock_guard<std::mutex> lock(sThreadsMutex);
+    for (const auto& thread : sThreads) {
+        const std::lock_guard<std::mutex> threadLock(thread->Mutex);
+        for (const auto& event : thread->Events) {
+            out << (first ? "\n" : ",\n") << "{\"ph\":\"X\",\"pid\":1,\"tid\":" << thread->Tid
+                << ",\"ts\":" << event.Start << ",\"dur\":" << event.Duration << ",\"name\":";
+            WriteJsonString(out, event.Name);
+            out << ",\"cat\":";
+            WriteJsonString(out, event.Category);
+            if (!event.Detail.empty()) {
+                out << ",\"args\":{\"detail\":";
+                WriteJsonString(out, event.Detail.c_str());
+                out << "}";
+            }
+            out << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+
+    return out.good();
+}
+} // namespace Ship
+
+#endif
@@ -0,0 +1,50 @@
+#pragma once
+
+// Scoped spans for looking at frame, resource and I/O timing on one timeline. Spans are only compiled in when the
+// library is built with LUS_TRACE_EVENTS, otherwise the macros expand to nothing. Recording is started with the
+// trace_start console command and written as Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev) with
+// trace_save.
+
+#ifdef LUS_TRACE_EVENTS
+
+#include <stdint.h>
+#include <string>
+
+namespace Ship {
+class TraceSpan {
+  public:
+    // Name and category must be string literals, they are stored as pointers
+    TraceSpan(const char* name, const char* category);
+    TraceSpan(const char* name, const char* category, const std::string& detail);
+    ~TraceSpan();
+
+  private:
+    const char* mName;
+    const char* mCategory;
+    std::string mDetail;
+    uint64_t mStart;
+    bool mRecording;
+};
+
+void TraceEventsStart(void);
+void TraceEventsStop(void);
+bool TraceEventsIsRecording(void);
+// Writes every span recorded since the last start
+bool TraceEventsSave(const std::string& path);
+void TraceEventsRegisterCommands(void);
+} // namespace Ship
+
+#define LUS_TRACE_CONCAT_INNER(a, b) a##b
+#define LUS_TRACE_CONCAT(a, b) LUS_TRACE_CONCAT_INNER(a, b)
+#define LUS_TRACE_SPAN(name, category) Ship::TraceSpan LUS_TRACE_CONCAT(traceSpan, __LINE__)(name, category)
+#define LUS_TRACE_SPAN_DETAIL(name, category, detail) \
+    Ship::TraceSpan LUS_TRACE_CONCAT(traceSpan, __LINE__)(name, category, detail)
+#define LUS_TRACE_REGISTER_COMMANDS() Ship::TraceEventsRegisterCommands()
+
+#else
+
+#define LUS_TRACE_SPAN(name, category)
+#define LUS_TRACE_SPAN_DETAIL(name, category, detail)
+#define LUS_TRACE_REGISTER_COMMANDS()
+
+#endif
@@ -0,0 +1,35 @@
+#ifdef LUS_TRACE_EVENTS
+
+#include "TraceEvents.h"
+#include "menu/ImGuiImpl.h"
+#include "menu/Console.h"
+
+namespace Ship {
+static bool TraceStartCommand(std::shared_ptr<Console> console, const std::vector<std::string>& args) {
+    TraceEventsStart();
+    return CMD_SUCCESS;
+}
+
+static bool TraceSaveCommand(std::shared_ptr<Console> console, const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        return CMD_FAILED;
+    }
+
+    TraceEventsStop();
+    if (!TraceEventsSave(args[1])) {
+        return CMD_FAILED;
+    }
+
+    console->SendInfoMessage("Saved trace to %s", args[1].c_str());
+    return CMD_SUCCESS;
+}
+
+void TraceEventsRegisterCommands(void) {
+    SohImGui::GetConsole()->AddCommand("trace_start", { TraceStartCommand, "Start recording trace spans" });
+    SohImGui::GetConsole()->AddCommand("trace_save", { TraceSaveCommand,
+                                                       "Stop recording and save the spans as Chrome trace JSON",
+                                                       { { "file", ArgumentType::TEXT } } });
+}
+} // namespace Ship
+
+#endif
@@ -45,6 +45,8 @@ enum {
 #define SHADER_OPT_TEXEL0_CLAMP_T (1 << 9)
 #define SHADER_OPT_TEXEL1_CLAMP_S (1 << 10)
 #define SHADER_OPT_TEXEL1_CLAMP_T (1 << 11)
+#define SHADER_OPT_TEXEL0_ATLAS (1 << 12)
+#define SHADER_OPT_TEXEL1_ATLAS (1 << 13)
 #define CC_SHADER_OPT_POS 56
 
 struct CCFeatures {
@@ -59,6 +61,7 @@ struct CCFeatures {
     bool opt_grayscale;
     bool used_textures[2];
     bool clamp[2][2];
+    bool atlas[2];
     int num_inputs;
     bool do_single[2][2];
     bool do_multiply[2][2];
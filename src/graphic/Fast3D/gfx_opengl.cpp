@@ -289,8 +289,8 @@ static struct ShaderProgram* gfx_opengl_create_and_load_new_shader(uint64_t shad
     struct CCFeatures cc_features;
     gfx_cc_get_features(shader_id0, shader_id1, &cc_features);
 
-    char vs_buf[1024];
-    char fs_buf[3000];
+    char vs_buf[1536];
+    char fs_buf[4096];
     size_t vs_len = 0;
     size_t fs_len = 0;
     size_t num_floats = 4;
@@ -330,6 +330,23 @@ static struct ShaderProgram* gfx_opengl_create_and_load_new_shader(uint64_t shad
 #endif
     for (int i = 0; i < 2; i++) {
         if (cc_features.used_textures[i]) {
+#ifndef __vita__
+            if (cc_features.atlas[i]) {
+                // Atlas textures carry the clamp values next to the coordinates, and the cell rectangle with the wrap
+                // modes folded into the integer part of its origin, to stay within the vertex attribute limit.
+#ifdef __APPLE__
+                vs_len += sprintf(vs_buf + vs_len, "in vec4 aTexCoord%d;\nin vec4 aAtlasRect%d;\n", i, i);
+                vs_len += sprintf(vs_buf + vs_len, "out vec2 vTexCoord%d;\nout vec2 vTexClamp%d;\n", i, i);
+                vs_len += sprintf(vs_buf + vs_len, "out vec4 vAtlasRect%d;\n", i);
+#else
+                vs_len += sprintf(vs_buf + vs_len, "attribute vec4 aTexCoord%d;\nattribute vec4 aAtlasRect%d;\n", i, i);
+                vs_len += sprintf(vs_buf + vs_len, "varying vec2 vTexCoord%d;\nvarying vec2 vTexClamp%d;\n", i, i);
+                vs_len += sprintf(vs_buf + vs_len, "varying vec4 vAtlasRect%d;\n", i);
+#endif
+                num_floats += 8;
+                continue;
+            }
+#endif
 #ifdef __APPLE__
             vs_len += sprintf(vs_buf + vs_len, "in vec2 aTexCoord%d;\n", i);
             vs_len += sprintf(vs_buf + vs_len, "out vec2 vTexCoord%d;\n", i);
@@ -406,6 +423,12 @@ static struct ShaderProgram* gfx_opengl_create_and_load_new_shader(uint64_t shad
 #endif
     for (int i = 0; i < 2; i++) {
         if (cc_features.used_textures[i]) {
+            if (cc_features.atlas[i]) {
+                vs_len += sprintf(vs_buf + vs_len, "vTexCoord%d = aTexCoord%d.xy;\nvTexClamp%d = aTexCoord%d.zw;\n", i,
+                                  i, i, i);
+                vs_len += sprintf(vs_buf + vs_len, "vAtlasRect%d = aAtlasRect%d;\n", i, i);
+                continue;
+            }
             vs_len += sprintf(vs_buf + vs_len, "vTexCoord%d = aTexCoord%d;\n", i, i);
             for (int j = 0; j < 2; j++) {
                 if (cc_features.clamp[i][j]) {
@@ -467,6 +490,18 @@ static struct ShaderProgram* gfx_opengl_create_and_load_new_shader(uint64_t shad
     // append_line(fs_buf, &fs_len, "precision mediump float;");
     for (int i = 0; i < 2; i++) {
         if (cc_features.used_textures[i]) {
+#ifndef __vita__
+            if (cc_features.atlas[i]) {
+#ifdef __APPLE__
+                fs_len += sprintf(fs_buf + fs_len, "in vec2 vTexCoord%d;\nin vec2 vTexClamp%d;\n", i, i);
+                fs_len += sprintf(fs_buf + fs_len, "in vec4 vAtlasRect%d;\n", i);
+#else
+                fs_len += sprintf(fs_buf + fs_len, "varying vec2 vTexCoord%d;\nvarying vec2 vTexClamp%d;\n", i, i);
+                fs_len += sprintf(fs_buf + fs_len, "varying vec4 vAtlasRect%d;\n", i);
+#endif
+                continue;
+            }
+#endif
 #ifdef __APPLE__
             fs_len += sprintf(fs_buf + fs_len, "in vec2 vTexCoord%d;\n", i);
 #elif defined(__vita__)
@@ -568,6 +603,17 @@ static struct ShaderProgram* gfx_opengl_create_and_load_new_shader(uint64_t shad
 #endif
         append_line(fs_buf, &fs_len, "}");
     }
+
+    if (cc_features.atlas[0] || cc_features.atlas[1]) {
+        // Applies the wrap mode inside the cell (0 = wrap, 1 = mirror, 2 = clamp) and maps the result into the page
+        append_line(fs_buf, &fs_len, "vec2 atlasCoord(in vec2 uv, in vec4 rect) {");
+        append_line(fs_buf, &fs_len, "    vec2 mode = floor(rect.xy / 2.0);");
+        append_line(fs_buf, &fs_len, "    vec2 mirrored = 1.0 - abs(mod(uv, 2.0) - 1.0);");
+        append_line(fs_buf, &fs_len, "    vec2 local = mix(fract(uv), mirrored, step(0.5, mode));");
+        append_line(fs_buf, &fs_len, "    local = mix(local, clamp(uv, 0.0, 1.0), step(1.5, mode));");
+        append_line(fs_buf, &fs_len, "    return rect.xy - mode * 2.0 + local * rect.zw;");
+        append_line(fs_buf, &fs_len, "}");
+    }
 #endif
 #if __APPLE__
     append_line(fs_buf, &fs_len, "out vec4 outColor;");
@@ -576,7 +622,7 @@ static struct ShaderProgram* gfx_opengl_create_and_load_new_shader(uint64_t shad
     append_line(fs_buf, &fs_len, "float4 gl_FragCoord : WPOS) {");
 #else
     append_line(fs_buf, &fs_len, "void main() {");
-#edif
+#endif
     // Reference approach to color wrapping as per GLideN64
     // Return wrapped value of x in interval [low, high)
 #ifdef __vita__
@@ -600,6 +646,28 @@ static struct ShaderProgram* gfx_opengl_create_and_load_new_shader(uint64_t shad
 #else
             fs_len += sprintf(fs_buf + fs_len, "vec2 texSize%d = textureSize(uTex%d, 0);\n", i, i);
 
+            if (cc_features.atlas[i]) {
+                // The clamp is done in texture space with the size of the cell, the wrap inside the cell afterwards
+                fs_len += sprintf(fs_buf + fs_len, "vec2 texCoord%d = vTexCoord%d;\n", i, i);
+                if (s) {
+                    fs_len += sprintf(fs_buf + fs_len,
+                                      "texCoord%d.s = clamp(texCoord%d.s, 0.5 / (texSize%d.s * vAtlasRect%d.z), "
+                                      "vTexClamp%d.x);\n",
+                                      i, i, i, i, i);
+                }
+                if (t) {
+                    fs_len += sprintf(fs_buf + fs_len,
+                                      "texCoord%d.t = clamp(texCoord%d.t, 0.5 / (texSize%d.t * vAtlasRect%d.w), "
+                                      "vTexClamp%d.y);\n",
+                                      i, i, i, i, i);
+                }
+                fs_len += sprintf(fs_buf + fs_len,
+                                  "vec4 texVal%d = hookTexture2D(uTex%d, atlasCoord(texCoord%d, vAtlasRect%d), "
+                                  "texSize%d);\n",
+                                  i, i, i, i, i);
+                continue;
+            }
+
             if (!s && !t) {
                 fs_len += sprintf(fs_buf + fs_len, "vec4 texVal%d = hookTexture2D(uTex%d, vTexCoord%d, texSize%d);\n",
                                   i, i, i, i);
@@ -833,9 +901,17 @@ static struct ShaderProgram* gfx_opengl_create_and_load_new_shader(uint64_t shad
             char name[32];
             sprintf(name, "aTexCoord%d", i);
             prg->attrib_locations[cnt] = glGetAttribLocation(shader_program, name);
-            prg->attrib_sizes[cnt] = 2;
+            prg->attrib_sizes[cnt] = cc_features.atlas[i] ? 4 : 2;
             ++cnt;
 
+            if (cc_features.atlas[i]) {
+                sprintf(name, "aAtlasRect%d", i);
+                prg->attrib_locations[cnt] = glGetAttribLocation(shader_program, name);
+                prg->attrib_sizes[cnt] = 4;
+                ++cnt;
+                continue;
+            }
+
             for (int j = 0; j < 2; j++) {
                 if (cc_features.clamp[i][j]) {
                     sprintf(name, "aTexClamp%s%d", j == 0 ? "S" : "T", i);
@@ -948,6 +1024,13 @@ static void gfx_opengl_upload_texture(const uint8_t* rgba32_buf, uint32_t width,
 #endif
 }
 
+#ifndef __vita__
+static void gfx_opengl_upload_texture_region(const uint8_t* rgba32_buf, uint32_t x, uint32_t y, uint32_t width,
+                                             uint32_t height) {
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba32_buf);
+}
+#endif
+
 #if defined(__SWITCH__) || defined(__vita__)
 #define GL_MIRROR_CLAMP_TO_EDGE 0x8743
 #endif
@@ -1340,6 +1423,11 @@ struct GfxRenderingAPI gfx_opengl_api = { gfx_opengl_get_name,
                                           gfx_opengl_select_texture_fb,
                                           gfx_opengl_delete_texture,
                                           gfx_opengl_set_texture_filter,
-                                          gfx_opengl_get_texture_filter };
+                                          gfx_opengl_get_texture_filter,
+#ifdef __vita__
+                                          nullptr };
+#else
+                                          gfx_opengl_upload_texture_region };
+#endif
 
 #endif
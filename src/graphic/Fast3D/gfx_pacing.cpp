@@ -0,0 +1,175 @@
+#include "gfx_pacing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+// The spin margin is how early we wake up from the coarse sleep before the deadline. It starts conservative and is
+// adjusted from the measured wake-up overshoot of every sleep.
+#define SPIN_MARGIN_INITIAL_NS 2000000
+#define SPIN_MARGIN_MIN_NS 100000
+#define SPIN_MARGIN_MAX_NS 4000000
+#define SPIN_MARGIN_SAFETY_NS 50000
+// A wake-up later than this past the deadline counts as a missed frame and the schedule is rebased on the current time.
+#define MISSED_FRAME_TOLERANCE_NS 1000000
+
+struct PacingHistogram {
+    uint64_t buckets[GFX_PACING_HISTOGRAM_BUCKETS];
+    uint64_t count;
+    uint64_t sum_ns;
+    uint64_t min_ns;
+    uint64_t max_ns;
+};
+
+static uint64_t default_now_ns(void* user) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static void default_sleep_ns(void* user, uint64_t duration_ns) {
+    std::this_thread::sleep_for(std::chrono::nanoseconds(duration_ns));
+}
+
+static struct GfxPacingClock pacing_clock = { default_now_ns, default_sleep_ns, nullptr };
+static int target_fps = 60;
+static uint64_t previous_deadline;
+static uint64_t frame_start;
+static uint64_t present_start;
+// Only the pacing thread writes it, gfx_pacing_get_stats reads it from any thread
+static std::atomic<uint64_t> spin_margin_ns = SPIN_MARGIN_INITIAL_NS;
+
+static std::mutex stats_mutex;
+static struct PacingHistogram histograms[GFX_PACING_METRIC_COUNT];
+
+static void histogram_record(enum GfxPacingMetric metric, uint64_t value_ns) {
+    const std::lock_guard<std::mutex> lock(stats_mutex);
+    struct PacingHistogram* h = &histograms[metric];
+
+    size_t bucket = std::min<uint64_t>(value_ns / GFX_PACING_HISTOGRAM_BUCKET_NS, GFX_PACING_HISTOGRAM_BUCKETS - 1);
+    h->buckets[bucket]++;
+    h->min_ns = h->count == 0 ? value_ns : std::min(h->min_ns, value_ns);
+    h->max_ns = std::max(h->max_ns, value_ns);
+    h->sum_ns += value_ns;
+    h->count++;
+}
+
+static uint64_t histogram_percentile(const struct PacingHistogram* h, uint64_t per_mille) {
+    if (h->count == 0) {
+        return 0;
+    }
+
+    uint64_t target = (h->count * per_mille + 999) / 1000;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < GFX_PACING_HISTOGRAM_BUCKETS; i++) {
+        seen += h->buckets[i];
+        if (seen >= target) {
+            // Report the upper edge of the bucket, clamped to what was actually observed.
+            return std::min<uint64_t>((i + 1) * GFX_PACING_HISTOGRAM_BUCKET_NS, h->max_ns);
+        }
+    }
+
+    return h->max_ns;
+}
+
+static void update_spin_margin(uint64_t overshoot_ns) {
+    uint64_t wanted = overshoot_ns + overshoot_ns / 4 + SPIN_MARGIN_SAFETY_NS;
+    uint64_t margin = spin_margin_ns.load(std::memory_order_relaxed);
+
+    if (wanted > margin) {
+        // Late wake-ups cost a whole frame, so grow immediately.
+        margin = wanted;
+    } else {
+        // Shrink slowly so a single lucky wake-up doesn't make the next sleep overshoot.
+        margin -= (margin - wanted) / 16;
+    }
+
+    spin_margin_ns.store(std::clamp<uint64_t>(margin, SPIN_MARGIN_MIN_NS, SPIN_MARGIN_MAX_NS),
+                         std::memory_order_relaxed);
+}
+
+void gfx_pacing_init(const struct GfxPacingClock* clock) {
+    if (clock != nullptr) {
+        pacing_clock = *clock;
+    } else {
+        pacing_clock = { default_now_ns, default_sleep_ns, nullptr };
+    }
+
+    previous_deadline = 0;
+    frame_start = 0;
+    present_start = 0;
+    spin_margin_ns.store(SPIN_MARGIN_INITIAL_NS, std::memory_order_relaxed);
+    gfx_pacing_reset_stats();
+}
+
+void gfx_pacing_set_target_fps(int fps) {
+    target_fps = fps;
+}
+
+void gfx_pacing_wait(void) {
+    uint64_t t = pacing_clock.now_ns(pacing_clock.user);
+
+    if (frame_start != 0) {
+        histogram_record(GFX_PACING_METRIC_CPU_TIME, t - frame_start);
+    }
+
+    if (previous_deadline == 0 || target_fps <= 0) {
+        previous_deadline = t;
+        present_start = t;
+        return;
+    }
+
+    const uint64_t next = previous_deadline + 1000000000ULL / target_fps;
+
+    if (next > t) {
+        const uint64_t margin = spin_margin_ns.load(std::memory_order_relaxed);
+        if (next - t > margin) {
+            const uint64_t wake = next - margin;
+            pacing_clock.sleep_ns(pacing_clock.user, wake - t);
+            t = pacing_clock.now_ns(pacing_clock.user);
+            update_spin_margin(t > wake ? t - wake : 0);
+        }
+
+        while (t < next) {
+            std::this_thread::yield();
+            t = pacing_clock.now_ns(pacing_clock.user);
+        }
+    }
+
+    histogram_record(GFX_PACING_METRIC_PACING_ERROR, t - next);
+
+    // Stay on the ideal schedule unless we missed the deadline by a meaningful amount.
+    previous_deadline = t - next < MISSED_FRAME_TOLERANCE_NS ? next : t;
+    present_start = t;
+}
+
+void gfx_pacing_present_done(void) {
+    uint64_t t = pacing_clock.now_ns(pacing_clock.user);
+
+    if (present_start != 0) {
+        histogram_record(GFX_PACING_METRIC_PRESENT_TIME, t - present_start);
+    }
+
+    frame_start = t;
+}
+
+void gfx_pacing_get_stats(enum GfxPacingMetric metric, struct GfxPacingStats* stats) {
+    const std::lock_guard<std::mutex> lock(stats_mutex);
+    const struct PacingHistogram* h = &histograms[metric];
+
+    stats->count = h->count;
+    stats->min_ns = h->min_ns;
+    stats->max_ns = h->max_ns;
+    stats->mean_ns = h->count == 0 ? 0 : h->sum_ns / h->count;
+    stats->p50_ns = histogram_percentile(h, 500);
+    stats->p99_ns = histogram_percentile(h, 990);
+    stats->spin_margin_ns = spin_margin_ns.load(std::memory_order_relaxed);
+}
+
+void gfx_pacing_reset_stats(void) {
+    const std::lock_guard<std::mutex> lock(stats_mutex);
+    for (auto& h : histograms) {
+        h = {};
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef GFX_PACING_H
+#define GFX_PACING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Histogram buckets are 100us wide, anything past the last bucket lands in the last one.
+#define GFX_PACING_HISTOGRAM_BUCKETS 400
+#define GFX_PACING_HISTOGRAM_BUCKET_NS 100000
+
+enum GfxPacingMetric {
+    GFX_PACING_METRIC_CPU_TIME,     // Time from the end of the previous present to the start of the wait
+    GFX_PACING_METRIC_PRESENT_TIME, // Time spent inside the swap call
+    GFX_PACING_METRIC_PACING_ERROR, // Absolute distance between the actual and the ideal wake-up time
+    GFX_PACING_METRIC_COUNT
+};
+
+struct GfxPacingStats {
+    uint64_t count;
+    uint64_t min_ns;
+    uint64_t max_ns;
+    uint64_t mean_ns;
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t spin_margin_ns;
+};
+
+// Time source used by the pacer. Window backends provide one built on their own high resolution counter, and a fake
+// clock can be passed in to drive the pacer without a display.
+struct GfxPacingClock {
+    uint64_t (*now_ns)(void* user);
+    void (*sleep_ns)(void* user, uint64_t duration_ns);
+    void* user;
+};
+
+void gfx_pacing_init(const struct GfxPacingClock* clock);
+void gfx_pacing_set_target_fps(int fps);
+// Called right before presenting. Sleeps until shortly before the deadline, then spins for the remainder.
+void gfx_pacing_wait(void);
+// Called right after presenting.
+void gfx_pacing_present_done(void);
+void gfx_pacing_get_stats(enum GfxPacingMetric metric, struct GfxPacingStats* stats);
+void gfx_pacing_reset_stats(void);
+
+#endif
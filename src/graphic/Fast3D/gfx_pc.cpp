@@ -8,6 +8,7 @@
 #include <assert.h>
 #include <stdio.h>
 
+#include <array>
 #include <map>
 #include <set>
 #include <unordered_map>
@@ -32,6 +33,7 @@
 #include "gfx_rendering_api.h"
 #include "gfx_screen_config.h"
 #include "misc/Hooks.h"
+#include "debug/TraceEvents.h"
 
 #include "log/luslog.h"
 #include "menu/ImGuiImpl.h"
@@ -71,12 +73,21 @@ using namespace std;
 
 #define TEXTURE_CACHE_MAX_SIZE 500
 
+// Textures up to 32x32 are packed into cells of shared atlas pages, so consecutive draws with different small textures
+// don't need a texture bind and a flush. Every cell has a one texel border so filtering at the cell edge matches the
+// wrap mode: clamped and mirrored tiles repeat the edge texel, wrapped tiles continue with the opposite edge.
+#define ATLAS_PAGE_SIZE 1024
+#define ATLAS_CELL_SIZE 34
+#define ATLAS_CELLS_PER_ROW (ATLAS_PAGE_SIZE / ATLAS_CELL_SIZE)
+#define ATLAS_MAX_TEXTURE_SIZE (ATLAS_CELL_SIZE - 2)
+
 struct RGBA {
     uint8_t r, g, b, a;
 };
 
 struct LoadedVertex {
     float x, y, z, w;
+    float screen_x, screen_y; // x / w and y / w, computed once at load for face culling
     float u, v;
     struct RGBA color;
     uint8_t clip_rej;
@@ -88,11 +99,42 @@ static struct {
     vector<uint32_t> free_texture_ids;
 } gfx_texture_cache;
 
+struct AtlasPage {
+    uint32_t texture_id;
+    bool linear_filter;
+    vector<uint16_t> free_cells;
+};
+
+static struct {
+    bool enabled;
+    vector<struct AtlasPage> pages;
+} texture_atlas;
+
+// Texture currently selected in each slot, a draw only has to be flushed when this changes
+static uint32_t bound_texture_ids[2] = { UINT32_MAX, UINT32_MAX };
+// Slot of the texture being imported, used by the import functions to find the cache entry to upload into
+static int importing_texture_index;
+
+struct LoadedVertex;
+struct TriangleSetup;
+
+// Everything about the vertex layout of a shader program that doesn't change between triangles. Built once when the
+// program is first looked up for a combiner, so gfx_sp_tri1 doesn't need to query the rendering API per triangle.
+struct VertexEmissionPlan {
+    uint8_t num_inputs;
+    bool used_textures[2];
+    bool atlas[2];
+    void (*emit)(const struct VertexEmissionPlan* plan, struct LoadedVertex* const v_arr[3],
+                 const struct TriangleSetup* tri);
+};
+
 struct ColorCombiner {
     uint64_t shader_id0;
     uint32_t shader_id1;
     bool used_textures[2];
-    struct ShaderProgram* prg[16];
+    // Indexed by the texture clamp mode bits | the texture atlas bits << 4
+    struct ShaderProgram* prg[64];
+    struct VertexEmissionPlan plans[64];
     uint8_t shader_input_mapping[2][7];
 };
 
@@ -185,8 +227,25 @@ static struct RenderingState {
     struct XYWidthHeight viewport, scissor;
     struct ShaderProgram* shader_program;
     TextureCacheNode* textures[2];
+    struct GfxClipParameters clip_parameters;
 } rendering_state;
 
+// Per triangle values shared by its three vertices, precomputed before emission.
+struct TriangleSetup {
+    struct GfxClipParameters clip;
+    float u_scale[2], v_scale[2];
+    float u_offset[2], v_offset[2];
+    bool clamp_s[2], clamp_t[2];
+    float clamp_s_value[2], clamp_t_value[2];
+    // Cell rectangle in the atlas page, with the wrap modes added to the origin as 2 * mode
+    float atlas_rect[2][4];
+    float fog_color[3];
+    float grayscale_color[4];
+    // Combiner inputs that don't come from the vertex shade color, rgb from the color mapping and a from the alpha one
+    float inputs[7][4];
+    bool input_is_shade[7][2];
+};
+
 struct GfxDimensions gfx_current_window_dimensions;
 struct GfxDimensions gfx_current_dimensions;
 static struct GfxDimensions gfx_prev_dimensions;
@@ -204,6 +263,34 @@ static bool dropped_frame;
 
 static const std::unordered_map<Mtx*, MtxF>* current_mtx_replacements;
 
+static struct GfxTriangleStats triangle_stats;
+static struct GfxTriangleStats last_frame_triangle_stats;
+
+// Frame interpolation. The first run after gfx_interpolation_new_tick captures every matrix and dynamic vertex load.
+// Loads after a gSPInterpolationTag are keyed by the tag, others by the address of the loading command and of the data
+// it loads, so they only pair up when the game builds them in the same place every tick. Every run blends the loaded
+// values towards the capture of the previous tick with the same key, loads without one are left as they are.
+#define INTERP_KIND_MATRIX 0x4D54580000000000ULL
+#define INTERP_KIND_VERTEX 0x5654580000000000ULL
+
+struct InterpolationCapture {
+    std::unordered_map<uint64_t, std::array<float, 16>> matrices;
+    std::unordered_map<uint64_t, std::vector<float>> vertices;
+};
+
+static struct {
+    bool active;
+    bool capturing;
+    float t;
+    uint32_t tag;
+    const Gfx* cmd;
+    // How often each key was loaded this run, so repeated loads of the same data get their own keys
+    std::unordered_map<uint64_t, uint32_t> occurrences;
+    std::vector<float> vertex_scratch;
+    struct InterpolationCapture current;
+    struct InterpolationCapture previous;
+} interp;
+
 static float buf_vbo[MAX_BUFFERED * (32 * 3)]; // 3 vertices in a triangle and 32 floats per vtx
 static size_t buf_vbo_len;
 static size_t buf_vbo_num_tris;
@@ -250,11 +337,20 @@ static char* GetPathWithCurrentDir(char* filePath) {
 static void gfx_flush(void) {
     if (buf_vbo_len > 0) {
         gfx_rapi->draw_triangles(buf_vbo, buf_vbo_len, buf_vbo_num_tris);
+        triangle_stats.draw_calls++;
         buf_vbo_len = 0;
         buf_vbo_num_tris = 0;
     }
 }
 
+static void gfx_select_texture(int i, uint32_t texture_id) {
+    if (texture_id != bound_texture_ids[i]) {
+        gfx_flush();
+        bound_texture_ids[i] = texture_id;
+    }
+    gfx_rapi->select_texture(i, texture_id);
+}
+
 static struct ShaderProgram* gfx_lookup_or_create_shader_program(uint64_t shader_id0, uint32_t shader_id1) {
     struct ShaderProgram* prg = gfx_rapi->lookup_shader(shader_id0, shader_id1);
     if (prg == NULL) {
@@ -504,9 +600,17 @@ static struct ColorCombiner* gfx_lookup_or_create_color_combiner(uint64_t cc_id)
     return &prev_combiner->second;
 }
 
+static void gfx_texture_cache_release(const TextureCacheValue& value) {
+    if (value.atlas_page >= 0) {
+        texture_atlas.pages[value.atlas_page].free_cells.push_back(value.atlas_cell);
+    } else if (value.texture_id != UINT32_MAX) {
+        gfx_texture_cache.free_texture_ids.push_back(value.texture_id);
+    }
+}
+
 void gfx_texture_cache_clear() {
     for (const auto& entry : gfx_texture_cache.map) {
-        gfx_texture_cache.free_texture_ids.push_back(entry.second.texture_id);
+        gfx_texture_cache_release(entry.second);
     }
     gfx_texture_cache.map.clear();
     gfx_texture_cache.lru.clear();
@@ -521,18 +625,25 @@ static bool gfx_texture_cache_lookup(int i, int tile) {
     const uint8_t* orig_addr = rdp.loaded_texture[tmem_index].addr;
     uint8_t palette_index = rdp.texture_tile[tile].palette;
 
+    // The same texture drawn wrapped and clamped needs two atlas cells with different borders
+    uint8_t atlas_wrap = 0;
+    if (texture_atlas.enabled) {
+        atlas_wrap |= (rdp.texture_tile[tile].cms & (G_TX_CLAMP | G_TX_MIRROR)) == 0 ? 1 : 0;
+        atlas_wrap |= (rdp.texture_tile[tile].cmt & (G_TX_CLAMP | G_TX_MIRROR)) == 0 ? 2 : 0;
+    }
+
     TextureCacheKey key;
     if (fmt == G_IM_FMT_CI) {
-        key = { orig_addr, { rdp.palettes[0], rdp.palettes[1] }, fmt, siz, palette_index };
+        key = { orig_addr, { rdp.palettes[0], rdp.palettes[1] }, fmt, siz, palette_index, atlas_wrap };
     } else {
-        key = { orig_addr, {}, fmt, siz, palette_index };
+        key = { orig_addr, {}, fmt, siz, palette_index, atlas_wrap };
     }
 
     TextureCacheMap::iterator it = gfx_texture_cache.map.find(key);
     RawTexMetadata metadata = rdp.loaded_texture[rdp.texture_tile[tile].tmem_index].raw_tex_metadata;
 
     if (it != gfx_texture_cache.map.end()) {
-        gfx_rapi->select_texture(i, it->second.texture_id);
+        gfx_select_texture(i, it->second.texture_id);
         *n = &*it;
         gfx_texture_cache.lru.splice(gfx_texture_cache.lru.end(), gfx_texture_cache.lru,
                                      it->second.lru_location); // move to back
@@ -542,26 +653,18 @@ static bool gfx_texture_cache_lookup(int i, int tile) {
     if (gfx_texture_cache.map.size() >= TEXTURE_CACHE_MAX_SIZE) {
         // Remove the texture that was least recently used
         it = gfx_texture_cache.lru.front().it;
-        gfx_texture_cache.free_texture_ids.push_back(it->second.texture_id);
+        gfx_texture_cache_release(it->second);
         gfx_texture_cache.map.erase(it);
         gfx_texture_cache.lru.pop_front();
     }
 
-    uint32_t texture_id;
-    if (!gfx_texture_cache.free_texture_ids.empty()) {
-        texture_id = gfx_texture_cache.free_texture_ids.back();
-        gfx_texture_cache.free_texture_ids.pop_back();
-    } else {
-        texture_id = gfx_rapi->new_texture();
-    }
-
+    // The texture id is assigned by gfx_upload_texture, once the size of the texture is known
     it = gfx_texture_cache.map.insert(make_pair(key, TextureCacheValue())).first;
     TextureCacheNode* node = &*it;
-    node->second.texture_id = texture_id;
+    node->second.texture_id = UINT32_MAX;
+    node->second.atlas_page = -1;
     node->second.lru_location = gfx_texture_cache.lru.insert(gfx_texture_cache.lru.end(), { it });
 
-    gfx_rapi->select_texture(i, texture_id);
-    gfx_rapi->set_sampler_parameters(i, false, 0, 0);
     *n = node;
     return false;
 }
@@ -574,7 +677,7 @@ static void gfx_texture_cache_delete(const uint8_t* orig_addr) {
         for (auto it = gfx_texture_cache.map.begin(bucket); it != gfx_texture_cache.map.end(bucket); ++it) {
             if (it->first.texture_addr == orig_addr) {
                 gfx_texture_cache.lru.erase(it->second.lru_location);
-                gfx_texture_cache.free_texture_ids.push_back(it->second.texture_id);
+                gfx_texture_cache_release(it->second);
                 gfx_texture_cache.map.erase(it->first);
                 again = true;
                 break;
@@ -586,6 +689,91 @@ static void gfx_texture_cache_delete(const uint8_t* orig_addr) {
     }
 }
 
+static void gfx_atlas_upload(int i, TextureCacheValue* value, uint8_t wrap, const uint8_t* rgba32_buf, uint32_t width,
+                             uint32_t height) {
+    static uint8_t cell_buf[ATLAS_CELL_SIZE * ATLAS_CELL_SIZE * 4];
+
+    // Prefer the page that is already selected, so the next draw doesn't need a new bind
+    int page_index = -1;
+    for (size_t p = 0; p < texture_atlas.pages.size(); p++) {
+        if (!texture_atlas.pages[p].free_cells.empty()) {
+            if (page_index < 0 || texture_atlas.pages[p].texture_id == bound_texture_ids[i]) {
+                page_index = p;
+            }
+        }
+    }
+
+    if (page_index < 0) {
+        struct AtlasPage page;
+        page.texture_id = gfx_rapi->new_texture();
+        page.linear_filter = false;
+        for (int cell = ATLAS_CELLS_PER_ROW * ATLAS_CELLS_PER_ROW - 1; cell >= 0; cell--) {
+            page.free_cells.push_back(cell);
+        }
+        gfx_select_texture(i, page.texture_id);
+        gfx_rapi->set_sampler_parameters(i, false, G_TX_CLAMP, G_TX_CLAMP);
+        gfx_rapi->upload_texture(nullptr, ATLAS_PAGE_SIZE, ATLAS_PAGE_SIZE);
+        page_index = texture_atlas.pages.size();
+        texture_atlas.pages.push_back(std::move(page));
+    }
+
+    struct AtlasPage* page = &texture_atlas.pages[page_index];
+    uint16_t cell = page->free_cells.back();
+    page->free_cells.pop_back();
+    gfx_select_texture(i, page->texture_id);
+
+    // Copy the texture into the middle of the cell, the border repeats the edge or continues with the opposite edge
+    for (uint32_t y = 0; y < height + 2; y++) {
+        uint32_t src_y = (wrap & 2) ? (y + height - 1) % height : std::clamp<int32_t>(y - 1, 0, height - 1);
+        for (uint32_t x = 0; x < width + 2; x++) {
+            uint32_t src_x = (wrap & 1) ? (x + width - 1) % width : std::clamp<int32_t>(x - 1, 0, width - 1);
+            memcpy(&cell_buf[(y * (width + 2) + x) * 4], &rgba32_buf[(src_y * width + src_x) * 4], 4);
+        }
+    }
+
+    uint32_t cell_x = (cell % ATLAS_CELLS_PER_ROW) * ATLAS_CELL_SIZE;
+    uint32_t cell_y = (cell / ATLAS_CELLS_PER_ROW) * ATLAS_CELL_SIZE;
+    gfx_rapi->upload_texture_region(cell_buf, cell_x, cell_y, width + 2, height + 2);
+
+    value->texture_id = page->texture_id;
+    value->atlas_page = page_index;
+    value->atlas_cell = cell;
+    value->atlas_rect[0] = (cell_x + 1) / (float)ATLAS_PAGE_SIZE;
+    value->atlas_rect[1] = (cell_y + 1) / (float)ATLAS_PAGE_SIZE;
+    value->atlas_rect[2] = width / (float)ATLAS_PAGE_SIZE;
+    value->atlas_rect[3] = height / (float)ATLAS_PAGE_SIZE;
+}
+
+static void gfx_texture_cache_new_texture(int i, TextureCacheValue* value) {
+    if (!gfx_texture_cache.free_texture_ids.empty()) {
+        value->texture_id = gfx_texture_cache.free_texture_ids.back();
+        gfx_texture_cache.free_texture_ids.pop_back();
+    } else {
+        value->texture_id = gfx_rapi->new_texture();
+    }
+
+    gfx_select_texture(i, value->texture_id);
+    gfx_rapi->set_sampler_parameters(i, false, 0, 0);
+}
+
+// Uploads the converted texture for the cache entry being imported, into an atlas cell when it is small enough
+static void gfx_upload_texture(const uint8_t* rgba32_buf, uint32_t width, uint32_t height) {
+    int i = importing_texture_index;
+    TextureCacheValue* value = &rendering_state.textures[i]->second;
+
+    // Pending triangles could still reference a recycled texture id or atlas cell
+    gfx_flush();
+
+    if (texture_atlas.enabled && width > 0 && height > 0 && width <= ATLAS_MAX_TEXTURE_SIZE &&
+        height <= ATLAS_MAX_TEXTURE_SIZE) {
+        gfx_atlas_upload(i, value, rendering_state.textures[i]->first.atlas_wrap, rgba32_buf, width, height);
+        return;
+    }
+
+    gfx_texture_cache_new_texture(i, value);
+    gfx_rapi->upload_texture(rgba32_buf, width, height);
+}
+
 static void import_texture_rgba16(int tile) {
     const uint8_t* addr = rdp.loaded_texture[rdp.texture_tile[tile].tmem_index].addr;
     uint32_t size_bytes = rdp.loaded_texture[rdp.texture_tile[tile].tmem_index].size_bytes;
@@ -609,7 +797,7 @@ static void import_texture_rgba16(int tile) {
     uint32_t width = rdp.texture_tile[tile].line_size_bytes / 2;
     uint32_t height = size_bytes / rdp.texture_tile[tile].line_size_bytes;
 
-    gfx_rapi->upload_texture(tex_upload_buffer, width, height);
+    gfx_upload_texture(tex_upload_buffer, width, height);
     // DumpTexture(rdp.loaded_texture[rdp.texture_tile[tile].tmem_index].otr_path, rgba32_buf, width, height);
 }
 
@@ -623,7 +811,7 @@ static void import_texture_rgba32(int tile) {
 
     uint32_t width = rdp.texture_tile[tile].line_size_bytes / 2;
     uint32_t height = (size_bytes / 2) / rdp.texture_tile[tile].line_size_bytes;
-    gfx_rapi->upload_texture(addr, width, height);
+    gfx_upload_texture(addr, width, height);
     // DumpTexture(rdp.loaded_texture[rdp.texture_tile[tile].tmem_index].otr_path, addr, width, height);
 }
 
@@ -652,7 +840,7 @@ static void import_texture_ia4(int tile) {
     uint32_t width = rdp.texture_tile[tile].line_size_bytes * 2;
     uint32_t height = size_bytes / rdp.texture_tile[tile].line_size_bytes;
 
-    gfx_rapi->upload_texture(tex_upload_buffer, width, height);
+    gfx_upload_texture(tex_upload_buffer, width, height);
     // DumpTexture(rdp.loaded_texture[rdp.texture_tile[tile].tmem_index].otr_path, rgba32_buf, width, height);
 }
 
@@ -679,7 +867,7 @@ static void import_texture_ia8(int tile) {
     uint32_t width = rdp.texture_tile[tile].line_size_bytes;
     uint32_t height = size_bytes / rdp.texture_tile[tile].line_size_bytes;
 
-    gfx_rapi->upload_texture(tex_upload_buffer, width, height);
+    gfx_upload_texture(tex_upload_buffer, width, height);
     // DumpTexture(rdp.loaded_texture[rdp.texture_tile[tile].tmem_index].otr_path, rgba32_buf, width, height);
 }
 
@@ -706,7 +894,7 @@ static void import_texture_ia16(int tile) {
     uint32_t width = rdp.texture_tile[tile].line_size_bytes / 2;
     uint32_t height = size_bytes / rdp.texture_tile[tile].line_size_bytes;
 
-    gfx_rapi->upload_texture(tex_upload_buffer, width, height);
+    gfx_upload_texture(tex_upload_buffer, width, height);
     // DumpTexture(rdp.loaded_texture[rdp.texture_tile[tile].tmem_index].otr_path, rgba32_buf, width, height);
 }
 
@@ -735,7 +923,7 @@ static void import_texture_i4(int tile) {
     uint32_t width = rdp.texture_tile[tile].line_size_bytes * 2;
     uint32_t height = size_bytes / rdp.texture_tile[tile].line_size_bytes;
 
-    gfx_rapi->upload_texture(tex_upload_buffer, width, height);
+    gfx_upload_texture(tex_upload_buffer, width, height);
     // DumpTexture(rdp.loaded_texture[rdp.texture_tile[tile].tmem_index].otr_path, rgba32_buf, width, height);
 }
 
@@ -762,7 +950,7 @@ static void import_texture_i8(int tile) {
     uint32_t width = rdp.texture_tile[tile].line_size_bytes;
     uint32_t height = size_bytes / rdp.texture_tile[tile].line_size_bytes;
 
-    gfx_rapi->upload_texture(tex_upload_buffer, width, height);
+    gfx_upload_texture(tex_upload_buffer, width, height);
     // DumpTexture(rdp.loaded_texture[rdp.texture_tile[tile].tmem_index].otr_path, rgba32_buf, width, height);
 }
 
@@ -799,7 +987,7 @@ static void import_texture_ci4(int tile) {
     uint32_t width = result_line_size * 2;
     uint32_t height = size_bytes / result_line_size;
 
-    gfx_rapi->upload_texture(tex_upload_buffer, width, height);
+    gfx_upload_texture(tex_upload_buffer, width, height);
 }
 
 static void import_texture_ci8(int tile) {
@@ -834,7 +1022,7 @@ static void import_texture_ci8(int tile) {
     uint32_t width = result_line_size;
     uint32_t height = size_bytes / result_line_size;
 
-    gfx_rapi->upload_texture(tex_upload_buffer, width, height);
+    gfx_upload_texture(tex_upload_buffer, width, height);
     // DumpTexture(rdp.loaded_texture[rdp.texture_tile[tile].tmem_index].otr_path, rgba32_buf, width, height);
 }
 
@@ -875,7 +1063,7 @@ static void import_texture_raw(int tile) {
 
     if (result_new_line_size == 4 * width && result_new_height == height) {
         // Can use the texture directly since it has the correct dimensions
-        gfx_rapi->upload_texture(addr, width, height);
+        gfx_upload_texture(addr, width, height);
         return;
     }
 
@@ -887,7 +1075,7 @@ static void import_texture_raw(int tile) {
         memcpy(tex_upload_buffer + i, addr + j, line_size_bytes);
     }
 
-    gfx_rapi->upload_texture(tex_upload_buffer, result_new_line_size / 4, result_new_height);
+    gfx_upload_texture(tex_upload_buffer, result_new_line_size / 4, result_new_height);
 }
 
 static void import_texture(int i, int tile) {
@@ -900,13 +1088,12 @@ static void import_texture(int i, int tile) {
         return;
     }
 
+    importing_texture_index = i;
+
     // if load as raw is set then we load_raw();
     if ((texFlags & TEX_FLAG_LOAD_AS_RAW) != 0) {
         import_texture_raw(tile);
-        return;
-    }
-
-    if (fmt == G_IM_FMT_RGBA) {
+    } else if (fmt == G_IM_FMT_RGBA) {
         if (siz == G_IM_SIZ_16b) {
             import_texture_rgba16(tile);
         } else if (siz == G_IM_SIZ_32b) {
@@ -944,6 +1131,11 @@ static void import_texture(int i, int tile) {
     } else {
         abort();
     }
+
+    if (rendering_state.textures[i]->second.texture_id == UINT32_MAX) {
+        // Nothing was uploaded, the entry still gets a texture of its own
+        gfx_texture_cache_new_texture(i, &rendering_state.textures[i]->second);
+    }
 }
 
 static void gfx_normalize_vector(float v[3]) {
@@ -976,6 +1168,65 @@ static void gfx_matrix_mul(float res[4][4], const float a[4][4], const float b[4
     memcpy(res, tmp, sizeof(tmp));
 }
 
+static uint64_t gfx_interpolation_key(uint64_t kind, const void* source) {
+    uint64_t base = kind;
+    if (interp.tag != 0) {
+        base ^= interp.tag * 0x9E3779B97F4A7C15ULL;
+    } else {
+        base ^= (uintptr_t)interp.cmd * 0x9E3779B97F4A7C15ULL ^ (uintptr_t)source * 0xC2B2AE3D27D4EB4FULL;
+    }
+    uint32_t occurrence = interp.occurrences[base]++;
+    return base ^ ((occurrence + 1) * 0x165667B19E3779F9ULL);
+}
+
+static void gfx_interpolate_matrix(float matrix[4][4], const int32_t* source) {
+    uint64_t key = gfx_interpolation_key(INTERP_KIND_MATRIX, source);
+    if (interp.capturing) {
+        memcpy(interp.current.matrices[key].data(), matrix, sizeof(float) * 16);
+    }
+
+    auto it = interp.previous.matrices.find(key);
+    if (it == interp.previous.matrices.end()) {
+        return;
+    }
+
+    const float* prev = it->second.data();
+    float* cur = &matrix[0][0];
+    for (int i = 0; i < 16; i++) {
+        cur[i] = prev[i] + (cur[i] - prev[i]) * interp.t;
+    }
+}
+
+// Returns interpolated object space positions for the vertices, or nullptr if there is nothing to interpolate against.
+static const float* gfx_interpolate_vertices(size_t n_vertices, const Vtx* vertices) {
+    uint64_t key = gfx_interpolation_key(INTERP_KIND_VERTEX, vertices);
+    if (interp.capturing) {
+        std::vector<float>& captured = interp.current.vertices[key];
+        captured.resize(n_vertices * 3);
+        for (size_t i = 0; i < n_vertices; i++) {
+            captured[i * 3 + 0] = vertices[i].v.ob[0];
+            captured[i * 3 + 1] = vertices[i].v.ob[1];
+            captured[i * 3 + 2] = vertices[i].v.ob[2];
+        }
+    }
+
+    auto it = interp.previous.vertices.find(key);
+    if (it == interp.previous.vertices.end() || it->second.size() != n_vertices * 3) {
+        return nullptr;
+    }
+
+    const std::vector<float>& prev = it->second;
+    interp.vertex_scratch.resize(n_vertices * 3);
+    for (size_t i = 0; i < n_vertices; i++) {
+        for (int j = 0; j < 3; j++) {
+            float p = prev[i * 3 + j];
+            interp.vertex_scratch[i * 3 + j] = p + (vertices[i].v.ob[j] - p) * interp.t;
+        }
+    }
+
+    return interp.vertex_scratch.data();
+}
+
 static void gfx_sp_matrix(uint8_t parameters, const int32_t* addr) {
     float matrix[4][4];
 
@@ -1004,6 +1255,10 @@ static void gfx_sp_matrix(uint8_t parameters, const int32_t* addr) {
 #endif
     }
 
+    if (interp.active) {
+        gfx_interpolate_matrix(matrix, addr);
+    }
+
     if (parameters & G_MTX_PROJECTION) {
         if (parameters & G_MTX_LOAD) {
             memcpy(rsp.P_matrix, matrix, sizeof(matrix));
@@ -1058,7 +1313,14 @@ static void gfx_adjust_width_height_for_scale(uint32_t& width, uint32_t& height)
     }
 }
 
-static void gfx_sp_vertex(size_t n_vertices, size_t dest_index, const Vtx* vertices) {
+// Dynamic vertices are ones the game writes every frame rather than ones loaded from resources, only those are
+// considered for frame interpolation.
+static void gfx_sp_vertex(size_t n_vertices, size_t dest_index, const Vtx* vertices, bool dynamic = false) {
+    const float* interp_ob = nullptr;
+    if (interp.active && dynamic && vertices != NULL) {
+        interp_ob = gfx_interpolate_vertices(n_vertices, vertices);
+    }
+
     for (size_t i = 0; i < n_vertices; i++, dest_index++) {
         const Vtx_t* v = &vertices[i].v;
         const Vtx_tn* vn = &vertices[i].n;
@@ -1068,13 +1330,17 @@ static void gfx_sp_vertex(size_t n_vertices, size_t dest_index, const Vtx* verti
             return;
         }
 
-        float x = v->ob[0] * rsp.MP_matrix[0][0] + v->ob[1] * rsp.MP_matrix[1][0] + v->ob[2] * rsp.MP_matrix[2][0] +
+        float ob_x = interp_ob != nullptr ? interp_ob[i * 3 + 0] : v->ob[0];
+        float ob_y = interp_ob != nullptr ? interp_ob[i * 3 + 1] : v->ob[1];
+        float ob_z = interp_ob != nullptr ? interp_ob[i * 3 + 2] : v->ob[2];
+
+        float x = ob_x * rsp.MP_matrix[0][0] + ob_y * rsp.MP_matrix[1][0] + ob_z * rsp.MP_matrix[2][0] +
                   rsp.MP_matrix[3][0];
-        float y = v->ob[0] * rsp.MP_matrix[0][1] + v->ob[1] * rsp.MP_matrix[1][1] + v->ob[2] * rsp.MP_matrix[2][1] +
+        float y = ob_x * rsp.MP_matrix[0][1] + ob_y * rsp.MP_matrix[1][1] + ob_z * rsp.MP_matrix[2][1] +
                   rsp.MP_matrix[3][1];
-        float z = v->ob[0] * rsp.MP_matrix[0][2] + v->ob[1] * rsp.MP_matrix[1][2] + v->ob[2] * rsp.MP_matrix[2][2] +
+        float z = ob_x * rsp.MP_matrix[0][2] + ob_y * rsp.MP_matrix[1][2] + ob_z * rsp.MP_matrix[2][2] +
                   rsp.MP_matrix[3][2];
-        float w = v->ob[0] * rsp.MP_matrix[0][3] + v->ob[1] * rsp.MP_matrix[1][3] + v->ob[2] * rsp.MP_matrix[2][3] +
+        float w = ob_x * rsp.MP_matrix[0][3] + ob_y * rsp.MP_matrix[1][3] + ob_z * rsp.MP_matrix[2][3] +
                   rsp.MP_matrix[3][3];
 
         x = gfx_adjust_x_for_aspect_ratio(x);
@@ -1178,6 +1444,8 @@ static void gfx_sp_vertex(size_t n_vertices, size_t dest_index, const Vtx* verti
         d->y = y;
         d->z = z;
         d->w = w;
+        d->screen_x = x / w;
+        d->screen_y = y / w;
 
         if (rsp.geometry_mode & G_FOG) {
             if (fabsf(w) < 0.001f) {
@@ -1210,48 +1478,212 @@ static void gfx_sp_modify_vertex(uint16_t vtx_idx, uint8_t where, uint32_t val)
     v->v = t;
 }
 
-static void gfx_sp_tri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx, bool is_rect) {
-    struct LoadedVertex* v1 = &rsp.loaded_vertices[vtx1_idx];
-    struct LoadedVertex* v2 = &rsp.loaded_vertices[vtx2_idx];
-    struct LoadedVertex* v3 = &rsp.loaded_vertices[vtx3_idx];
-    struct LoadedVertex* v_arr[3] = { v1, v2, v3 };
+template <bool use_alpha, bool use_fog, bool use_grayscale>
+static void gfx_emit_triangle(const struct VertexEmissionPlan* plan, struct LoadedVertex* const v_arr[3],
+                              const struct TriangleSetup* tri) {
+    float* out = &buf_vbo[buf_vbo_len];
 
-    // if (rand()%2) return;
+    for (int i = 0; i < 3; i++) {
+        const struct LoadedVertex* vtx = v_arr[i];
+        float z = vtx->z, w = vtx->w;
+        if (tri->clip.z_is_from_0_to_1) {
+            z = (z + w) / 2.0f;
+        }
 
-    if (v1->clip_rej & v2->clip_rej & v3->clip_rej) {
-        // The whole triangle lies outside the visible area
-        return;
-    }
+        *out++ = vtx->x;
+        *out++ = tri->clip.invert_y ? -vtx->y : vtx->y;
+        *out++ = z;
+        *out++ = w;
+
+        for (int t = 0; t < 2; t++) {
+            if (!plan->used_textures[t]) {
+                continue;
+            }
+
+            *out++ = vtx->u * tri->u_scale[t] + tri->u_offset[t];
+            *out++ = vtx->v * tri->v_scale[t] + tri->v_offset[t];
+
+            if (plan->atlas[t]) {
+                // Clamp values are always present, followed by the cell rectangle
+                *out++ = tri->clamp_s[t] ? tri->clamp_s_value[t] : 0.0f;
+                *out++ = tri->clamp_t[t] ? tri->clamp_t_value[t] : 0.0f;
+                *out++ = tri->atlas_rect[t][0];
+                *out++ = tri->atlas_rect[t][1];
+                *out++ = tri->atlas_rect[t][2];
+                *out++ = tri->atlas_rect[t][3];
+                continue;
+            }
+
+            if (tri->clamp_s[t]) {
+                *out++ = tri->clamp_s_value[t];
+            }
+#ifdef __WIIU__
+            else {
+                *out++ = 0.0f;
+            }
+#endif
+            if (tri->clamp_t[t]) {
+                *out++ = tri->clamp_t_value[t];
+            }
+#ifdef __WIIU__
+            else {
+                *out++ = 0.0f;
+            }
+#endif
+        }
 
-    if ((rsp.geometry_mode & G_CULL_BOTH) != 0) {
-        float dx1 = v1->x / (v1->w) - v2->x / (v2->w);
-        float dy1 = v1->y / (v1->w) - v2->y / (v2->w);
-        float dx2 = v3->x / (v3->w) - v2->x / (v2->w);
-        float dy2 = v3->y / (v3->w) - v2->y / (v2->w);
-        float cross = dx1 * dy2 - dy1 * dx2;
+        if (use_fog) {
+            *out++ = tri->fog_color[0];
+            *out++ = tri->fog_color[1];
+            *out++ = tri->fog_color[2];
+            *out++ = vtx->color.a / 255.0f; // fog factor (not alpha)
+        }
 
-        if ((v1->w < 0) ^ (v2->w < 0) ^ (v3->w < 0)) {
-            // If one vertex lies behind the eye, negating cross will give the correct result.
-            // If all vertices lie behind the eye, the triangle will be rejected anyway.
-            cross = -cross;
+        if (use_grayscale) {
+            *out++ = tri->grayscale_color[0];
+            *out++ = tri->grayscale_color[1];
+            *out++ = tri->grayscale_color[2];
+            *out++ = tri->grayscale_color[3]; // lerp interpolation factor (not alpha)
         }
 
-        switch (rsp.geometry_mode & G_CULL_BOTH) {
-            case G_CULL_FRONT:
-                if (cross <= 0) {
-                    return;
+        for (int j = 0; j < plan->num_inputs; j++) {
+            if (tri->input_is_shade[j][0]) {
+                *out++ = vtx->color.r / 255.0f;
+                *out++ = vtx->color.g / 255.0f;
+                *out++ = vtx->color.b / 255.0f;
+            } else {
+                *out++ = tri->inputs[j][0];
+                *out++ = tri->inputs[j][1];
+                *out++ = tri->inputs[j][2];
+            }
+#ifdef __WIIU__
+            // padding
+            if (!use_alpha) {
+                *out++ = 1.0f;
+            }
+#endif
+            if (use_alpha) {
+                if (tri->input_is_shade[j][1]) {
+                    // Shade alpha is 100% for fog
+                    *out++ = use_fog ? 1.0f : vtx->color.a / 255.0f;
+                } else {
+                    *out++ = tri->inputs[j][3];
                 }
-                break;
-            case G_CULL_BACK:
-                if (cross >= 0) {
-                    return;
+            }
+        }
+    }
+
+    buf_vbo_len = out - buf_vbo;
+}
+
+// Indexed by use_alpha | use_fog << 1 | use_grayscale << 2
+static void (*const triangle_emitters[8])(const struct VertexEmissionPlan*, struct LoadedVertex* const[3],
+                                          const struct TriangleSetup*) = {
+    gfx_emit_triangle<false, false, false>, gfx_emit_triangle<true, false, false>,
+    gfx_emit_triangle<false, true, false>,  gfx_emit_triangle<true, true, false>,
+    gfx_emit_triangle<false, false, true>,  gfx_emit_triangle<true, false, true>,
+    gfx_emit_triangle<false, true, true>,   gfx_emit_triangle<true, true, true>,
+};
+
+// Resolves a combiner input that is constant over the triangle. Returns nullptr for the vertex shade color.
+static const struct RGBA* gfx_resolve_combiner_input(uint8_t input, const struct LoadedVertex* v1, struct RGBA* tmp) {
+    switch (input) {
+            // Note: CCMUX constants and ACMUX constants used here have same value, which is why this works
+            // (except LOD fraction).
+        case G_CCMUX_PRIMITIVE:
+            return &rdp.prim_color;
+        case G_CCMUX_SHADE:
+            return nullptr;
+        case G_CCMUX_ENVIRONMENT:
+            return &rdp.env_color;
+        case G_CCMUX_PRIMITIVE_ALPHA:
+            tmp->r = tmp->g = tmp->b = rdp.prim_color.a;
+            return tmp;
+        case G_CCMUX_ENV_ALPHA:
+            tmp->r = tmp->g = tmp->b = rdp.env_color.a;
+            return tmp;
+        case G_CCMUX_PRIM_LOD_FRAC:
+            tmp->r = tmp->g = tmp->b = rdp.prim_lod_fraction;
+            return tmp;
+        case G_CCMUX_LOD_FRACTION: {
+            if (rdp.other_mode_l & G_TL_LOD) {
+                // "Hack" that works for Bowser - Peach painting
+                float distance_frac = (v1->w - 3000.0f) / 3000.0f;
+                if (distance_frac < 0.0f) {
+                    distance_frac = 0.0f;
                 }
-                break;
-            case G_CULL_BOTH:
-                // Why is this even an option?
-                return;
+                if (distance_frac > 1.0f) {
+                    distance_frac = 1.0f;
+                }
+                tmp->r = tmp->g = tmp->b = tmp->a = distance_frac * 255.0f;
+            } else {
+                tmp->r = tmp->g = tmp->b = tmp->a = 255.0f;
+            }
+            return tmp;
         }
+        case G_ACMUX_PRIM_LOD_FRAC:
+            tmp->a = rdp.prim_lod_fraction;
+            return tmp;
+        default:
+            memset(tmp, 0, sizeof(*tmp));
+            return tmp;
     }
+}
+
+// Returns true if the triangle is trivially outside the view or removed by face culling.
+static bool gfx_cull_triangle(const struct LoadedVertex* v1, const struct LoadedVertex* v2,
+                              const struct LoadedVertex* v3) {
+    triangle_stats.submitted++;
+
+    if (v1->clip_rej & v2->clip_rej & v3->clip_rej) {
+        // The whole triangle lies outside the visible area
+        triangle_stats.clip_rejected++;
+        return true;
+    }
+
+    uint32_t cull_mode = rsp.geometry_mode & G_CULL_BOTH;
+    if (cull_mode == 0) {
+        return false;
+    }
+
+    float dx1 = v1->screen_x - v2->screen_x;
+    float dy1 = v1->screen_y - v2->screen_y;
+    float dx2 = v3->screen_x - v2->screen_x;
+    float dy2 = v3->screen_y - v2->screen_y;
+    float cross = dx1 * dy2 - dy1 * dx2;
+
+    if ((v1->w < 0) ^ (v2->w < 0) ^ (v3->w < 0)) {
+        // If one vertex lies behind the eye, negating cross will give the correct result.
+        // If all vertices lie behind the eye, the triangle will be rejected anyway.
+        cross = -cross;
+    }
+
+    bool culled;
+    switch (cull_mode) {
+        case G_CULL_FRONT:
+            culled = cross <= 0;
+            break;
+        case G_CULL_BACK:
+            culled = cross >= 0;
+            break;
+        default:
+            // G_CULL_BOTH, why is this even an option?
+            culled = true;
+            break;
+    }
+
+    if (culled) {
+        triangle_stats.culled++;
+    }
+
+    return culled;
+}
+
+static void gfx_draw_triangle(struct LoadedVertex* v1, struct LoadedVertex* v2, struct LoadedVertex* v3,
+                              bool is_rect) {
+    struct LoadedVertex* v_arr[3] = { v1, v2, v3 };
+
+    triangle_stats.drawn++;
 
     bool depth_test = (rsp.geometry_mode & G_ZBUFFER) == G_ZBUFFER;
     bool depth_mask = (rdp.other_mode_l & Z_UPD) == Z_UPD;
@@ -1331,13 +1763,15 @@ static void gfx_sp_tri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx, bo
     ColorCombiner* comb = gfx_lookup_or_create_color_combiner(cc_id);
 
     uint32_t tm = 0;
+    uint32_t atlas_mask = 0;
+    uint8_t atlas_mode_s[2], atlas_mode_t[2];
     uint32_t tex_width[2], tex_height[2], tex_width2[2], tex_height2[2];
 
     for (int i = 0; i < 2; i++) {
         uint32_t tile = rdp.first_tile_index + i;
         if (comb->used_textures[i]) {
             if (rdp.textures_changed[i]) {
-                gfx_flush();
+                // Flushes only when the selected texture actually changes
                 import_texture(i, tile);
                 rdp.textures_changed[i] = false;
             }
@@ -1385,7 +1819,19 @@ static void gfx_sp_tri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx, bo
             }
 
             bool linear_filter = (rdp.other_mode_h & (3U << G_MDSFT_TEXTFILT)) != G_TF_POINT;
-            if (linear_filter != rendering_state.textures[i]->second.linear_filter ||
+            const TextureCacheValue& texture = rendering_state.textures[i]->second;
+            if (texture.atlas_page >= 0 && texture.texture_id == bound_texture_ids[i]) {
+                // Atlas pages always clamp, wrapping and mirroring inside the cell is done by the shader
+                struct AtlasPage* page = &texture_atlas.pages[texture.atlas_page];
+                if (linear_filter != page->linear_filter) {
+                    gfx_flush();
+                    gfx_rapi->set_sampler_parameters(i, linear_filter, G_TX_CLAMP, G_TX_CLAMP);
+                    page->linear_filter = linear_filter;
+                }
+                atlas_mask |= 1 << i;
+                atlas_mode_s[i] = (cms & G_TX_CLAMP) ? 2 : (cms & G_TX_MIRROR) ? 1 : 0;
+                atlas_mode_t[i] = (cmt & G_TX_CLAMP) ? 2 : (cmt & G_TX_MIRROR) ? 1 : 0;
+            } else if (linear_filter != rendering_state.textures[i]->second.linear_filter ||
                 cms != rendering_state.textures[i]->second.cms || cmt != rendering_state.textures[i]->second.cmt) {
                 gfx_flush();
                 gfx_rapi->set_sampler_parameters(i, linear_filter, cms, cmt);
@@ -1396,10 +1842,17 @@ static void gfx_sp_tri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx, bo
         }
     }
 
-    struct ShaderProgram* prg = comb->prg[tm];
+    uint32_t prg_index = tm | atlas_mask << 4;
+    struct ShaderProgram* prg = comb->prg[prg_index];
+    struct VertexEmissionPlan* plan = &comb->plans[prg_index];
     if (prg == NULL) {
-        comb->prg[tm] = prg =
-            gfx_lookup_or_create_shader_program(comb->shader_id0, comb->shader_id1 | (tm * SHADER_OPT_TEXEL0_CLAMP_S));
+        comb->prg[prg_index] = prg = gfx_lookup_or_create_shader_program(
+            comb->shader_id0,
+            comb->shader_id1 | (tm * SHADER_OPT_TEXEL0_CLAMP_S) | (atlas_mask * SHADER_OPT_TEXEL0_ATLAS));
+        gfx_rapi->shader_get_info(prg, &plan->num_inputs, plan->used_textures);
+        plan->atlas[0] = atlas_mask & 1;
+        plan->atlas[1] = atlas_mask & 2;
+        plan->emit = triangle_emitters[(use_alpha ? 1 : 0) | (use_fog ? 2 : 0) | (use_grayscale ? 4 : 0)];
     }
     if (prg != rendering_state.shader_program) {
         gfx_flush();
@@ -1412,188 +1865,128 @@ static void gfx_sp_tri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx, bo
         gfx_rapi->set_use_alpha(use_alpha);
         rendering_state.alpha_blend = use_alpha;
     }
-    uint8_t num_inputs;
-    bool used_textures[2];
-
-    gfx_rapi->shader_get_info(prg, &num_inputs, used_textures);
+    if (buf_vbo_num_tris == 0) {
+        // Only changes along with the framebuffer, which always flushes first.
+        rendering_state.clip_parameters = gfx_rapi->get_clip_parameters();
+    }
 
-    struct GfxClipParameters clip_parameters = gfx_rapi->get_clip_parameters();
+    struct TriangleSetup tri;
+    tri.clip = rendering_state.clip_parameters;
 
-    for (int i = 0; i < 3; i++) {
-        float z = v_arr[i]->z, w = v_arr[i]->w;
-        if (clip_parameters.z_is_from_0_to_1) {
-            z = (z + w) / 2.0f;
+    for (int t = 0; t < 2; t++) {
+        if (!plan->used_textures[t]) {
+            continue;
         }
 
-        buf_vbo[buf_vbo_len++] = v_arr[i]->x;
-        buf_vbo[buf_vbo_len++] = clip_parameters.invert_y ? -v_arr[i]->y : v_arr[i]->y;
-        buf_vbo[buf_vbo_len++] = z;
-        buf_vbo[buf_vbo_len++] = w;
-
-        for (int t = 0; t < 2; t++) {
-            if (!used_textures[t]) {
-                continue;
-            }
-            float u = v_arr[i]->u / 32.0f;
-            float v = v_arr[i]->v / 32.0f;
-
-            int shifts = rdp.texture_tile[rdp.first_tile_index + t].shifts;
-            int shiftt = rdp.texture_tile[rdp.first_tile_index + t].shiftt;
-            if (shifts != 0) {
-                if (shifts <= 10) {
-                    u /= 1 << shifts;
-                } else {
-                    u *= 1 << (16 - shifts);
-                }
-            }
-            if (shiftt != 0) {
-                if (shiftt <= 10) {
-                    v /= 1 << shiftt;
-                } else {
-                    v *= 1 << (16 - shiftt);
-                }
-            }
-
-            u -= rdp.texture_tile[rdp.first_tile_index + t].uls / 4.0f;
-            v -= rdp.texture_tile[rdp.first_tile_index + t].ult / 4.0f;
+        const auto& tile = rdp.texture_tile[rdp.first_tile_index + t];
+        float s_scale = 1.0f / 32.0f;
+        float t_scale = 1.0f / 32.0f;
+        if (tile.shifts != 0) {
+            s_scale = tile.shifts <= 10 ? s_scale / (1 << tile.shifts) : s_scale * (1 << (16 - tile.shifts));
+        }
+        if (tile.shiftt != 0) {
+            t_scale = tile.shiftt <= 10 ? t_scale / (1 << tile.shiftt) : t_scale * (1 << (16 - tile.shiftt));
+        }
 
-            if ((rdp.other_mode_h & (3U << G_MDSFT_TEXTFILT)) != G_TF_POINT) {
-                // Linear filter adds 0.5f to the coordinates
-                if (!is_rect) {
-                    u += 0.5f;
-                    v += 0.5f;
-                }
+        float u_offset = -tile.uls / 4.0f;
+        float v_offset = -tile.ult / 4.0f;
+        if ((rdp.other_mode_h & (3U << G_MDSFT_TEXTFILT)) != G_TF_POINT) {
+            // Linear filter adds 0.5f to the coordinates
+            if (!is_rect) {
+                u_offset += 0.5f;
+                v_offset += 0.5f;
             }
+        }
 
-            buf_vbo[buf_vbo_len++] = u / tex_width[t];
-            buf_vbo[buf_vbo_len++] = v / tex_height[t];
-
-            bool clampS = tm & (1 << 2 * t);
-            bool clampT = tm & (1 << 2 * t + 1);
-
-            if (clampS) {
-                buf_vbo[buf_vbo_len++] = (tex_width2[t] - 0.5f) / tex_width[t];
-            }
-#ifdef __WIIU__
-            else {
-                buf_vbo[buf_vbo_len++] = 0.0f;
-            }
-#endif
-            if (clampT) {
-                buf_vbo[buf_vbo_len++] = (tex_height2[t] - 0.5f) / tex_height[t];
-            }
-#ifdef __WIIU__
-            else {
-                buf_vbo[buf_vbo_len++] = 0.0f;
-            }
-#endif
+        tri.u_scale[t] = s_scale / tex_width[t];
+        tri.v_scale[t] = t_scale / tex_height[t];
+        tri.u_offset[t] = u_offset / tex_width[t];
+        tri.v_offset[t] = v_offset / tex_height[t];
+
+        tri.clamp_s[t] = tm & (1 << 2 * t);
+        tri.clamp_t[t] = tm & (1 << 2 * t + 1);
+        tri.clamp_s_value[t] = (tex_width2[t] - 0.5f) / tex_width[t];
+        tri.clamp_t_value[t] = (tex_height2[t] - 0.5f) / tex_height[t];
+
+        if (plan->atlas[t]) {
+            const float* rect = rendering_state.textures[t]->second.atlas_rect;
+            tri.atlas_rect[t][0] = rect[0] + 2 * atlas_mode_s[t];
+            tri.atlas_rect[t][1] = rect[1] + 2 * atlas_mode_t[t];
+            tri.atlas_rect[t][2] = rect[2];
+            tri.atlas_rect[t][3] = rect[3];
         }
+    }
 
-        if (use_fog) {
-            buf_vbo[buf_vbo_len++] = rdp.fog_color.r / 255.0f;
-            buf_vbo[buf_vbo_len++] = rdp.fog_color.g / 255.0f;
-            buf_vbo[buf_vbo_len++] = rdp.fog_color.b / 255.0f;
-            buf_vbo[buf_vbo_len++] = v_arr[i]->color.a / 255.0f; // fog factor (not alpha)
+    if (use_fog) {
+        tri.fog_color[0] = rdp.fog_color.r / 255.0f;
+        tri.fog_color[1] = rdp.fog_color.g / 255.0f;
+        tri.fog_color[2] = rdp.fog_color.b / 255.0f;
+    }
+
+    if (use_grayscale) {
+        tri.grayscale_color[0] = rdp.grayscale_color.r / 255.0f;
+        tri.grayscale_color[1] = rdp.grayscale_color.g / 255.0f;
+        tri.grayscale_color[2] = rdp.grayscale_color.b / 255.0f;
+        tri.grayscale_color[3] = rdp.grayscale_color.a / 255.0f;
+    }
+
+    for (int j = 0; j < plan->num_inputs; j++) {
+        struct RGBA tmp;
+        const struct RGBA* color = gfx_resolve_combiner_input(comb->shader_input_mapping[0][j], v1, &tmp);
+        tri.input_is_shade[j][0] = color == nullptr;
+        if (color != nullptr) {
+            tri.inputs[j][0] = color->r / 255.0f;
+            tri.inputs[j][1] = color->g / 255.0f;
+            tri.inputs[j][2] = color->b / 255.0f;
         }
 
-        if (use_grayscale) {
-            buf_vbo[buf_vbo_len++] = rdp.grayscale_color.r / 255.0f;
-            buf_vbo[buf_vbo_len++] = rdp.grayscale_color.g / 255.0f;
-            buf_vbo[buf_vbo_len++] = rdp.grayscale_color.b / 255.0f;
-            buf_vbo[buf_vbo_len++] = rdp.grayscale_color.a / 255.0f; // lerp interpolation factor (not alpha)
-        }
-
-        for (int j = 0; j < num_inputs; j++) {
-            struct RGBA* color = 0;
-            struct RGBA tmp;
-            for (int k = 0; k < 1 + (use_alpha ? 1 : 0); k++) {
-                switch (comb->shader_input_mapping[k][j]) {
-                        // Note: CCMUX constants and ACMUX constants used here have same value, which is why this works
-                        // (except LOD fraction).
-                    case G_CCMUX_PRIMITIVE:
-                        color = &rdp.prim_color;
-                        break;
-                    case G_CCMUX_SHADE:
-                        color = &v_arr[i]->color;
-                        break;
-                    case G_CCMUX_ENVIRONMENT:
-                        color = &rdp.env_color;
-                        break;
-                    case G_CCMUX_PRIMITIVE_ALPHA: {
-                        tmp.r = tmp.g = tmp.b = rdp.prim_color.a;
-                        color = &tmp;
-                        break;
-                    }
-                    case G_CCMUX_ENV_ALPHA: {
-                        tmp.r = tmp.g = tmp.b = rdp.env_color.a;
-                        color = &tmp;
-                        break;
-                    }
-                    case G_CCMUX_PRIM_LOD_FRAC: {
-                        tmp.r = tmp.g = tmp.b = rdp.prim_lod_fraction;
-                        color = &tmp;
-                        break;
-                    }
-                    case G_CCMUX_LOD_FRACTION: {
-                        if (rdp.other_mode_l & G_TL_LOD) {
-                            // "Hack" that works for Bowser - Peach painting
-                            float distance_frac = (v1->w - 3000.0f) / 3000.0f;
-                            if (distance_frac < 0.0f) {
-                                distance_frac = 0.0f;
-                            }
-                            if (distance_frac > 1.0f) {
-                                distance_frac = 1.0f;
-                            }
-                            tmp.r = tmp.g = tmp.b = tmp.a = distance_frac * 255.0f;
-                        } else {
-                            tmp.r = tmp.g = tmp.b = tmp.a = 255.0f;
-                        }
-                        color = &tmp;
-                        break;
-                    }
-                    case G_ACMUX_PRIM_LOD_FRAC:
-                        tmp.a = rdp.prim_lod_fraction;
-                        color = &tmp;
-                        break;
-                    default:
-                        memset(&tmp, 0, sizeof(tmp));
-                        color = &tmp;
-                        break;
-                }
-                if (k == 0) {
-                    buf_vbo[buf_vbo_len++] = color->r / 255.0f;
-                    buf_vbo[buf_vbo_len++] = color->g / 255.0f;
-                    buf_vbo[buf_vbo_len++] = color->b / 255.0f;
-#ifdef __WIIU__
-                    // padding
-                    if (!use_alpha) {
-                        buf_vbo[buf_vbo_len++] = 1.0f;
-                    }
-#endif
-                } else {
-                    if (use_fog && color == &v_arr[i]->color) {
-                        // Shade alpha is 100% for fog
-                        buf_vbo[buf_vbo_len++] = 1.0f;
-                    } else {
-                        buf_vbo[buf_vbo_len++] = color->a / 255.0f;
-                    }
-                }
+        if (use_alpha) {
+            color = gfx_resolve_combiner_input(comb->shader_input_mapping[1][j], v1, &tmp);
+            tri.input_is_shade[j][1] = color == nullptr;
+            if (color != nullptr) {
+                tri.inputs[j][3] = color->a / 255.0f;
             }
         }
-
-        // struct RGBA *color = &v_arr[i]->color;
-        // buf_vbo[buf_vbo_len++] = color->r / 255.0f;
-        // buf_vbo[buf_vbo_len++] = color->g / 255.0f;
-        // buf_vbo[buf_vbo_len++] = color->b / 255.0f;
-        // buf_vbo[buf_vbo_len++] = color->a / 255.0f;
     }
 
+    plan->emit(plan, v_arr, &tri);
+
     if (++buf_vbo_num_tris == MAX_BUFFERED) {
         // if (++buf_vbo_num_tris == 1) {
         gfx_flush();
     }
 }
 
+static void gfx_sp_tri1(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx, bool is_rect) {
+    struct LoadedVertex* v1 = &rsp.loaded_vertices[vtx1_idx];
+    struct LoadedVertex* v2 = &rsp.loaded_vertices[vtx2_idx];
+    struct LoadedVertex* v3 = &rsp.loaded_vertices[vtx3_idx];
+
+    if (!gfx_cull_triangle(v1, v2, v3)) {
+        gfx_draw_triangle(v1, v2, v3, is_rect);
+    }
+}
+
+// Both triangles of a G_TRI2/G_QUAD are tested before either is emitted, so the culling math for the pair runs
+// back to back and fully rejected pairs never touch the render state.
+static void gfx_sp_tri2(uint8_t vtx1_idx, uint8_t vtx2_idx, uint8_t vtx3_idx, uint8_t vtx4_idx, uint8_t vtx5_idx,
+                        uint8_t vtx6_idx) {
+    struct LoadedVertex* v[6] = { &rsp.loaded_vertices[vtx1_idx], &rsp.loaded_vertices[vtx2_idx],
+                                  &rsp.loaded_vertices[vtx3_idx], &rsp.loaded_vertices[vtx4_idx],
+                                  &rsp.loaded_vertices[vtx5_idx], &rsp.loaded_vertices[vtx6_idx] };
+    bool culled[2];
+
+    for (int i = 0; i < 2; i++) {
+        culled[i] = gfx_cull_triangle(v[i * 3 + 0], v[i * 3 + 1], v[i * 3 + 2]);
+    }
+
+    for (int i = 0; i < 2; i++) {
+        if (!culled[i]) {
+            gfx_draw_triangle(v[i * 3 + 0], v[i * 3 + 1], v[i * 3 + 2], false);
+        }
+    }
+}
+
 static void gfx_sp_geometry_mode(uint32_t clear, uint32_t set) {
     rsp.geometry_mode &= ~clear;
     rsp.geometry_mode |= set;
@@ -2024,6 +2417,12 @@ static void gfx_draw_rectangle(int32_t ulx, int32_t uly, int32_t lrx, int32_t lr
     ur->z = -1.0f;
     ur->w = 1.0f;
 
+    for (int i = 0; i < 4; i++) {
+        struct LoadedVertex* d = &rsp.loaded_vertices[MAX_VERTICES + i];
+        d->screen_x = d->x;
+        d->screen_y = d->y;
+    }
+
     // The coordinates for texture rectangle shall bypass the viewport setting
     struct XYWidthHeight default_viewport = { 0, SCREEN_HEIGHT, SCREEN_WIDTH, SCREEN_HEIGHT };
     struct XYWidthHeight viewport_saved = rdp.viewport;
@@ -2239,6 +2638,7 @@ static inline void* seg_addr(uintptr_t w1) {
 uintptr_t clearMtx;
 
 static void gfx_run_dl(Gfx* cmd) {
+    LUS_TRACE_SPAN("gfx_run_dl", "gfx");
     // puts("dl");
     int dummy = 0;
     char dlName[128];
@@ -2246,9 +2646,11 @@ static void gfx_run_dl(Gfx* cmd) {
 
     Gfx* dListStart = cmd;
     uint64_t ourHash = -1;
+    uint32_t parentInterpTag = interp.tag;
 
     for (;;) {
         uint32_t opcode = cmd->words.w0 >> 24;
+        interp.cmd = cmd;
         // uint32_t opcode = cmd->words.w0 & 0xFF;
 
         // if (markerOn)
@@ -2347,11 +2749,11 @@ static void gfx_run_dl(Gfx* cmd) {
                 break;
             case G_VTX:
 #ifdef F3DEX_GBI_2
-                gfx_sp_vertex(C0(12, 8), C0(1, 7) - C0(12, 8), (const Vtx*)seg_addr(cmd->words.w1));
+                gfx_sp_vertex(C0(12, 8), C0(1, 7) - C0(12, 8), (const Vtx*)seg_addr(cmd->words.w1), true);
 #elif defined(F3DEX_GBI) || defined(F3DLP_GBI)
-                gfx_sp_vertex(C0(10, 6), C0(16, 8) / 2, seg_addr(cmd->words.w1));
+                gfx_sp_vertex(C0(10, 6), C0(16, 8) / 2, seg_addr(cmd->words.w1), true);
 #else
-                gfx_sp_vertex((C0(0, 16)) / sizeof(Vtx), C0(16, 4), seg_addr(cmd->words.w1));
+                gfx_sp_vertex((C0(0, 16)) / sizeof(Vtx), C0(16, 4), seg_addr(cmd->words.w1), true);
 #endif
                 break;
             case G_VTX_OTR_HASH: {
@@ -2488,6 +2890,7 @@ static void gfx_run_dl(Gfx* cmd) {
                 // printf("END DL ON MARKER\n");
 
                 markerOn = false;
+                interp.tag = parentInterpTag;
                 return;
 #ifdef F3DEX_GBI_2
             case G_GEOMETRYMODE:
@@ -2523,8 +2926,7 @@ static void gfx_run_dl(Gfx* cmd) {
 #endif
 #if defined(F3DEX_GBI) || defined(F3DLP_GBI)
             case (uint8_t)G_TRI2:
-                gfx_sp_tri1(C0(16, 8) / 2, C0(8, 8) / 2, C0(0, 8) / 2, false);
-                gfx_sp_tri1(C1(16, 8) / 2, C1(8, 8) / 2, C1(0, 8) / 2, false);
+                gfx_sp_tri2(C0(16, 8) / 2, C0(8, 8) / 2, C0(0, 8) / 2, C1(16, 8) / 2, C1(8, 8) / 2, C1(0, 8) / 2);
                 break;
 #endif
             case (uint8_t)G_SETOTHERMODE_L:
@@ -2677,6 +3079,7 @@ static void gfx_run_dl(Gfx* cmd) {
             case G_SETTIMG_FB: {
                 gfx_flush();
                 gfx_rapi->select_texture_fb(cmd->words.w1);
+                bound_texture_ids[0] = UINT32_MAX;
                 rdp.textures_changed[0] = false;
                 rdp.textures_changed[1] = false;
 
@@ -2688,6 +3091,9 @@ static void gfx_run_dl(Gfx* cmd) {
                 rdp.grayscale = cmd->words.w1;
                 break;
             }
+            case G_INTERP_TAG:
+                interp.tag = cmd->words.w1;
+                break;
             case G_LOADBLOCK:
                 gfx_dp_load_block(C1(24, 3), C0(12, 12), C0(0, 12), C1(12, 12), C1(0, 12));
                 break;
@@ -2848,7 +3254,13 @@ void gfx_init(struct GfxWindowManagerAPI* wapi, struct GfxRenderingAPI* rapi, co
 #else
     gfx_current_dimensions.internal_mul = CVarGetFloat("gInternalResolution", 1);
 #endif
+    // The only path that applies these, SohImGui::SetResolutionMultiplier and SetMSAALevel just set the CVars
+    CVarRegisterChangeCallback("gInternalResolution", [](const char* name) {
+        gfx_current_dimensions.internal_mul = CVarGetFloat(name, 1);
+    });
     gfx_msaa_level = CVarGetInteger("gMSAAValue", 1);
+    CVarRegisterChangeCallback("gMSAAValue", [](const char* name) { gfx_msaa_level = CVarGetInteger(name, 1); });
+    texture_atlas.enabled = CVarGetInteger("gTextureAtlas", 0) != 0 && gfx_rapi->upload_texture_region != nullptr;
 #ifndef __WIIU__ // Wii U overrides dimentions in gfx_wapi->init to match framebuffer size
     gfx_current_dimensions.width = width;
     gfx_current_dimensions.height = height;
@@ -2924,6 +3336,7 @@ void gfx_start_frame(void) {
 }
 
 void gfx_run(Gfx* commands, const std::unordered_map<Mtx*, MtxF>& mtx_replacements) {
+    LUS_TRACE_SPAN("gfx_run", "gfx");
     gfx_sp_reset();
 
     // puts("New frame");
@@ -2957,8 +3370,14 @@ void gfx_run(Gfx* commands, const std::unordered_map<Mtx*, MtxF>& mtx_replacemen
     rdp.viewport_or_scissor_changed = true;
     rendering_state.viewport = {};
     rendering_state.scissor = {};
+    triangle_stats = {};
+    // Textures may have been selected outside of the display list since the last frame
+    bound_texture_ids[0] = UINT32_MAX;
+    bound_texture_ids[1] = UINT32_MAX;
     gfx_run_dl(commands);
     gfx_flush();
+    last_frame_triangle_stats = triangle_stats;
+    Ship::ExecuteHooks<Ship::GfxTaskDone>();
     gfxFramebuffer = 0;
     currentDir = std::stack<std::string>();
 
@@ -2987,11 +3406,40 @@ void gfx_run(Gfx* commands, const std::unordered_map<Mtx*, MtxF>& mtx_replacemen
     has_drawn_imgui_menu = false;
 }
 
+void gfx_interpolation_new_tick(void) {
+    std::swap(interp.previous, interp.current);
+    interp.current.matrices.clear();
+    interp.current.vertices.clear();
+    interp.capturing = true;
+}
+
+void gfx_run_interpolated(Gfx* commands, float t) {
+    static const std::unordered_map<Mtx*, MtxF> no_replacements;
+
+    interp.active = true;
+    interp.t = Ship::Math::clamp(t, 0.0f, 1.0f);
+    interp.tag = 0;
+    interp.occurrences.clear();
+    gfx_run(commands, no_replacements);
+    interp.active = false;
+
+    // A dropped frame never walked the display list, so keep capturing until a run actually does.
+    if (!dropped_frame) {
+        interp.capturing = false;
+    }
+}
+
 void gfx_end_frame(void) {
+    LUS_TRACE_SPAN("gfx_end_frame", "gfx");
     if (!dropped_frame) {
         gfx_rapi->finish_render();
         gfx_wapi->swap_buffers_end();
     }
+    Ship::ExecuteHooks<Ship::GfxFrameEnd>();
+}
+
+void gfx_get_triangle_stats(struct GfxTriangleStats* stats) {
+    *stats = last_frame_triangle_stats;
 }
 
 void gfx_set_target_fps(int fps) {
@@ -3012,11 +3460,13 @@ int gfx_create_framebuffer(uint32_t width, uint32_t height) {
 }
 
 void gfx_set_framebuffer(int fb, float noise_scale) {
+    gfx_flush();
     gfx_rapi->start_draw_to_framebuffer(fb, noise_scale);
     gfx_rapi->clear_framebuffer();
 }
 
 void gfx_reset_framebuffer() {
+    gfx_flush();
     gfx_rapi->start_draw_to_framebuffer(0, (float)gfx_current_dimensions.height / SCREEN_HEIGHT);
 }
 
@@ -36,6 +36,8 @@ struct TextureCacheKey {
     const uint8_t* palette_addrs[2];
     uint8_t fmt, siz;
     uint8_t palette_index;
+    // Bit 0 and 1 are set when S and T wrap and the texture atlas is on, an atlas cell's border depends on them
+    uint8_t atlas_wrap;
 
     bool operator==(const TextureCacheKey&) const noexcept = default;
 
@@ -54,6 +56,10 @@ struct TextureCacheValue {
     uint32_t texture_id;
     uint8_t cms, cmt;
     bool linear_filter;
+    // Set when the texture lives in a cell of a texture atlas page, texture_id is then the id of the page
+    int32_t atlas_page;
+    uint16_t atlas_cell;
+    float atlas_rect[4];
 
     std::list<struct TextureCacheMapIter>::iterator lru_location;
 };
@@ -62,6 +68,15 @@ struct TextureCacheMapIter {
     TextureCacheMap::iterator it;
 };
 
+// Triangle and draw call counts of the last rendered frame
+struct GfxTriangleStats {
+    uint32_t submitted;
+    uint32_t clip_rejected;
+    uint32_t culled;
+    uint32_t drawn;
+    uint32_t draw_calls;
+};
+
 extern "C" {
 
 extern struct GfxDimensions gfx_current_window_dimensions; // The dimensions of the window
@@ -77,7 +92,14 @@ void gfx_init(struct GfxWindowManagerAPI* wapi, struct GfxRenderingAPI* rapi, co
 struct GfxRenderingAPI* gfx_get_current_rendering_api(void);
 void gfx_start_frame(void);
 void gfx_run(Gfx* commands, const std::unordered_map<Mtx*, MtxF>& mtx_replacements);
+// Starts a new game tick, the next gfx_run_interpolated call captures its matrices and dynamic vertices.
+void gfx_interpolation_new_tick(void);
+// Renders the display list of the current tick blended towards the previous tick, t = 1 is the current tick.
+// The display list must stay valid until the next tick starts. Loads pair up with the previous tick by their
+// gSPInterpolationTag, untagged ones only when the command and the data are at the same address as in the last tick.
+void gfx_run_interpolated(Gfx* commands, float t);
 void gfx_end_frame(void);
+void gfx_get_triangle_stats(struct GfxTriangleStats* stats);
 void gfx_set_target_fps(int);
 void gfx_set_maximum_frame_latency(int latency);
 extern "C" void gfx_texture_cache_clear();
@@ -67,6 +67,9 @@ struct GfxRenderingAPI {
     void (*delete_texture)(uint32_t texID);
     void (*set_texture_filter)(FilteringMode mode);
     FilteringMode (*get_texture_filter)(void);
+    // Optional. Uploads into a region of the selected texture, backends that leave it null get no texture atlas.
+    void (*upload_texture_region)(const uint8_t* rgba32_buf, uint32_t x, uint32_t y, uint32_t width,
+                                  uint32_t height);
 };
 
 #endif
@@ -33,6 +33,7 @@
 
 #include "gfx_window_manager_api.h"
 #include "gfx_screen_config.h"
+#include "gfx_pacing.h"
 #ifdef _WIN32
 #include <WTypesbase.h>
 #endif
@@ -246,11 +247,29 @@ static void gfx_sdl_get_active_window_refresh_rate(uint32_t* refresh_rate) {
     *refresh_rate = mode.refresh_rate;
 }
 
-static uint64_t previous_time;
 #ifdef _WIN32
 static HANDLE timer;
 #endif
 
+static uint64_t qpc_to_ns(void* user) {
+    const uint64_t qpc = SDL_GetPerformanceCounter();
+    const uint64_t qpc_freq = SDL_GetPerformanceFrequency();
+    return qpc / qpc_freq * 1000000000 + qpc % qpc_freq * 1000000000 / qpc_freq;
+}
+
+static void sleep_ns(void* user, uint64_t duration_ns) {
+#ifndef _WIN32
+    const timespec spec = { (time_t)(duration_ns / 1000000000), (long)(duration_ns % 1000000000) };
+    nanosleep(&spec, nullptr);
+#else
+    // The accuracy of this timer seems to usually be within +- 1.0 ms, the pacer spins away the rest.
+    LARGE_INTEGER li;
+    li.QuadPart = -(LONGLONG)(duration_ns / 100);
+    SetWaitableTimer(timer, &li, 0, nullptr, nullptr, false);
+    WaitForSingleObject(timer, INFINITE);
+#endif
+}
+
 #ifdef __vita__
 #include <vitasdk.h>
 extern "C" {
@@ -258,11 +277,6 @@ GLboolean vglInitExtended(int legacy_pool_size, int width, int height, int ram_t
 };
 #endif
 
-static int target_fps = 60;
-
-#define FRAME_INTERVAL_US_NUMERATOR 1000000
-#define FRAME_INTERVAL_US_DENOMINATOR (target_fps)
-
 static void gfx_sdl_init(const char* game_name, const char* gfx_api_name, bool start_in_fullscreen, uint32_t width,
                          uint32_t height) {
 #ifdef __vita__
@@ -300,6 +314,9 @@ static void gfx_sdl_init(const char* game_name, const char* gfx_api_name, bool s
     timer = CreateWaitableTimer(nullptr, false, nullptr);
 #endif
 
+    const struct GfxPacingClock pacing_clock = { qpc_to_ns, sleep_ns, nullptr };
+    gfx_pacing_init(&pacing_clock);
+
     char title[512];
     int len = sprintf(title, "%s (%s - %s)", game_name, GFX_BACKEND_NAME, gfx_api_name);
 
@@ -499,43 +516,10 @@ static bool gfx_sdl_start_frame(void) {
     return true;
 }
 
-static uint64_t qpc_to_100ns(uint64_t qpc) {
-    const uint64_t qpc_freq = SDL_GetPerformanceFrequency();
-    return qpc / qpc_freq * 10000000 + qpc % qpc_freq * 10000000 / qpc_freq;
-}
-
-static inline void sync_framerate_with_timer(void) {
-    uint64_t t;
-    t = qpc_to_100ns(SDL_GetPerformanceCounter());
-
-    const int64_t next = previous_time + 10 * FRAME_INTERVAL_US_NUMERATOR / FRAME_INTERVAL_US_DENOMINATOR;
-    const int64_t left = next - t;
-    if (left > 0) {
-#ifndef _WIN32
-        const timespec spec = { 0, left * 100 };
-        nanosleep(&spec, nullptr);
-#else
-        // The accuracy of this timer seems to usually be within +- 1.0 ms
-        LARGE_INTEGER li;
-        li.QuadPart = -left;
-        SetWaitableTimer(timer, &li, 0, nullptr, nullptr, false);
-        WaitForSingleObject(timer, INFINITE);
-#endif
-    }
-
-    t = qpc_to_100ns(SDL_GetPerformanceCounter());
-    if (left > 0 && t - next < 10000) {
-        // In case it takes some time for the application to wake up after sleep,
-        // or inaccurate timer,
-        // don't let that slow down the framerate.
-        t = next;
-    }
-    previous_time = t;
-}
-
 static void gfx_sdl_swap_buffers_begin(void) {
-    sync_framerate_with_timer();
+    gfx_pacing_wait();
     SDL_GL_SwapWindow(wnd);
+    gfx_pacing_present_done();
 }
 
 static void gfx_sdl_swap_buffers_end(void) {
@@ -546,7 +530,7 @@ static double gfx_sdl_get_time(void) {
 }
 
 static void gfx_sdl_set_target_fps(int fps) {
-    target_fps = fps;
+    gfx_pacing_set_target_fps(fps);
 }
 
 static void gfx_sdl_set_maximum_frame_latency(int latency) {
@@ -0,0 +1,700 @@
+#include "log/lustrace.h"
+#include <spdlog/spdlog.h>
+#include "menu/ImGuiImpl.h"
+#include "menu/Console.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdarg.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Per thread record buffer, a power of two
+#define LUSTRACE_BUFFER_SIZE (256 * 1024)
+#define LUSTRACE_DRAIN_INTERVAL_MS 10
+// Strings are copied into the record since the pointer may be gone by the time it is formatted
+#define LUSTRACE_MAX_STRING 255
+#define LUSTRACE_FILE_MAGIC "LUST"
+#define LUSTRACE_FILE_VERSION 1
+#define LUSTRACE_CHUNK_SITE 'S'
+#define LUSTRACE_CHUNK_RECORD 'R'
+
+enum TraceArgType : uint8_t { TRACE_ARG_INT, TRACE_ARG_UINT, TRACE_ARG_DOUBLE, TRACE_ARG_STRING, TRACE_ARG_POINTER };
+
+// Record layout: u32 size of the whole record, u32 site id, u64 timestamp in ns, then one entry per argument made of the
+// type byte and 8 bytes of value, or for strings a length byte and the characters.
+struct TraceRecordHeader {
+    uint32_t Size;
+    uint32_t Site;
+    uint64_t Timestamp;
+};
+
+struct TraceSite {
+    std::string File;
+    int32_t Line;
+    std::string Format;
+};
+
+// Single producer (the owning thread), single consumer (the drain). Records are written whole or not at all.
+struct TraceBuffer {
+    uint8_t Data[LUSTRACE_BUFFER_SIZE];
+    alignas(64) std::atomic<size_t> ReadPos = 0;
+    alignas(64) std::atomic<size_t> WritePos = 0;
+    std::atomic<bool> Retired = false;
+};
+
+struct TraceState {
+    std::atomic<bool> Enabled = false;
+    std::atomic<uint64_t> Dropped = 0;
+
+    std::mutex SitesMutex;
+    std::map<std::pair<const char*, int32_t>, uint32_t> SiteIds;
+    std::vector<TraceSite> Sites;
+
+    std::mutex BuffersMutex;
+    std::vector<std::shared_ptr<TraceBuffer>> Buffers;
+
+    // Held while draining, also guards the output file and which sites it has seen
+    std::mutex DrainMutex;
+    FILE* File = nullptr;
+    size_t SitesWritten = 0;
+
+    std::thread DrainThread;
+    std::mutex WakeMutex;
+    std::condition_variable Wake;
+    bool Stopping = false;
+
+    ~TraceState();
+};
+
+static TraceState sTrace;
+
+static void Drain();
+
+TraceState::~TraceState() {
+    if (DrainThread.joinable()) {
+        {
+            const std::lock_guard<std::mutex> lock(WakeMutex);
+            Stopping = true;
+        }
+        Wake.notify_all();
+        DrainThread.join();
+    }
+
+    // The logger may already be gone at this point, only a file still gets the remaining records
+    if (File != nullptr) {
+        Drain();
+        fclose(File);
+    }
+}
+
+static void DrainThreadMain() {
+    std::unique_lock<std::mutex> lock(sTrace.WakeMutex);
+    while (!sTrace.Stopping) {
+        sTrace.Wake.wait_for(lock, std::chrono::milliseconds(LUSTRACE_DRAIN_INTERVAL_MS));
+        if (sTrace.Stopping) {
+            break;
+        }
+        lock.unlock();
+        Drain();
+        lock.lock();
+    }
+}
+
+struct ThreadTraceBuffer {
+    std::shared_ptr<TraceBuffer> Buffer;
+    std::map<std::pair<const char*, int32_t>, uint32_t> SiteCache;
+
+    ~ThreadTraceBuffer() {
+        if (Buffer != nullptr) {
+            // The drain removes it once everything in it was read
+            Buffer->Retired = true;
+        }
+    }
+};
+
+static thread_local ThreadTraceBuffer tThreadBuffer;
+
+static TraceBuffer* GetThreadBuffer() {
+    if (tThreadBuffer.Buffer == nullptr) {
+        tThreadBuffer.Buffer = std::make_shared<TraceBuffer>();
+        const std::lock_guard<std::mutex> lock(sTrace.BuffersMutex);
+        sTrace.Buffers.push_back(tThreadBuffer.Buffer);
+    }
+
+    return tThreadBuffer.Buffer.get();
+}
+
+static uint32_t GetSiteId(const char* file, int32_t line, const char* fmt) {
+    const auto key = std::make_pair(fmt, line);
+    auto cached = tThreadBuffer.SiteCache.find(key);
+    if (cached != tThreadBuffer.SiteCache.end()) {
+        return cached->second;
+    }
+
+    const std::lock_guard<std::mutex> lock(sTrace.SitesMutex);
+    auto it = sTrace.SiteIds.find(key);
+    uint32_t id;
+    if (it != sTrace.SiteIds.end()) {
+        id = it->second;
+    } else {
+        id = sTrace.Sites.size();
+        sTrace.Sites.push_back({ file, line, fmt });
+        sTrace.SiteIds[key] = id;
+    }
+
+    tThreadBuffer.SiteCache[key] = id;
+    return id;
+}
+
+// One printf conversion, split into the parts needed to record it and to format it again
+struct FormatSpec {
+    // Flags, width and precision as written, with '*' replaced at format time
+    std::string Prefix;
+    int StarCount;
+    // Length modifier as written, e.g. "ll" or "h"
+    std::string Length;
+    char Conversion;
+};
+
+// Parses the conversion starting at fmt (just past the '%'). Returns the position after it.
+static const char* ParseSpec(const char* fmt, FormatSpec& spec) {
+    spec.Prefix.clear();
+    spec.Length.clear();
+    spec.StarCount = 0;
+    spec.Conversion = 0;
+
+    while (*fmt != '\0' && strchr("-+ #0", *fmt) != nullptr) {
+        spec.Prefix += *fmt++;
+    }
+    while (*fmt == '*' || (*fmt >= '0' && *fmt <= '9')) {
+        spec.StarCount += *fmt == '*';
+        spec.Prefix += *fmt++;
+    }
+    if (*fmt == '.') {
+        spec.Prefix += *fmt++;
+        while (*fmt == '*' || (*fmt >= '0' && *fmt <= '9')) {
+            spec.StarCount += *fmt == '*';
+            spec.Prefix += *fmt++;
+        }
+    }
+    while (*fmt != '\0' && strchr("hljztL", *fmt) != nullptr) {
+        spec.Length += *fmt++;
+    }
+    if (*fmt != '\0') {
+        spec.Conversion = *fmt++;
+    }
+
+    return fmt;
+}
+
+static bool IsIntegerConversion(char conversion) {
+    return conversion != '\0' && strchr("diouxX", conversion) != nullptr;
+}
+
+static TraceArgType ArgTypeFor(char conversion) {
+    switch (conversion) {
+        case 'd':
+        case 'i':
+        case 'c':
+            return TRACE_ARG_INT;
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+            return TRACE_ARG_UINT;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+            return TRACE_ARG_DOUBLE;
+        case 's':
+            return TRACE_ARG_STRING;
+        default:
+            return TRACE_ARG_POINTER;
+    }
+}
+
+static void PutArg(std::vector<uint8_t>& out, TraceArgType type, uint64_t value) {
+    out.push_back(type);
+    const size_t pos = out.size();
+    out.resize(pos + sizeof(value));
+    memcpy(out.data() + pos, &value, sizeof(value));
+}
+
+static int64_t GetSigned(const std::string& length, va_list* args) {
+    if (length == "ll") {
+        return va_arg(*args, long long);
+    } else if (length == "l") {
+        return va_arg(*args, long);
+    } else if (length == "j") {
+        return va_arg(*args, intmax_t);
+    } else if (length == "z" || length == "t") {
+        return va_arg(*args, ptrdiff_t);
+    }
+
+    const int value = va_arg(*args, int);
+    return length == "hh" ? (signed char)value : length == "h" ? (short)value : value;
+}
+
+static uint64_t GetUnsigned(const std::string& length, va_list* args) {
+    if (length == "ll") {
+        return va_arg(*args, unsigned long long);
+    } else if (length == "l") {
+        return va_arg(*args, unsigned long);
+    } else if (length == "j") {
+        return va_arg(*args, uintmax_t);
+    } else if (length == "z" || length == "t") {
+        return va_arg(*args, size_t);
+    }
+
+    const unsigned int value = va_arg(*args, unsigned int);
+    return length == "hh" ? (unsigned char)value : length == "h" ? (unsigned short)value : value;
+}
+
+static void EncodeArgs(const char* fmt, va_list argList, std::vector<uint8_t>& out) {
+    // A copy so it can be passed on by pointer, va_list may be an array type
+    va_list args;
+    va_copy(args, argList);
+    FormatSpec spec;
+    while (*fmt != '\0') {
+        if (*fmt++ != '%') {
+            continue;
+        }
+        if (*fmt == '%') {
+            fmt++;
+            continue;
+        }
+
+        fmt = ParseSpec(fmt, spec);
+        for (int i = 0; i < spec.StarCount; i++) {
+            PutArg(out, TRACE_ARG_INT, (uint64_t)(int64_t)va_arg(args, int));
+        }
+
+        switch (ArgTypeFor(spec.Conversion)) {
+            case TRACE_ARG_INT:
+                PutArg(out, TRACE_ARG_INT, (uint64_t)GetSigned(spec.Length, &args));
+                break;
+            case TRACE_ARG_UINT:
+                PutArg(out, TRACE_ARG_UINT, GetUnsigned(spec.Length, &args));
+                break;
+            case TRACE_ARG_DOUBLE: {
+                // Long doubles lose their extra precision
+                const double value = spec.Length == "L" ? (double)va_arg(args, long double) : va_arg(args, double);
+                uint64_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                PutArg(out, TRACE_ARG_DOUBLE, bits);
+                break;
+            }
+            case TRACE_ARG_STRING: {
+                const char* str = va_arg(args, const char*);
+                if (str == nullptr) {
+                    str = "(null)";
+                }
+                const size_t len = std::min<size_t>(strlen(str), LUSTRACE_MAX_STRING);
+                out.push_back(TRACE_ARG_STRING);
+                out.push_back((uint8_t)len);
+                out.insert(out.end(), str, str + len);
+                break;
+            }
+            case TRACE_ARG_POINTER:
+                // %p, and %n which is never written through
+                PutArg(out, TRACE_ARG_POINTER, (uint64_t)(uintptr_t)va_arg(args, void*));
+                break;
+        }
+    }
+    va_end(args);
+}
+
+// Reads the next argument written by EncodeArgs. Returns false when the record has no more arguments.
+static bool NextArg(const uint8_t*& pos, const uint8_t* end, TraceArgType& type, uint64_t& value, std::string& str) {
+    if (pos >= end) {
+        return false;
+    }
+
+    type = (TraceArgType)*pos++;
+    if (type == TRACE_ARG_STRING) {
+        const size_t len = pos < end ? *pos++ : 0;
+        str.assign((const char*)pos, std::min<size_t>(len, end - pos));
+        pos += len;
+        return true;
+    }
+
+    value = 0;
+    if (end - pos >= (ptrdiff_t)sizeof(value)) {
+        memcpy(&value, pos, sizeof(value));
+    }
+    pos += sizeof(value);
+    return true;
+}
+
+static std::string FormatRecord(const std::string& fmtString, const uint8_t* args, const uint8_t* end) {
+    std::string result;
+    const char* fmt = fmtString.c_str();
+    FormatSpec spec;
+    char buf[512];
+
+    while (*fmt != '\0') {
+        if (*fmt != '%') {
+            result += *fmt++;
+            continue;
+        }
+        fmt++;
+        if (*fmt == '%') {
+            result += *fmt++;
+            continue;
+        }
+
+        fmt = ParseSpec(fmt, spec);
+        TraceArgType type;
+        uint64_t value = 0;
+        std::string str;
+
+        // Substitute recorded '*' values into the spec
+        std::string prefix;
+        for (char c : spec.Prefix) {
+            if (c == '*' && NextArg(args, end, type, value, str)) {
+                prefix += std::to_string((int64_t)value);
+            } else {
+                prefix += c;
+            }
+        }
+
+        if (!NextArg(args, end, type, value, str)) {
+            result += "<missing>";
+            continue;
+        }
+
+        const std::string conversion = "%" + prefix;
+        switch (type) {
+            case TRACE_ARG_INT:
+            case TRACE_ARG_UINT:
+                // Only the integer conversions take a long long, %c gets the int it was passed as
+                if (spec.Conversion == 'c') {
+                    snprintf(buf, sizeof(buf), (conversion + "c").c_str(), (int)value);
+                } else if (!IsIntegerConversion(spec.Conversion)) {
+                    snprintf(buf, sizeof(buf), "%lld", (long long)value);
+                } else if (type == TRACE_ARG_INT) {
+                    snprintf(buf, sizeof(buf), (conversion + "ll" + spec.Conversion).c_str(), (long long)value);
+                } else {
+                    snprintf(buf, sizeof(buf), (conversion + "ll" + spec.Conversion).c_str(),
+                             (unsigned long long)value);
+                }
+                break;
+            case TRACE_ARG_DOUBLE: {
+                double d;
+                memcpy(&d, &value, sizeof(d));
+                snprintf(buf, sizeof(buf), (conversion + spec.Conversion).c_str(), d);
+                break;
+            }
+            case TRACE_ARG_STRING:
+                snprintf(buf, sizeof(buf), (conversion + "s").c_str(), str.c_str());
+                break;
+            case TRACE_ARG_POINTER:
+            default:
+                snprintf(buf, sizeof(buf), "0x%llx", (unsigned long long)value);
+                break;
+        }
+        result += buf;
+    }
+
+    return result;
+}
+
+static void WriteSitesToFile() {
+    std::vector<TraceSite> sites;
+    {
+        const std::lock_guard<std::mutex> lock(sTrace.SitesMutex);
+        sites.assign(sTrace.Sites.begin() + sTrace.SitesWritten, sTrace.Sites.end());
+    }
+
+    for (const auto& site : sites) {
+        const uint32_t id = sTrace.SitesWritten++;
+        const uint16_t fileLen = site.File.size();
+        const uint16_t formatLen = site.Format.size();
+        fputc(LUSTRACE_CHUNK_SITE, sTrace.File);
+        fwrite(&id, sizeof(id), 1, sTrace.File);
+        fwrite(&site.Line, sizeof(site.Line), 1, sTrace.File);
+        fwrite(&fileLen, sizeof(fileLen), 1, sTrace.File);
+        fwrite(site.File.data(), 1, fileLen, sTrace.File);
+        fwrite(&formatLen, sizeof(formatLen), 1, sTrace.File);
+        fwrite(site.Format.data(), 1, formatLen, sTrace.File);
+    }
+}
+
+static void Drain() {
+    const std::lock_guard<std::mutex> drainLock(sTrace.DrainMutex);
+
+    std::vector<std::shared_ptr<TraceBuffer>> buffers;
+    {
+        const std::lock_guard<std::mutex> lock(sTrace.BuffersMutex);
+        buffers = sTrace.Buffers;
+    }
+
+    // Collect everything that is there right now, then order it by time across threads
+    std::vector<std::vector<uint8_t>> records;
+    for (const auto& buffer : buffers) {
+        const bool retired = buffer->Retired;
+        size_t read = buffer->ReadPos.load(std::memory_order_relaxed);
+        const size_t write = buffer->WritePos.load(std::memory_order_acquire);
+
+        while (read != write) {
+            TraceRecordHeader header;
+            for (size_t i = 0; i < sizeof(header); i++) {
+                ((uint8_t*)&header)[i] = buffer->Data[(read + i) & (LUSTRACE_BUFFER_SIZE - 1)];
+            }
+            std::vector<uint8_t> record(header.Size);
+            for (size_t i = 0; i < header.Size; i++) {
+                record[i] = buffer->Data[(read + i) & (LUSTRACE_BUFFER_SIZE - 1)];
+            }
+            records.push_back(std::move(record));
+            read += header.Size;
+        }
+        buffer->ReadPos.store(read, std::memory_order_release);
+
+        if (retired) {
+            const std::lock_guard<std::mutex> lock(sTrace.BuffersMutex);
+            std::erase(sTrace.Buffers, buffer);
+        }
+    }
+
+    if (records.empty()) {
+        return;
+    }
+
+    std::stable_sort(records.begin(), records.end(), [](const auto& a, const auto& b) {
+        return ((const TraceRecordHeader*)a.data())->Timestamp < ((const TraceRecordHeader*)b.data())->Timestamp;
+    });
+
+    if (sTrace.File != nullptr) {
+        WriteSitesToFile();
+        for (const auto& record : records) {
+            fputc(LUSTRACE_CHUNK_RECORD, sTrace.File);
+            fwrite(record.data(), 1, record.size(), sTrace.File);
+        }
+        fflush(sTrace.File);
+        return;
+    }
+
+    auto logger = spdlog::default_logger_raw();
+    if (logger == nullptr) {
+        return;
+    }
+    for (const auto& record : records) {
+        const auto* header = (const TraceRecordHeader*)record.data();
+        TraceSite site;
+        {
+            const std::lock_guard<std::mutex> lock(sTrace.SitesMutex);
+            site = sTrace.Sites[header->Site];
+        }
+        const std::string message =
+            FormatRecord(site.Format, record.data() + sizeof(*header), record.data() + record.size());
+        logger->log(spdlog::source_loc{ site.File.c_str(), site.Line, "" }, spdlog::level::trace, message);
+    }
+}
+
+extern "C" {
+
+void lustrace(const char* file, int32_t line, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+
+    if (!sTrace.Enabled.load(std::memory_order_relaxed)) {
+        // Plain trace logging, only worth formatting when someone listens at trace level
+        auto logger = spdlog::default_logger_raw();
+        if (logger != nullptr && logger->should_log(spdlog::level::trace)) {
+            char buffer[4096];
+            vsnprintf(buffer, sizeof(buffer), fmt, args);
+            logger->log(spdlog::source_loc{ file, line, "" }, spdlog::level::trace, buffer);
+        }
+        va_end(args);
+        return;
+    }
+
+    // Reused so recording doesn't allocate once it has warmed up
+    static thread_local std::vector<uint8_t> record;
+    record.resize(sizeof(TraceRecordHeader));
+    EncodeArgs(fmt, args, record);
+    va_end(args);
+
+    TraceRecordHeader header;
+    header.Size = record.size();
+    header.Site = GetSiteId(file, line, fmt);
+    header.Timestamp =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    memcpy(record.data(), &header, sizeof(header));
+
+    TraceBuffer* buffer = GetThreadBuffer();
+    const size_t write = buffer->WritePos.load(std::memory_order_relaxed);
+    const size_t read = buffer->ReadPos.load(std::memory_order_acquire);
+    if (LUSTRACE_BUFFER_SIZE - (write - read) < record.size()) {
+        sTrace.Dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    const size_t offset = write & (LUSTRACE_BUFFER_SIZE - 1);
+    const size_t first = std::min<size_t>(record.size(), LUSTRACE_BUFFER_SIZE - offset);
+    memcpy(buffer->Data + offset, record.data(), first);
+    memcpy(buffer->Data, record.data() + first, record.size() - first);
+    buffer->WritePos.store(write + record.size(), std::memory_order_release);
+}
+
+void lustrace_set_enabled(bool enabled) {
+    if (enabled && !sTrace.DrainThread.joinable()) {
+        sTrace.DrainThread = std::thread(DrainThreadMain);
+    }
+
+    sTrace.Enabled = enabled;
+    if (!enabled) {
+        lustrace_flush();
+    }
+}
+
+bool lustrace_is_enabled(void) {
+    return sTrace.Enabled;
+}
+
+bool lustrace_open_file(const char* path) {
+    // Everything recorded so far goes to the old destination
+    Drain();
+
+    const std::lock_guard<std::mutex> lock(sTrace.DrainMutex);
+    if (sTrace.File != nullptr) {
+        fclose(sTrace.File);
+        sTrace.File = nullptr;
+    }
+    if (path == nullptr) {
+        return true;
+    }
+
+    sTrace.File = fopen(path, "wb");
+    if (sTrace.File == nullptr) {
+        SPDLOG_ERROR("Could not open trace file {}", path);
+        return false;
+    }
+
+    const uint8_t version = LUSTRACE_FILE_VERSION;
+    fwrite(LUSTRACE_FILE_MAGIC, 1, 4, sTrace.File);
+    fwrite(&version, 1, 1, sTrace.File);
+    sTrace.SitesWritten = 0;
+    return true;
+}
+
+void lustrace_flush(void) {
+    Drain();
+}
+
+uint64_t lustrace_get_dropped(void) {
+    return sTrace.Dropped;
+}
+
+bool lustrace_decode_file(const char* inPath, const char* outPath) {
+    FILE* in = fopen(inPath, "rb");
+    if (in == nullptr) {
+        return false;
+    }
+
+    char magic[5] = { 0 };
+    uint8_t version = 0;
+    if (fread(magic, 1, 4, in) != 4 || strcmp(magic, LUSTRACE_FILE_MAGIC) != 0 || fread(&version, 1, 1, in) != 1 ||
+        version != LUSTRACE_FILE_VERSION) {
+        fclose(in);
+        return false;
+    }
+
+    FILE* out = fopen(outPath, "w");
+    if (out == nullptr) {
+        fclose(in);
+        return false;
+    }
+
+    std::vector<TraceSite> sites;
+    int chunk;
+    while ((chunk = fgetc(in)) != EOF) {
+        if (chunk == LUSTRACE_CHUNK_SITE) {
+            uint32_t id;
+            TraceSite site;
+            uint16_t len;
+            if (fread(&id, sizeof(id), 1, in) != 1 || fread(&site.Line, sizeof(site.Line), 1, in) != 1 ||
+                fread(&len, sizeof(len), 1, in) != 1) {
+                break;
+            }
+            site.File.resize(len);
+            if (fread(site.File.data(), 1, len, in) != len || fread(&len, sizeof(len), 1, in) != 1) {
+                break;
+            }
+            site.Format.resize(len);
+            if (fread(site.Format.data(), 1, len, in) != len) {
+                break;
+            }
+            if (id >= sites.size()) {
+                sites.resize(id + 1);
+            }
+            sites[id] = std::move(site);
+        } else if (chunk == LUSTRACE_CHUNK_RECORD) {
+            TraceRecordHeader header;
+            if (fread(&header, sizeof(header), 1, in) != 1 || header.Size < sizeof(header)) {
+                break;
+            }
+            std::vector<uint8_t> args(header.Size - sizeof(header));
+            if (fread(args.data(), 1, args.size(), in) != args.size()) {
+                break;
+            }
+            if (header.Site >= sites.size()) {
+                continue;
+            }
+            const TraceSite& site = sites[header.Site];
+            const std::string message = FormatRecord(site.Format, args.data(), args.data() + args.size());
+            fprintf(out, "[%llu] %s:%d %s\n", (unsigned long long)header.Timestamp, site.File.c_str(), site.Line,
+                    message.c_str());
+        } else {
+            break;
+        }
+    }
+
+    fclose(in);
+    fclose(out);
+    return true;
+}
+}
+
+namespace Ship {
+static bool LusTraceStartCommand(std::shared_ptr<Console> console, const std::vector<std::string>& args) {
+    // With a file the records are written there in binary, otherwise they are formatted to the log
+    if (!lustrace_open_file(args.size() >= 2 ? args[1].c_str() : nullptr)) {
+        return CMD_FAILED;
+    }
+
+    lustrace_set_enabled(true);
+    return CMD_SUCCESS;
+}
+
+static bool LusTraceStopCommand(std::shared_ptr<Console> console, const std::vector<std::string>& args) {
+    lustrace_set_enabled(false);
+    lustrace_open_file(nullptr);
+    if (lustrace_get_dropped() > 0) {
+        console->SendInfoMessage("%llu trace records were dropped", (unsigned long long)lustrace_get_dropped());
+    }
+    return CMD_SUCCESS;
+}
+
+void LusTraceRegisterCommands(void) {
+    SohImGui::GetConsole()->AddCommand("lustrace_start",
+                                       { LusTraceStartCommand,
+                                         "Start binary tracing of the trace log, to a file if one is given",
+                                         { { "file", ArgumentType::TEXT, true } } });
+    SohImGui::GetConsole()->AddCommand("lustrace_stop", { LusTraceStopCommand, "Stop binary tracing" });
+}
+} // namespace Ship
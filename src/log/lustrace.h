@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+// Binary tracing. A trace call only records the call site id and the raw printf arguments into a buffer owned by the
+// calling thread, formatting happens later on a background thread or offline with lustrace_decode_file. While binary
+// tracing is off, trace calls go to the regular logger at trace level, formatted on the spot.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void lustrace(const char* file, int32_t line, const char* fmt, ...);
+void lustrace_set_enabled(bool enabled);
+bool lustrace_is_enabled(void);
+// Writes the binary records to path instead of formatting them to the logger. Pass NULL to go back to the logger.
+bool lustrace_open_file(const char* path);
+// Drains the records of every thread, returns once they are written
+void lustrace_flush(void);
+// Number of records dropped because a thread filled its buffer faster than it was drained
+uint64_t lustrace_get_dropped(void);
+// Formats a file written in binary mode into a text file, one line per record
+bool lustrace_decode_file(const char* inPath, const char* outPath);
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+namespace Ship {
+// Adds the lustrace_start and lustrace_stop console commands
+void LusTraceRegisterCommands(void);
+} // namespace Ship
+#endif
+
+// Always compiled in so tracing can be turned on in any build. While it is off a call costs a relaxed load of the
+// enabled flag, plus the formatting if the logger is at trace level. Builds with the LUS_LUSTRACE option off define
+// LUS_NO_LUSTRACE and drop the calls with their arguments.
+#ifdef LUS_NO_LUSTRACE
+#define LUSTRACE(fmt, ...) (void)0
+#else
+#define LUSTRACE(fmt, ...) lustrace(__FILE__, __LINE__, fmt, __VA_ARGS__)
+#endif
@@ -9,6 +9,62 @@
 #include <sstream>
 
 namespace Ship {
+const ConsoleLine* ConsoleChannel::Get(uint64_t id) const {
+    if (id < FirstId || id >= NextId) {
+        return nullptr;
+    }
+
+    return &Lines[id % Lines.size()];
+}
+
+bool ConsoleChannel::Matches(const ConsoleLine& line) const {
+    return line.priority >= FilterLevel && (FilterText.empty() || line.text.find(FilterText) != std::string::npos);
+}
+
+void ConsoleChannel::Push(ConsoleLine&& line, size_t capacity) {
+    if (Lines.size() != capacity) {
+        Lines.resize(capacity);
+    }
+
+    const bool matches = Matches(line);
+    Lines[NextId % capacity] = std::move(line);
+    if (NextId - FirstId == capacity) {
+        FirstId++;
+        while (!FilteredIds.empty() && FilteredIds.front() < FirstId) {
+            FilteredIds.pop_front();
+        }
+    }
+
+    if (matches) {
+        FilteredIds.push_back(NextId);
+    }
+    NextId++;
+}
+
+void ConsoleChannel::SetFilter(const std::string& text, spdlog::level::level_enum level) {
+    if (text == FilterText && level == FilterLevel) {
+        return;
+    }
+
+    FilterText = text;
+    FilterLevel = level;
+    FilteredIds.clear();
+    for (uint64_t id = FirstId; id < NextId; id++) {
+        if (Matches(*Get(id))) {
+            FilteredIds.push_back(id);
+        }
+    }
+}
+
+void ConsoleChannel::Clear() {
+    for (auto& line : Lines) {
+        line = {};
+    }
+    FilteredIds.clear();
+    // Keep counting so that ids handed out before the clear never match a new line
+    FirstId = NextId;
+}
+
 std::string BuildUsage(const CommandEntry& entry) {
     std::string usage;
     for (const auto& arg : entry.arguments) {
@@ -145,7 +201,11 @@ void Console::Draw() {
 
     if (ImGui::BeginPopupContextWindow("Context Menu")) {
         if (ImGui::MenuItem("Copy Text")) {
-            ImGui::SetClipboardText(this->mLog[this->mCurrentChannel][this->mSelectedId].text.c_str());
+            const std::lock_guard<std::mutex> lock(this->mLogMutex);
+            const ConsoleLine* line = this->mLog[this->mCurrentChannel].Get(this->mSelectedId);
+            if (line != nullptr) {
+                ImGui::SetClipboardText(line->text.c_str());
+            }
             this->mSelectedId = -1;
         }
         ImGui::EndPopup();
@@ -156,7 +216,7 @@ void Console::Draw() {
 
     // Renders top bar filters
     if (ImGui::Button("Clear")) {
-        this->mLog[this->mCurrentChannel].clear();
+        ClearLogs(this->mCurrentChannel);
     }
 
     if (CVarGetInteger("gSinkEnabled", 0)) {
@@ -209,48 +269,56 @@ void Console::Draw() {
                       ImGuiWindowFlags_HorizontalScrollbar);
     ImGui::PushStyleColor(ImGuiCol_FrameBgActive, ImVec4(.3f, .3f, .3f, 1.0f));
     if (ImGui::BeginTable("History", 1)) {
-
-        if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_DownArrow))) {
-            if (this->mSelectedId < (int)this->mLog.size() - 1) {
-                ++this->mSelectedId;
-            }
-        }
-        if (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_UpArrow))) {
-            if (this->mSelectedId > 0) {
-                --this->mSelectedId;
+        const std::lock_guard<std::mutex> lock(this->mLogMutex);
+        ConsoleChannel& channel = this->mLog[this->mCurrentChannel];
+        channel.SetFilter(this->mFilter, this->mLevelFilter);
+        const std::deque<uint64_t>& visible = channel.FilteredIds;
+
+        // Arrow keys step through the visible lines
+        if (!visible.empty() && (ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_DownArrow)) ||
+                                 ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_UpArrow)))) {
+            const bool down = ImGui::IsKeyPressed(ImGui::GetKeyIndex(ImGuiKey_DownArrow));
+            auto it = std::lower_bound(visible.begin(), visible.end(), (uint64_t)std::max<int64_t>(mSelectedId, 0));
+            if (this->mSelectedId < 0 || it == visible.end()) {
+                this->mSelectedId = down ? visible.front() : visible.back();
+            } else if (down && it + 1 != visible.end()) {
+                this->mSelectedId = *(it + 1);
+            } else if (!down && it != visible.begin()) {
+                this->mSelectedId = *(it - 1);
             }
         }
 
-        const std::vector<ConsoleLine> channel = this->mLog[this->mCurrentChannel];
-        for (int i = 0; i < static_cast<int>(channel.size()); i++) {
-            ConsoleLine line = channel[i];
-            if (!this->mFilter.empty() && line.text.find(this->mFilter) == std::string::npos) {
-                continue;
-            }
-            if (this->mLevelFilter > line.priority) {
-                continue;
-            }
-            std::string id = line.text + "##" + std::to_string(i);
-            ImGui::TableNextRow();
-            ImGui::TableSetColumnIndex(0);
-            const bool isSelected = (this->mSelectedId == i) ||
-                                    std::find(this->mSelectedEntries.begin(), this->mSelectedEntries.end(), i) !=
-                                        this->mSelectedEntries.end();
-            ImGui::PushStyleColor(ImGuiCol_Text, this->mPriorityColours[line.priority]);
-            if (ImGui::Selectable(id.c_str(), isSelected)) {
-                if (ImGui::IsKeyDown(ImGui::GetKeyIndex(ImGuiKey_LeftCtrl)) && !isSelected) {
-                    this->mSelectedEntries.push_back(i);
-
-                } else {
-                    this->mSelectedEntries.clear();
+        // Only the rows in view are submitted
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(visible.size()));
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                const int64_t id = visible[row];
+                const ConsoleLine* line = channel.Get(id);
+                ImGui::TableNextRow();
+                ImGui::TableSetColumnIndex(0);
+                const bool isSelected = (this->mSelectedId == id) ||
+                                        std::find(this->mSelectedEntries.begin(), this->mSelectedEntries.end(), id) !=
+                                            this->mSelectedEntries.end();
+                ImGui::PushID(static_cast<int>(id));
+                ImGui::PushStyleColor(ImGuiCol_Text, this->mPriorityColours[line->priority]);
+                if (ImGui::Selectable(line->text.c_str(), isSelected)) {
+                    if (ImGui::IsKeyDown(ImGui::GetKeyIndex(ImGuiKey_LeftCtrl)) && !isSelected) {
+                        this->mSelectedEntries.push_back(id);
+
+                    } else {
+                        this->mSelectedEntries.clear();
+                    }
+                    this->mSelectedId = isSelected ? -1 : id;
+                }
+                ImGui::PopStyleColor();
+                ImGui::PopID();
+                if (isSelected) {
+                    ImGui::SetItemDefaultFocus();
                 }
-                this->mSelectedId = isSelected ? -1 : i;
-            }
-            ImGui::PopStyleColor();
-            if (isSelected) {
-                ImGui::SetItemDefaultFocus();
             }
         }
+        clipper.End();
         ImGui::EndTable();
     }
     ImGui::PopStyleColor();
@@ -391,7 +459,9 @@ void Console::Append(const std::string& channel, spdlog::level::level_enum prior
     char buf[2048];
     vsnprintf(buf, IM_ARRAYSIZE(buf), fmt, args);
     buf[IM_ARRAYSIZE(buf) - 1] = 0;
-    this->mLog[channel].push_back({ std::string(buf), priority });
+
+    const std::lock_guard<std::mutex> lock(this->mLogMutex);
+    this->mLog[channel].Push({ std::string(buf), priority }, gMaxLogLines);
 }
 
 void Console::Append(const std::string& channel, spdlog::level::level_enum priority, const char* fmt, ...) {
@@ -424,13 +494,19 @@ void Console::SendErrorMessage(const std::string& str) {
 }
 
 void Console::ClearLogs(std::string channel) {
-    mLog[channel].clear();
+    const std::lock_guard<std::mutex> lock(mLogMutex);
+    mLog[channel].Clear();
+    mSelectedId = -1;
+    mSelectedEntries.clear();
 }
 
 void Console::ClearLogs() {
-    for (auto [key, var] : mLog) {
-        var.clear();
+    const std::lock_guard<std::mutex> lock(mLogMutex);
+    for (auto& [key, channel] : mLog) {
+        channel.Clear();
     }
+    mSelectedId = -1;
+    mSelectedEntries.clear();
 }
 
 bool Console::HasCommand(const std::string& command) {
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <map>
+#include <deque>
+#include <mutex>
 #include <vector>
 #include <string>
 #include <functional>
@@ -33,7 +35,26 @@ struct CommandEntry {
 struct ConsoleLine {
     std::string text;
     spdlog::level::level_enum priority = spdlog::level::info;
-    std::string channel = "Console";
+};
+
+// Fixed capacity history of one log channel. Lines are addressed by a sequence id that keeps counting up, the oldest
+// lines are dropped once the capacity is reached. The ids of the lines passing the current filter are kept up to date
+// as lines come and go, so drawing never has to scan the whole history.
+struct ConsoleChannel {
+    // Line with id N lives at N % capacity, allocated on the first push
+    std::vector<ConsoleLine> Lines;
+    uint64_t FirstId = 0;
+    uint64_t NextId = 0;
+
+    std::deque<uint64_t> FilteredIds;
+    std::string FilterText;
+    spdlog::level::level_enum FilterLevel = spdlog::level::trace;
+
+    const ConsoleLine* Get(uint64_t id) const;
+    bool Matches(const ConsoleLine& line) const;
+    void Push(ConsoleLine&& line, size_t capacity);
+    void SetFilter(const std::string& text, spdlog::level::level_enum level);
+    void Clear();
 };
 
 class Console : public std::enable_shared_from_this<Console> {
@@ -45,9 +66,10 @@ class Console : public std::enable_shared_from_this<Console> {
     static bool BindToggleCommand(std::shared_ptr<Console> console, const std::vector<std::string>& args);
 
     bool mOpened = false;
-    int mSelectedId = -1;
+    // Line ids in the current channel, -1 when nothing is selected
+    int64_t mSelectedId = -1;
     int mHistoryIndex = -1;
-    std::vector<int> mSelectedEntries;
+    std::vector<int64_t> mSelectedEntries;
     std::string mFilter;
     std::string mCurrentChannel = "Console";
     bool mOpenAutocomplete = false;
@@ -61,7 +83,9 @@ class Console : public std::enable_shared_from_this<Console> {
     std::map<ImGuiKey, std::string> mBindings;
     std::map<ImGuiKey, std::string> mBindingToggle;
     std::map<std::string, CommandEntry> mCommands;
-    std::map<std::string, std::vector<ConsoleLine>> mLog;
+    // Logs arrive from the spdlog worker thread, so the channels are only touched with mLogMutex held
+    std::mutex mLogMutex;
+    std::map<std::string, ConsoleChannel> mLog;
     const std::vector<std::string> mLogChannels = { "Console", "Logs" };
     const std::vector<spdlog::level::level_enum> mPriorityFilters = { spdlog::level::off,  spdlog::level::critical,
                                                                       spdlog::level::err,  spdlog::level::warn,
@@ -77,6 +101,7 @@ class Console : public std::enable_shared_from_this<Console> {
         ImVec4(0.0f, 0.0f, 0.0f, 0.0f)      // OFF
     };
     static constexpr size_t gMaxBufferSize = 255;
+    static constexpr size_t gMaxLogLines = 10000;
 
   protected:
     void Append(const std::string& channel, spdlog::level::level_enum priority, const char* fmt, va_list args);
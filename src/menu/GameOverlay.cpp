@@ -45,9 +45,9 @@ void GameOverlay::LoadFont(const std::string& name, const std::string& path, flo
     std::shared_ptr<OtrFile> font = base->LoadFile(path, false);
     if (font->IsLoaded) {
         // TODO: Nothing is ever unloading the font or this fontData array.
-        char* fontData = new char[font->Buffer.size()];
-        memcpy(fontData, font->Buffer.data(), font->Buffer.size());
-        Fonts[name] = io.Fonts->AddFontFromMemoryTTF(fontData, font->Buffer.size(), fontSize);
+        char* fontData = new char[font->GetSize()];
+        memcpy(fontData, font->GetData(), font->GetSize());
+        Fonts[name] = io.Fonts->AddFontFromMemoryTTF(fontData, font->GetSize(), fontSize);
     }
 }
 
@@ -12,6 +12,8 @@
 
 #include "menu/Console.h"
 #include "misc/Hooks.h"
+#include "debug/TraceEvents.h"
+#include "log/lustrace.h"
 #define IMGUI_DEFINE_MATH_OPERATORS
 #include <ImGui/imgui_internal.h>
 #include "resource/ResourceMgr.h"
@@ -128,7 +130,8 @@ std::vector<std::pair<const char*, const char*>> audioBackends = {
 #if defined(__linux)
     { "pulse", "PulseAudio" },
 #endif
-    { "sdl", "SDL Audio" }
+    { "sdl", "SDL Audio" },
+    { "null", "No Audio Device" }
 };
 
 std::map<std::string, std::vector<std::string>> hiddenwindowCategories;
@@ -405,7 +408,7 @@ void LoadTexture(const std::string& name, const std::string& path) {
     const auto res = Window::GetInstance()->GetResourceManager()->LoadFile(path);
 
     const auto asset = new GameAsset{ api->new_texture() };
-    uint8_t* imgData = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(res->Buffer.data()), res->Buffer.size(),
+    uint8_t* imgData = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(res->GetData()), res->GetSize(),
                                              &asset->width, &asset->height, nullptr, 4);
 
     if (imgData == nullptr) {
@@ -484,6 +487,8 @@ void Init(WindowImpl windowImpl) {
     console->Init();
     overlay->Init();
     controller->Init();
+    LUS_TRACE_REGISTER_COMMANDS();
+    Ship::LusTraceRegisterCommands();
     ImGuiWMInit();
     ImGuiBackendInit();
 #ifdef __SWITCH__
@@ -896,8 +901,10 @@ void SetCurrentRenderingBackend(uint8_t index, std::pair<const char*, const char
     lastRenderingBackendID = index;
 }
 
-void SetCurrentAudioBackend(uint8_t index, std::pair<const char*, const char*> backend) {
-    Window::GetInstance()->GetConfig()->setString("Window.AudioBackend", backend.first);
+void SetCurrentAudioBackend(uint8_t index, std::pair<const char*, const char*> backend, bool save) {
+    if (save) {
+        Window::GetInstance()->GetConfig()->setString("Window.AudioBackend", backend.first);
+    }
     lastAudioBackendID = index;
 }
 
@@ -905,12 +912,17 @@ const char** GetSupportedTextureFilters() {
     return filters;
 }
 
+// gfx_pc applies both from its CVar change callbacks, setting an unchanged value doesn't notify
 void SetResolutionMultiplier(float multiplier) {
-    gfx_current_dimensions.internal_mul = multiplier;
+    if (CVarGetFloat("gInternalResolution", 1) != multiplier) {
+        CVarSetFloat("gInternalResolution", multiplier);
+    }
 }
 
 void SetMSAALevel(uint32_t value) {
-    gfx_msaa_level = value;
+    if (CVarGetInteger("gMSAAValue", 1) != (int32_t)value) {
+        CVarSetInteger("gMSAAValue", value);
+    }
 }
 
 void AddWindow(const std::string& category, const std::string& name, WindowDrawFunc drawFunc, bool isEnabled,
@@ -97,7 +97,8 @@ void SetMSAALevel(uint32_t value);
 
 std::vector<std::pair<const char*, const char*>> GetAvailableAudioBackends();
 std::pair<const char*, const char*> GetCurrentAudioBackend();
-void SetCurrentAudioBackend(uint8_t index, std::pair<const char*, const char*>);
+// Without save the backend is only selected in the menu for this run and the config keeps the previous one
+void SetCurrentAudioBackend(uint8_t index, std::pair<const char*, const char*>, bool save = true);
 
 void AddWindow(const std::string& category, const std::string& name, WindowDrawFunc drawFunc, bool isEnabled = false,
                bool isHidden = false);
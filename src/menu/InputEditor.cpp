@@ -11,8 +11,39 @@ namespace Ship {
 
 #define SEPARATION() ImGui::Dummy(ImVec2(0, 5))
 
+static bool InputRecordCommand(std::shared_ptr<Console> console, const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        return CMD_FAILED;
+    }
+
+    return Window::GetInstance()->GetControlDeck()->GetInputRecorder()->Start(args[1]) ? CMD_SUCCESS : CMD_FAILED;
+}
+
+static bool InputReplayCommand(std::shared_ptr<Console> console, const std::vector<std::string>& args) {
+    if (args.size() < 2) {
+        return CMD_FAILED;
+    }
+
+    return Window::GetInstance()->GetControlDeck()->GetReplayController()->Load(args[1]) ? CMD_SUCCESS : CMD_FAILED;
+}
+
+static bool InputStopCommand(std::shared_ptr<Console> console, const std::vector<std::string>& args) {
+    auto controlDeck = Window::GetInstance()->GetControlDeck();
+    controlDeck->GetInputRecorder()->Stop();
+    controlDeck->GetReplayController()->Stop();
+    return CMD_SUCCESS;
+}
+
 void InputEditor::Init() {
     mBtnReading = -1;
+
+    SohImGui::GetConsole()->AddCommand("input_record", { InputRecordCommand,
+                                                         "Record the input the game reads to a file",
+                                                         { { "file", ArgumentType::TEXT } } });
+    SohImGui::GetConsole()->AddCommand("input_replay", { InputReplayCommand,
+                                                         "Replay recorded input through the Replay device",
+                                                         { { "file", ArgumentType::TEXT } } });
+    SohImGui::GetConsole()->AddCommand("input_stop", { InputStopCommand, "Stop input recording and replay" });
 }
 
 std::shared_ptr<Controller> GetControllerPerSlot(int slot) {
@@ -40,10 +71,10 @@ void InputEditor::DrawButton(const char* label, int32_t n64Btn, int32_t currentP
     }
 
     if (readingMode) {
-        const int32_t btn = backend->ReadRawPress();
+        const int32_t btn = Ship::Window::GetInstance()->GetControlDeck()->ReadRawPress(backend);
 
         if (btn != -1) {
-            backend->SetButtonMapping(currentPort, n64Btn, btn);
+            Ship::Window::GetInstance()->GetControlDeck()->SetButtonMapping(currentPort, n64Btn, btn);
             *btnReading = -1;
 
             // avoid immediately triggering another button during gamepad nav
@@ -111,11 +142,12 @@ void InputEditor::DrawVirtualStick(const char* label, ImVec2 stick) {
 }
 
 void InputEditor::DrawControllerSchema() {
-    auto backend = Ship::Window::GetInstance()->GetControlDeck()->GetPhysicalDeviceFromVirtualSlot(mCurrentPort);
-    auto profile = backend->getProfile(mCurrentPort);
+    auto controlDeck = Ship::Window::GetInstance()->GetControlDeck();
+    auto backend = controlDeck->GetPhysicalDeviceFromVirtualSlot(mCurrentPort);
+    DeviceProfile profile = controlDeck->GetProfile(mCurrentPort);
     bool isKeyboard = backend->GetGuid() == "Keyboard" || backend->GetGuid() == "Auto" || !backend->Connected();
 
-    backend->Read(nullptr, mCurrentPort);
+    controlDeck->RefreshDevice(mCurrentPort);
 
     DrawControllerSelect(mCurrentPort);
 
@@ -174,8 +206,11 @@ void InputEditor::DrawControllerSchema() {
         // set the deadzone for both left stick axes here
         // SDL_CONTROLLER_AXIS_LEFTX: 0
         // SDL_CONTROLLER_AXIS_LEFTY: 1
-        ImGui::InputFloat("##MDZone", &profile->AxisDeadzones[0], 1.0f, 0.0f, "%.0f");
-        profile->AxisDeadzones[1] = profile->AxisDeadzones[0];
+        if (ImGui::InputFloat("##MDZone", &profile.AxisDeadzones[0], 1.0f, 0.0f, "%.0f")) {
+            controlDeck->EditProfile(mCurrentPort, [&](DeviceProfile& edited) {
+                edited.AxisDeadzones[0] = edited.AxisDeadzones[1] = profile.AxisDeadzones[0];
+            });
+        }
         ImGui::PopItemWidth();
         ImGui::EndChild();
     } else {
@@ -219,8 +254,11 @@ void InputEditor::DrawControllerSchema() {
         // set the deadzone for both right stick axes here
         // SDL_CONTROLLER_AXIS_RIGHTX: 2
         // SDL_CONTROLLER_AXIS_RIGHTY: 3
-        ImGui::InputFloat("##MDZone", &profile->AxisDeadzones[2], 1.0f, 0.0f, "%.0f");
-        profile->AxisDeadzones[3] = profile->AxisDeadzones[2];
+        if (ImGui::InputFloat("##MDZone", &profile.AxisDeadzones[2], 1.0f, 0.0f, "%.0f")) {
+            controlDeck->EditProfile(mCurrentPort, [&](DeviceProfile& edited) {
+                edited.AxisDeadzones[2] = edited.AxisDeadzones[3] = profile.AxisDeadzones[2];
+            });
+        }
         ImGui::PopItemWidth();
         ImGui::EndChild();
 #ifdef __SWITCH__
@@ -237,22 +275,30 @@ void InputEditor::DrawControllerSchema() {
         SohImGui::BeginGroupPanel("Gyro Options", ImVec2(175, 20));
         float cursorX = ImGui::GetCursorPosX() + 5;
         ImGui::SetCursorPosX(cursorX);
-        ImGui::Checkbox("Enable Gyro", &profile->UseGyro);
+        if (ImGui::Checkbox("Enable Gyro", &profile.UseGyro)) {
+            controlDeck->EditProfile(mCurrentPort, [&](DeviceProfile& edited) { edited.UseGyro = profile.UseGyro; });
+        }
         ImGui::SetCursorPosX(cursorX);
-        ImGui::Text("Gyro Sensitivity: %d%%", static_cast<int>(100.0f * profile->GyroData[GYRO_SENSITIVITY]));
+        ImGui::Text("Gyro Sensitivity: %d%%", static_cast<int>(100.0f * profile.GyroData[GYRO_SENSITIVITY]));
 #ifdef __WIIU__
         ImGui::PushItemWidth(135.0f * 2);
 #else
         ImGui::PushItemWidth(135.0f);
 #endif
         ImGui::SetCursorPosX(cursorX);
-        ImGui::SliderFloat("##GSensitivity", &profile->GyroData[GYRO_SENSITIVITY], 0.0f, 1.0f, "");
+        if (ImGui::SliderFloat("##GSensitivity", &profile.GyroData[GYRO_SENSITIVITY], 0.0f, 1.0f, "")) {
+            controlDeck->EditProfile(mCurrentPort, [&](DeviceProfile& edited) {
+                edited.GyroData[GYRO_SENSITIVITY] = profile.GyroData[GYRO_SENSITIVITY];
+            });
+        }
         ImGui::PopItemWidth();
         ImGui::Dummy(ImVec2(0, 1));
         ImGui::SetCursorPosX(cursorX);
         if (ImGui::Button("Recalibrate Gyro##RGyro")) {
-            profile->GyroData[DRIFT_X] = 0.0f;
-            profile->GyroData[DRIFT_Y] = 0.0f;
+            controlDeck->EditProfile(mCurrentPort, [](DeviceProfile& edited) {
+                edited.GyroData[DRIFT_X] = 0.0f;
+                edited.GyroData[DRIFT_Y] = 0.0f;
+            });
         }
         ImGui::SetCursorPosX(cursorX);
         DrawVirtualStick("##GyroPreview",
@@ -271,7 +317,11 @@ void InputEditor::DrawControllerSchema() {
 #else
         ImGui::PushItemWidth(80);
 #endif
-        ImGui::InputFloat("##GDriftX", &profile->GyroData[DRIFT_X], 1.0f, 0.0f, "%.1f");
+        if (ImGui::InputFloat("##GDriftX", &profile.GyroData[DRIFT_X], 1.0f, 0.0f, "%.1f")) {
+            controlDeck->EditProfile(mCurrentPort, [&](DeviceProfile& edited) {
+                edited.GyroData[DRIFT_X] = profile.GyroData[DRIFT_X];
+            });
+        }
         ImGui::PopItemWidth();
         ImGui::Text("Drift Y");
 #ifdef __WIIU__
@@ -279,7 +329,11 @@ void InputEditor::DrawControllerSchema() {
 #else
         ImGui::PushItemWidth(80);
 #endif
-        ImGui::InputFloat("##GDriftY", &profile->GyroData[DRIFT_Y], 1.0f, 0.0f, "%.1f");
+        if (ImGui::InputFloat("##GDriftY", &profile.GyroData[DRIFT_Y], 1.0f, 0.0f, "%.1f")) {
+            controlDeck->EditProfile(mCurrentPort, [&](DeviceProfile& edited) {
+                edited.GyroData[DRIFT_Y] = profile.GyroData[DRIFT_Y];
+            });
+        }
         ImGui::PopItemWidth();
         ImGui::EndChild();
 #ifdef __SWITCH__
@@ -312,23 +366,28 @@ void InputEditor::DrawControllerSchema() {
     SohImGui::BeginGroupPanel("Options", ImVec2(158, 20));
     float cursorX = ImGui::GetCursorPosX() + 5;
     ImGui::SetCursorPosX(cursorX);
-    ImGui::Checkbox("Rumble Enabled", &profile->UseRumble);
+    if (ImGui::Checkbox("Rumble Enabled", &profile.UseRumble)) {
+        controlDeck->EditProfile(mCurrentPort, [&](DeviceProfile& edited) { edited.UseRumble = profile.UseRumble; });
+    }
     if (backend->CanRumble()) {
         ImGui::SetCursorPosX(cursorX);
-        ImGui::Text("Rumble Force: %d%%", static_cast<int>(100.0f * profile->RumbleStrength));
+        ImGui::Text("Rumble Force: %d%%", static_cast<int>(100.0f * profile.RumbleStrength));
         ImGui::SetCursorPosX(cursorX);
 #ifdef __WIIU__
         ImGui::PushItemWidth(135.0f * 2);
 #else
         ImGui::PushItemWidth(135.0f);
 #endif
-        ImGui::SliderFloat("##RStrength", &profile->RumbleStrength, 0.0f, 1.0f, "");
+        if (ImGui::SliderFloat("##RStrength", &profile.RumbleStrength, 0.0f, 1.0f, "")) {
+            controlDeck->EditProfile(mCurrentPort,
+                                     [&](DeviceProfile& edited) { edited.RumbleStrength = profile.RumbleStrength; });
+        }
         ImGui::PopItemWidth();
     }
 
     if (!isKeyboard) {
         ImGui::SetCursorPosX(cursorX);
-        ImGui::Text("Notch Snap Angle: %d", profile->NotchProximityThreshold);
+        ImGui::Text("Notch Snap Angle: %d", profile.NotchProximityThreshold);
         ImGui::SetCursorPosX(cursorX);
 
 #ifdef __WIIU__
@@ -336,8 +395,12 @@ void InputEditor::DrawControllerSchema() {
 #else
         ImGui::PushItemWidth(135.0f);
 #endif
-        ImGui::SliderInt("##NotchProximityThreshold", &profile->NotchProximityThreshold, 0, 45, "",
-                         ImGuiSliderFlags_AlwaysClamp);
+        if (ImGui::SliderInt("##NotchProximityThreshold", &profile.NotchProximityThreshold, 0, 45, "",
+                             ImGuiSliderFlags_AlwaysClamp)) {
+            controlDeck->EditProfile(mCurrentPort, [&](DeviceProfile& edited) {
+                edited.NotchProximityThreshold = profile.NotchProximityThreshold;
+            });
+        }
         ImGui::PopItemWidth();
         if (ImGui::IsItemHovered()) {
             ImGui::SetTooltip(
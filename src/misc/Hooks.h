@@ -1,6 +1,8 @@
 #pragma once
 
 #include <functional>
+#include <utility>
+#include <vector>
 #include "libultraship/libultra/controller.h"
 
 #define DEFINE_HOOK(name, type)         \
@@ -11,15 +13,25 @@
 namespace Ship {
 class Controller;
 
-template <typename H> struct RegisteredHooks { inline static std::vector<typename H::fn> functions; };
+template <typename H> struct RegisteredHooks {
+    inline static std::vector<std::pair<size_t, typename H::fn>> functions;
+    inline static size_t lastId = 0;
+};
 
-template <typename H> void RegisterHook(typename H::fn h) {
-    RegisteredHooks<H>::functions.push_back(h);
+// Returns an id for UnregisterHook. Hooks capturing an object have to be unregistered before it goes away.
+template <typename H> size_t RegisterHook(typename H::fn h) {
+    const size_t id = ++RegisteredHooks<H>::lastId;
+    RegisteredHooks<H>::functions.emplace_back(id, h);
+    return id;
+}
+
+template <typename H> void UnregisterHook(size_t id) {
+    std::erase_if(RegisteredHooks<H>::functions, [id](const auto& hook) { return hook.first == id; });
 }
 
 template <typename H, typename... Args> void ExecuteHooks(Args&&... args) {
-    for (auto& fn : RegisteredHooks<H>::functions) {
-        fn(std::forward<Args>(args)...);
+    for (auto& hook : RegisteredHooks<H>::functions) {
+        hook.second(std::forward<Args>(args)...);
     }
 }
 
@@ -27,6 +39,8 @@ DEFINE_HOOK(ControllerRead, void(OSContPad* pad));
 DEFINE_HOOK(ControllerRawInput, void(Controller* backend, uint32_t raw));
 DEFINE_HOOK(AudioInit, void());
 DEFINE_HOOK(GfxInit, void());
+DEFINE_HOOK(GfxTaskDone, void());
+DEFINE_HOOK(GfxFrameEnd, void());
 DEFINE_HOOK(ExitGame, void());
 DEFINE_HOOK(LoadFile, void(uint32_t fileNum));
 DEFINE_HOOK(DeleteFile, void(uint32_t fileNum));
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Ship {
+// Lock-free single producer, single consumer latest-value channel. The writer always has a slot to write into and the
+// reader always gets the most recently published value, neither side ever waits for the other.
+template <typename T> class TripleBuffer {
+  public:
+    TripleBuffer() : mBack(0), mMiddle(1), mFront(2) {
+    }
+
+    // Writer side. Fill the slot returned by Back(), then Publish() it.
+    T& Back() {
+        return mSlots[mBack];
+    }
+
+    void Publish() {
+        mBack = mMiddle.exchange(mBack | DIRTY_BIT, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    // Reader side. Returns the latest published value, or the previous one again when nothing new was published.
+    const T& Read() {
+        if (mMiddle.load(std::memory_order_relaxed) & DIRTY_BIT) {
+            mFront = mMiddle.exchange(mFront, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+        return mSlots[mFront];
+    }
+
+  private:
+    static constexpr uint8_t DIRTY_BIT = 0x4;
+    static constexpr uint8_t INDEX_MASK = 0x3;
+
+    T mSlots[3] = {};
+    uint8_t mBack;
+    std::atomic<uint8_t> mMiddle;
+    uint8_t mFront;
+};
+} // namespace Ship
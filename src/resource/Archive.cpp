@@ -1,8 +1,8 @@
 #include "Archive.h"
 #include "Resource.h"
 #include "OtrFile.h"
-#include "core/Window.h"
-#include "resource/ResourceMgr.h"
+#include "ContainerArchive.h"
+#include "MappedFile.h"
 #include <spdlog/spdlog.h>
 #include "Utils/StringHelper.h"
 #include <StrHash64.h>
@@ -10,6 +10,7 @@
 #include "binarytools/BinaryReader.h"
 #include "binarytools/MemoryStream.h"
 #include "binarytools/FileHelper.h"
+#include "debug/TraceEvents.h"
 
 #ifdef __SWITCH__
 #include "port/switch/SwitchImpl.h"
@@ -40,7 +41,7 @@ Archive::~Archive() {
 }
 
 bool Archive::IsMainMPQValid() {
-    return mMainMpq != nullptr;
+    return mMainMpq != nullptr || !mContainers.empty();
 }
 
 std::shared_ptr<Archive> Archive::CreateArchive(const std::string& archivePath, int fileCapacity) {
@@ -58,6 +59,7 @@ std::shared_ptr<Archive> Archive::CreateArchive(const std::string& archivePath,
 
     if (success) {
         archive->mMpqHandles[archivePath] = archive->mMainMpq;
+        archive->mLayers.push_back({ nullptr, archive->mMainMpq });
         return archive;
     } else {
         SPDLOG_ERROR("({}) We tried to create an archive, but it has fallen and cannot get up.", error);
@@ -67,23 +69,41 @@ std::shared_ptr<Archive> Archive::CreateArchive(const std::string& archivePath,
 
 std::shared_ptr<OtrFile> Archive::LoadFileFromHandle(const std::string& filePath, bool includeParent,
                                                      HANDLE mpqHandle) {
+    LUS_TRACE_SPAN_DETAIL("Archive::LoadFileFromHandle", "io", filePath);
     HANDLE fileHandle = NULL;
 
     std::shared_ptr<OtrFile> fileToLoad = std::make_shared<OtrFile>();
     fileToLoad->Path = filePath;
 
     if (mpqHandle == nullptr) {
+        // The last layer that has the file wins. All MPQs are patched into the main one, so when one of them has it
+        // the main MPQ already resolves it to the latest version.
+        for (auto it = mLayers.rbegin(); it != mLayers.rend(); it++) {
+            if (it->Container == nullptr) {
+                if (SFileHasFile(it->Mpq, filePath.c_str())) {
+                    break;
+                }
+            } else if (it->Container->LoadFile(filePath, *fileToLoad)) {
+                fileToLoad->Parent = includeParent ? shared_from_this() : nullptr;
+                return fileToLoad;
+            }
+        }
+
         mpqHandle = mMainMpq;
+        if (mpqHandle == nullptr) {
+            SPDLOG_ERROR("Failed to find file {} in any archive", filePath);
+            return nullptr;
+        }
     }
 
 #if _DEBUG
     if (FileHelper::Exists("TestData/" + filePath)) {
         auto byteData = FileHelper::ReadAllBytes("TestData/" + filePath);
-        fileToLoad->Buffer.resize(byteData.size() + 1);
-        memcpy(fileToLoad->Buffer.data(), byteData.data(), byteData.size() + 1);
+        char* buffer = fileToLoad->Allocate(byteData.size() + 1);
+        memcpy(buffer, byteData.data(), byteData.size());
 
         // Throw in a null terminator at the end incase we're loading a text file...
-        fileToLoad->Buffer[byteData.size()] = '\0';
+        buffer[byteData.size()] = '\0';
 
         fileToLoad->Parent = includeParent ? shared_from_this() : nullptr;
         fileToLoad->IsLoaded = true;
@@ -97,10 +117,11 @@ std::shared_ptr<OtrFile> Archive::LoadFileFromHandle(const std::string& filePath
         }
 
         DWORD fileSize = SFileGetFileSize(fileHandle, 0);
-        fileToLoad->Buffer.resize(fileSize);
         DWORD countBytes;
-
-        if (!SFileReadFile(fileHandle, fileToLoad->Buffer.data(), fileSize, &countBytes, NULL)) {
+        const bool viewLoaded = LoadFileView(fileHandle, *fileToLoad);
+        // StormLib refuses to read nothing, empty files are done without it
+        if (!viewLoaded && fileSize != 0 &&
+            !SFileReadFile(fileHandle, fileToLoad->Allocate(fileSize), fileSize, &countBytes, NULL)) {
             SPDLOG_ERROR("({}) Failed to read file {} from mpq archive {}", GetLastError(), filePath, mMainPath);
             if (!SFileCloseFile(fileHandle)) {
                 SPDLOG_ERROR("({}) Failed to close file {} from mpq after read failure in archive {}", GetLastError(),
@@ -126,7 +147,88 @@ std::shared_ptr<OtrFile> Archive::LoadFile(const std::string& filePath, bool inc
     return LoadFileFromHandle(filePath, includeParent, nullptr);
 }
 
-bool Archive::AddFile(const std::string& path, uintptr_t fileData, DWORD fileSize) {
+bool Archive::LoadFileView(HANDLE fileHandle, OtrFile& file) {
+    if (!mMapFiles) {
+        return false;
+    }
+
+    DWORD flags = 0;
+    DWORD fileSize = 0;
+    DWORD compressedSize = 0;
+    ULONGLONG byteOffset = 0;
+    if (!SFileGetFileInfo(fileHandle, SFileInfoFlags, &flags, sizeof(flags), NULL) ||
+        !SFileGetFileInfo(fileHandle, SFileInfoFileSize, &fileSize, sizeof(fileSize), NULL) ||
+        !SFileGetFileInfo(fileHandle, SFileInfoCompressedSize, &compressedSize, sizeof(compressedSize), NULL) ||
+        !SFileGetFileInfo(fileHandle, SFileInfoByteOffset, &byteOffset, sizeof(byteOffset), NULL)) {
+        return false;
+    }
+
+    // Only files whose bytes sit in the archive exactly as they are read can be viewed
+    if ((flags & (MPQ_FILE_COMPRESS_MASK | MPQ_FILE_ENCRYPTED | MPQ_FILE_PATCH_FILE | MPQ_FILE_SECTOR_CRC)) != 0 ||
+        fileSize != compressedSize || fileSize == 0) {
+        return false;
+    }
+
+    // The chain names the archive the file comes from, followed by any archives holding incremental patches to it
+    DWORD chainSize = 0;
+    SFileGetFileInfo(fileHandle, SFileInfoPatchChain, NULL, 0, &chainSize);
+    std::vector<TCHAR> chain(chainSize / sizeof(TCHAR) + 1, 0);
+    if (chainSize == 0 ||
+        !SFileGetFileInfo(fileHandle, SFileInfoPatchChain, chain.data(), chain.size() * sizeof(TCHAR), NULL)) {
+        return false;
+    }
+    const std::string archivePath = chain.data();
+    if (chain[archivePath.size() + 1] != 0) {
+        return false;
+    }
+
+    std::shared_ptr<MappedFile> mapping;
+    ULONGLONG mpqOffset = 0;
+    {
+        const std::lock_guard<std::mutex> lock(mMappingsMutex);
+        auto handle = mMpqHandles.find(archivePath);
+        if (handle == mMpqHandles.end() ||
+            !SFileGetFileInfo(handle->second, SFileMpqHeaderOffset, &mpqOffset, sizeof(mpqOffset), NULL)) {
+            return false;
+        }
+
+        // Archives that fail to map are remembered as nullptr and read through StormLib from then on
+        auto it = mMappings.find(archivePath);
+        if (it == mMappings.end()) {
+            it = mMappings.emplace(archivePath, MappedFile::Open(archivePath)).first;
+        }
+        mapping = it->second;
+    }
+
+    if (mapping == nullptr || mpqOffset + byteOffset + fileSize > mapping->GetSize()) {
+        return false;
+    }
+
+    file.SetView(mapping, mapping->GetData() + mpqOffset + byteOffset, fileSize);
+    return true;
+}
+
+bool Archive::AddFile(const std::string& path, uintptr_t fileData, DWORD fileSize, DWORD compression) {
+    return AddFileToMpq(path, fileData, fileSize, compression, nullptr, nullptr);
+}
+
+bool Archive::AddPrecompressedFile(const std::string& path, uintptr_t fileData, DWORD fileSize, DWORD compression,
+                                   const void* const* sectors, const DWORD* sectorSizes) {
+    return AddFileToMpq(path, fileData, fileSize, compression, sectors, sectorSizes);
+}
+
+DWORD Archive::GetSectorSize() {
+    DWORD sectorSize = 0;
+    if (!SFileGetFileInfo(mMainMpq, SFileMpqSectorSize, &sectorSize, sizeof(sectorSize), nullptr)) {
+        SPDLOG_ERROR("({}) Failed to get the sector size of archive {}", GetLastError(), mMainPath);
+        return 0;
+    }
+
+    return sectorSize;
+}
+
+bool Archive::AddFileToMpq(const std::string& path, uintptr_t fileData, DWORD fileSize, DWORD compression,
+                           const void* const* sectors, const DWORD* sectorSizes) {
     HANDLE hFile;
 #ifdef _WIN32
     SYSTEMTIME sysTime;
@@ -143,13 +245,17 @@ bool Archive::AddFile(const std::string& path, uintptr_t fileData, DWORD fileSiz
 
     StringHelper::ReplaceOriginal(updatedPath, "\\", "/");
 
-    if (!SFileCreateFile(mMainMpq, updatedPath.c_str(), theTime, fileSize, 0, MPQ_FILE_COMPRESS, &hFile)) {
+    if (!SFileCreateFile(mMainMpq, updatedPath.c_str(), theTime, fileSize, 0, compression != 0 ? MPQ_FILE_COMPRESS : 0,
+                         &hFile)) {
         SPDLOG_ERROR("({}) Failed to create file of {} bytes {} in archive {}", GetLastError(), fileSize, updatedPath,
                      mMainPath);
         return false;
     }
 
-    if (!SFileWriteFile(hFile, (void*)fileData, fileSize, MPQ_COMPRESSION_ZLIB)) {
+    const bool written = sectors != nullptr ? SFileWriteFilePrecompressed(hFile, (void*)fileData, fileSize, compression,
+                                                                          sectors, sectorSizes)
+                                            : SFileWriteFile(hFile, (void*)fileData, fileSize, compression);
+    if (!written) {
         SPDLOG_ERROR("({}) Failed to write {} bytes to {} in archive {}", GetLastError(), fileSize, updatedPath,
                      mMainPath);
         if (!SFileCloseFile(hFile)) {
@@ -171,6 +277,9 @@ bool Archive::AddFile(const std::string& path, uintptr_t fileData, DWORD fileSiz
 
     mAddedFiles.push_back(updatedPath);
     mHashes[CRC64(updatedPath.c_str())] = updatedPath;
+    if (!mPathIndex.Contains(updatedPath)) {
+        mPathIndex.Add(updatedPath);
+    }
 
     return true;
 }
@@ -183,6 +292,8 @@ bool Archive::RemoveFile(const std::string& path) {
         return false;
     }
 
+    RemoveFromPathIndex(path);
+
     return true;
 }
 
@@ -194,6 +305,9 @@ bool Archive::RenameFile(const std::string& oldPath, const std::string& newPath)
         return false;
     }
 
+    RemoveFromPathIndex(oldPath);
+    mPathIndex.Add(newPath);
+
     return true;
 }
 
@@ -202,6 +316,10 @@ std::shared_ptr<std::vector<SFILE_FIND_DATA>> Archive::FindFiles(const std::stri
     SFILE_FIND_DATA findContext;
     HANDLE hFind;
 
+    if (mMainMpq == nullptr) {
+        return fileList;
+    }
+
     hFind = SFileFindFirstFile(mMainMpq, searchMask.c_str(), &findContext, nullptr);
     if (hFind != nullptr) {
         fileList->push_back(findContext);
@@ -239,19 +357,36 @@ std::shared_ptr<std::vector<SFILE_FIND_DATA>> Archive::FindFiles(const std::stri
 }
 
 std::shared_ptr<std::vector<std::string>> Archive::ListFiles(const std::string& searchMask) {
-    auto result = std::make_shared<std::vector<std::string>>();
-    auto fileList = FindFiles(searchMask);
+    return std::make_shared<std::vector<std::string>>(mPathIndex.Find(searchMask));
+}
 
-    for (size_t i = 0; i < fileList->size(); i++) {
-        result->push_back(fileList->operator[](i).cFileName);
-    }
+bool Archive::HasFile(const std::string& searchMask) {
+    return mPathIndex.HasMatch(searchMask);
+}
 
-    return result;
+// The MPQ matches names regardless of case and slash direction, so the indexed spelling may differ from path
+void Archive::RemoveFromPathIndex(const std::string& path) {
+    for (const auto& indexedPath : mPathIndex.Find(path)) {
+        mPathIndex.Remove(indexedPath);
+    }
 }
 
-bool Archive::HasFile(const std::string& searchMask) {
-    auto list = FindFiles(searchMask);
-    return list->size() > 0;
+void Archive::BuildPathIndex() {
+    mPathIndex.Clear();
+
+    // MPQ searches already merge the patches into the main MPQ
+    auto fileList = FindFiles("*");
+    for (const auto& file : *fileList) {
+        mPathIndex.Add(file.cFileName);
+    }
+
+    for (const auto& container : mContainers) {
+        for (const auto& fileName : container->GetFileNames()) {
+            if (!mPathIndex.Contains(fileName)) {
+                mPathIndex.Add(fileName);
+            }
+        }
+    }
 }
 
 const std::string* Archive::HashToString(uint64_t hash) const {
@@ -260,7 +395,11 @@ const std::string* Archive::HashToString(uint64_t hash) const {
 }
 
 bool Archive::Load(bool enableWriting, bool generateCrcMap) {
-    return LoadMainMPQ(enableWriting, generateCrcMap) && LoadPatchMPQs();
+    // A mapping would show the archive's bytes from before any write
+    mMapFiles = !enableWriting;
+    const bool loaded = LoadMainMPQ(enableWriting, generateCrcMap) && LoadPatchMPQs();
+    BuildPathIndex();
+    return loaded;
 }
 
 bool Archive::Unload() {
@@ -273,6 +412,7 @@ bool Archive::Unload() {
     }
 
     mMainMpq = nullptr;
+    mLayers.clear();
 
     return success;
 }
@@ -283,8 +423,13 @@ bool Archive::LoadPatchMPQs() {
     if (mPatchesPath.length() > 0) {
         if (std::filesystem::is_directory(mPatchesPath)) {
             for (const auto& p : std::filesystem::recursive_directory_iterator(mPatchesPath)) {
-                if (StringHelper::IEquals(p.path().extension().string(), ".otr") ||
-                    StringHelper::IEquals(p.path().extension().string(), ".mpq")) {
+                if (ContainerArchive::IsContainerPath(p.path().string())) {
+                    SPDLOG_ERROR("Reading {} container patch", p.path().string());
+                    if (!LoadContainer(p.path().string())) {
+                        return false;
+                    }
+                } else if (StringHelper::IEquals(p.path().extension().string(), ".otr") ||
+                           StringHelper::IEquals(p.path().extension().string(), ".mpq")) {
                     SPDLOG_ERROR("Reading {} mpq patch", p.path().string());
                     if (!LoadPatchMPQ(p.path().string())) {
                         return false;
@@ -302,7 +447,7 @@ void Archive::GenerateCrcMap() {
 
     // Use std::string_view to avoid unnecessary string copies
     std::vector<std::string_view> lines =
-        StringHelper::Split(std::string_view(listFile->Buffer.data(), listFile->Buffer.size()), "\n");
+        StringHelper::Split(std::string_view(listFile->GetData(), listFile->GetSize()), "\n");
 
     for (size_t i = 0; i < lines.size(); i++) {
         // Use std::string_view to avoid unnecessary string copies
@@ -316,9 +461,12 @@ void Archive::GenerateCrcMap() {
 }
 
 bool Archive::ProcessOtrVersion(HANDLE mpqHandle) {
-    auto t = LoadFileFromHandle("version", false, mpqHandle);
+    return ProcessVersionFile(LoadFileFromHandle("version", false, mpqHandle));
+}
+
+bool Archive::ProcessVersionFile(std::shared_ptr<OtrFile> t) {
     if (t != nullptr && t->IsLoaded) {
-        auto stream = std::make_shared<MemoryStream>(t->Buffer.data(), t->Buffer.size());
+        auto stream = std::make_shared<MemoryStream>(t->GetData(), t->GetSize(), t);
         auto reader = std::make_shared<BinaryReader>(stream);
         Ship::Endianness endianness = (Ship::Endianness)reader->ReadUByte();
         reader->SetEndianness(endianness);
@@ -337,7 +485,8 @@ bool Archive::LoadMainMPQ(bool enableWriting, bool generateCrcMap) {
         if (mMainPath.length() > 0) {
             if (std::filesystem::is_directory(mMainPath)) {
                 for (const auto& p : std::filesystem::recursive_directory_iterator(mMainPath)) {
-                    if (StringHelper::IEquals(p.path().extension().string(), ".otr")) {
+                    if (StringHelper::IEquals(p.path().extension().string(), ".otr") ||
+                        ContainerArchive::IsContainerPath(p.path().string())) {
                         SPDLOG_ERROR("Reading {} mpq", p.path().string());
                         mOtrArchives.push_back(p.path().string());
                     }
@@ -357,54 +506,54 @@ bool Archive::LoadMainMPQ(bool enableWriting, bool generateCrcMap) {
             return false;
         }
     }
+    // Containers and MPQs are layered in list order. The first valid MPQ is the one the others are patched into.
     bool baseLoaded = false;
+    for (const auto& archivePath : mOtrArchives) {
+        if (ContainerArchive::IsContainerPath(archivePath)) {
+            if (LoadContainer(archivePath, true)) {
+                SPDLOG_INFO("Opened container {}.", archivePath);
+                baseLoaded = true;
+            }
+            continue;
+        }
 
-    size_t i = 0;
-    while (!baseLoaded && i < mOtrArchives.size()) {
 #if defined(__SWITCH__) || defined(__WIIU__) || defined(__vita__)
-        std::string fullPath = mOtrArchives[i];
+        std::string fullPath = archivePath;
 #else
-        std::string fullPath = std::filesystem::absolute(mOtrArchives[i]).string();
+        std::string fullPath = std::filesystem::absolute(archivePath).string();
 #endif
+        if (mMainMpq != nullptr) {
+            if (LoadPatchMPQ(fullPath, true)) {
+                SPDLOG_INFO("({}) Patched in mpq file.", fullPath);
+            }
+            if (generateCrcMap) {
+                GenerateCrcMap();
+            }
+            continue;
+        }
+
         if (SFileOpenArchive(fullPath.c_str(), 0, enableWriting ? 0 : MPQ_OPEN_READ_ONLY, &mpqHandle)) {
             SPDLOG_INFO("Opened mpq file {}.", fullPath);
-            mMainMpq = mpqHandle;
-            mMainPath = fullPath;
-            if (!ProcessOtrVersion(mMainMpq)) {
-                SPDLOG_WARN("Attempted to load invalid OTR file {}", mOtrArchives[i]);
+            if (!ProcessOtrVersion(mpqHandle)) {
+                SPDLOG_WARN("Attempted to load invalid OTR file {}", archivePath);
                 SFileCloseArchive(mpqHandle);
-                mMainMpq = nullptr;
             } else {
+                mMainMpq = mpqHandle;
                 mMpqHandles[fullPath] = mpqHandle;
+                mLayers.push_back({ nullptr, mpqHandle });
                 if (generateCrcMap) {
                     GenerateCrcMap();
                 }
                 baseLoaded = true;
             }
         }
-        i++;
     }
-    // If we exited the above loop without setting baseLoaded to true, then we've
-    // attemtped to load all the OTRs available to us.
+    // If nothing got loaded we've attempted to load all the OTRs available to us.
     if (!baseLoaded) {
         SPDLOG_ERROR("No valid OTR file was provided.");
         return false;
     }
 
-    for (size_t j = i; j < mOtrArchives.size(); j++) {
-#if defined(__SWITCH__) || defined(__WIIU__) || defined(__vita__)
-        std::string fullPath = mOtrArchives[j];
-#else
-        std::string fullPath = std::filesystem::absolute(mOtrArchives[j]).string();
-#endif
-        if (LoadPatchMPQ(fullPath, true)) {
-            SPDLOG_INFO("({}) Patched in mpq file.", fullPath);
-        }
-        if (generateCrcMap) {
-            GenerateCrcMap();
-        }
-    }
-
     return true;
 }
 
@@ -430,13 +579,52 @@ bool Archive::LoadPatchMPQ(const std::string& path, bool validateVersion) {
             }
         }
     }
-    if (!SFileOpenPatchArchive(mMainMpq, fullPath.c_str(), "", 0)) {
+    // Without a main MPQ, e.g. when the base is a container, the first patch becomes the one the others patch into
+    if (mMainMpq == nullptr) {
+        mMainMpq = patchHandle;
+    } else if (!SFileOpenPatchArchive(mMainMpq, fullPath.c_str(), "", 0)) {
         SPDLOG_ERROR("({}) Failed to apply patch mpq file {} to main mpq {}.", GetLastError(), path, mMainPath);
+        SFileCloseArchive(patchHandle);
         return false;
     }
 
     mMpqHandles[fullPath] = patchHandle;
+    mLayers.push_back({ nullptr, patchHandle });
+
+    return true;
+}
+
+bool Archive::LoadContainer(const std::string& path, bool validateVersion) {
+#if defined(__SWITCH__) || defined(__WIIU__) || defined(__vita__)
+    std::string fullPath = path;
+#else
+    std::string fullPath = std::filesystem::absolute(path).string();
+#endif
+    for (const auto& container : mContainers) {
+        if (container->GetPath() == fullPath) {
+            return true;
+        }
+    }
+
+    auto container = ContainerArchive::Open(fullPath);
+    if (container == nullptr) {
+        return false;
+    }
+
+    if (validateVersion) {
+        auto versionFile = std::make_shared<OtrFile>();
+        if (!container->LoadFile("version", *versionFile) || !ProcessVersionFile(versionFile)) {
+            SPDLOG_INFO("({}) Missing version file. Attempting to apply container anyway.", path);
+        }
+    }
+
+    // The container directory replaces the (listfile) an MPQ would need for the CRC map
+    for (const auto& fileName : container->GetFileNames()) {
+        mHashes.emplace(CRC64(fileName.c_str()), fileName);
+    }
 
+    mContainers.push_back(container);
+    mLayers.push_back({ container, nullptr });
     return true;
 }
 
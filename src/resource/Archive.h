@@ -6,15 +6,19 @@
 
 #include <stdint.h>
 #include <map>
+#include <mutex>
 #include <unordered_map>
 #include <string>
 #include <vector>
 #include <unordered_set>
 #include "Resource.h"
+#include "PathIndex.h"
 #include <StormLib.h>
 
 namespace Ship {
 struct OtrFile;
+class ContainerArchive;
+class MappedFile;
 
 class Archive : public std::enable_shared_from_this<Archive> {
   public:
@@ -29,7 +33,13 @@ class Archive : public std::enable_shared_from_this<Archive> {
 
     bool IsMainMPQValid();
     std::shared_ptr<OtrFile> LoadFile(const std::string& filePath, bool includeParent = true);
-    bool AddFile(const std::string& path, uintptr_t fileData, DWORD fileSize);
+    // A compression of 0 stores the file uncompressed
+    bool AddFile(const std::string& path, uintptr_t fileData, DWORD fileSize,
+                 DWORD compression = MPQ_COMPRESSION_ZLIB);
+    // Like AddFile, with every sector of GetSectorSize() bytes already compressed by SCompCompress
+    bool AddPrecompressedFile(const std::string& path, uintptr_t fileData, DWORD fileSize, DWORD compression,
+                              const void* const* sectors, const DWORD* sectorSizes);
+    DWORD GetSectorSize();
     bool RemoveFile(const std::string& path);
     bool RenameFile(const std::string& oldPath, const std::string& newPath);
     std::shared_ptr<std::vector<std::string>> ListFiles(const std::string& searchMask);
@@ -53,12 +63,33 @@ class Archive : public std::enable_shared_from_this<Archive> {
     std::vector<uint32_t> mGameVersions;
     std::unordered_map<uint64_t, std::string> mHashes;
     HANDLE mMainMpq;
+    // One loaded archive, either a native container or an MPQ
+    struct Layer {
+        std::shared_ptr<ContainerArchive> Container;
+        HANDLE Mpq;
+    };
+    std::vector<std::shared_ptr<ContainerArchive>> mContainers;
+    // Every container and MPQ in load order, files are looked up from the last one back so later layers win
+    std::vector<Layer> mLayers;
+    // Mappings of the MPQs that uncompressed files are viewed through, by path. Only used for read only archives.
+    bool mMapFiles = false;
+    std::mutex mMappingsMutex;
+    std::unordered_map<std::string, std::shared_ptr<MappedFile>> mMappings;
+    // Every file name across the MPQs and containers, built once they are loaded. Serves ListFiles and HasFile.
+    PathIndex mPathIndex;
 
     bool LoadMainMPQ(bool enableWriting, bool generateCrcMap);
     bool LoadPatchMPQs();
     bool LoadPatchMPQ(const std::string& path, bool validateVersion = false);
+    bool LoadContainer(const std::string& path, bool validateVersion = false);
+    bool ProcessVersionFile(std::shared_ptr<OtrFile> versionFile);
     void GenerateCrcMap();
     bool ProcessOtrVersion(HANDLE mpqHandle = nullptr);
+    void BuildPathIndex();
+    void RemoveFromPathIndex(const std::string& path);
+    bool LoadFileView(HANDLE fileHandle, OtrFile& file);
+    bool AddFileToMpq(const std::string& path, uintptr_t fileData, DWORD fileSize, DWORD compression,
+                      const void* const* sectors, const DWORD* sectorSizes);
     std::shared_ptr<OtrFile> LoadFileFromHandle(const std::string& filePath, bool includeParent = true,
                                                 HANDLE mpqHandle = nullptr);
 };
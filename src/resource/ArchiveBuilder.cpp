@@ -0,0 +1,187 @@
+#include "ArchiveBuilder.h"
+#include "Archive.h"
+#include <algorithm>
+#include <spdlog/spdlog.h>
+
+// ArchiveCodec::Smallest judges compression on a sample from the start of each file, in chunks of the sector size
+#define ARCHIVE_BUILDER_SAMPLE_SIZE (64 * 1024)
+// Files that don't shrink below this fraction of their size are stored by ArchiveCodec::Smallest
+#define ARCHIVE_BUILDER_STORE_RATIO 0.97
+// StormLib gives its compressors this much room past the sector
+#define ARCHIVE_BUILDER_COMPRESS_SLACK 0x100
+// Bounds how much prepared data waits for the writer
+#define ARCHIVE_BUILDER_PENDING_PER_THREAD 4
+
+namespace Ship {
+static size_t GetThreadCount(size_t threadCount) {
+    if (threadCount != 0) {
+        return threadCount;
+    }
+
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+ArchiveBuilder::ArchiveBuilder(std::shared_ptr<Archive> archive, ArchiveCodec codec, size_t threadCount)
+    : mArchive(archive), mCodec(codec), mSectorSize(archive->GetSectorSize()),
+      mMaxPending(GetThreadCount(threadCount) * ARCHIVE_BUILDER_PENDING_PER_THREAD),
+      mThreadPool(GetThreadCount(threadCount)), mFinishing(false), mSuccess(mSectorSize != 0) {
+    mWriterThread = std::thread(&ArchiveBuilder::WriterThreadMain, this);
+}
+
+ArchiveBuilder::~ArchiveBuilder() {
+    Finish();
+}
+
+bool ArchiveBuilder::AddFile(const std::string& path, std::vector<char> data) {
+    return Enqueue(path, [this, path, data = std::move(data)]() mutable { return Prepare(path, std::move(data)); });
+}
+
+bool ArchiveBuilder::AddFile(const std::string& path, std::function<std::vector<char>()> producer) {
+    return Enqueue(path, [this, path, producer]() { return Prepare(path, producer()); });
+}
+
+bool ArchiveBuilder::Enqueue(const std::string& path, std::function<PreparedFile()> prepare) {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mChanged.wait(lock, [this] { return mPending.size() < mMaxPending || mFinishing; });
+    if (mFinishing) {
+        SPDLOG_ERROR("Can't add {} to the archive, the builder is already finished", path);
+        return false;
+    }
+    mPending.push_back(mThreadPool.submit(std::move(prepare)));
+    lock.unlock();
+
+    mChanged.notify_all();
+    return true;
+}
+
+bool ArchiveBuilder::Finish() {
+    {
+        const std::lock_guard<std::mutex> lock(mMutex);
+        mFinishing = true;
+    }
+    mChanged.notify_all();
+
+    if (mWriterThread.joinable()) {
+        mWriterThread.join();
+    }
+
+    const std::lock_guard<std::mutex> lock(mMutex);
+    return mSuccess;
+}
+
+ArchiveBuilder::PreparedFile ArchiveBuilder::Prepare(std::string path, std::vector<char> data) {
+    PreparedFile file;
+    file.Path = std::move(path);
+    file.Data = std::move(data);
+    file.Compression = ChooseCompression(file.Data);
+    if (file.Compression != 0) {
+        CompressSectors(file);
+    }
+
+    return file;
+}
+
+void ArchiveBuilder::CompressSectors(PreparedFile& file) {
+    // Split and compressed exactly like SFileWriteFile would, so the writer only has to copy the results
+    const size_t sectorCount = (file.Data.size() + mSectorSize - 1) / mSectorSize;
+    file.Sectors.resize(file.Data.size() + ARCHIVE_BUILDER_COMPRESS_SLACK);
+    file.SectorSizes.resize(sectorCount);
+
+    size_t outPos = 0;
+    for (size_t i = 0; i < sectorCount; i++) {
+        const size_t inPos = i * mSectorSize;
+        const int inSize = (int)std::min<size_t>(file.Data.size() - inPos, mSectorSize);
+        int outSize = inSize;
+        SCompCompress(file.Sectors.data() + outPos, &outSize, file.Data.data() + inPos, inSize, file.Compression, 0,
+                      -1);
+        file.SectorSizes[i] = outSize;
+        outPos += outSize;
+    }
+    file.Sectors.resize(outPos);
+}
+
+uint32_t ArchiveBuilder::ChooseCompression(const std::vector<char>& data) {
+    static const uint32_t sCandidates[] = { MPQ_COMPRESSION_ZLIB, MPQ_COMPRESSION_BZIP2, MPQ_COMPRESSION_LZMA };
+
+    // Without a sector size the archive isn't open, Finish already reports the failure
+    if (data.empty() || mSectorSize == 0) {
+        return 0;
+    }
+
+    // Fixed codecs compress every file like Archive::AddFile does, StormLib stores the sectors that don't shrink
+    switch (mCodec) {
+        case ArchiveCodec::None:
+            return 0;
+        case ArchiveCodec::Zlib:
+            return MPQ_COMPRESSION_ZLIB;
+        case ArchiveCodec::Bzip2:
+            return MPQ_COMPRESSION_BZIP2;
+        case ArchiveCodec::Lzma:
+            return MPQ_COMPRESSION_LZMA;
+        case ArchiveCodec::Smallest:
+            break;
+    }
+
+    const size_t sampleSize = std::min<size_t>(data.size(), ARCHIVE_BUILDER_SAMPLE_SIZE);
+    std::vector<char> out(mSectorSize + ARCHIVE_BUILDER_COMPRESS_SLACK);
+    uint32_t best = 0;
+    size_t bestSize = (size_t)(sampleSize * ARCHIVE_BUILDER_STORE_RATIO);
+    for (uint32_t candidate : sCandidates) {
+        size_t compressedSize = 0;
+        for (size_t pos = 0; pos < sampleSize; pos += mSectorSize) {
+            const int inSize = (int)std::min<size_t>(sampleSize - pos, mSectorSize);
+            int outSize = inSize;
+            SCompCompress(out.data(), &outSize, (void*)(data.data() + pos), inSize, candidate, 0, -1);
+            compressedSize += outSize;
+        }
+
+        if (compressedSize < bestSize) {
+            best = candidate;
+            bestSize = compressedSize;
+        }
+    }
+
+    return best;
+}
+
+void ArchiveBuilder::WriterThreadMain() {
+    while (true) {
+        std::future<PreparedFile> next;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mChanged.wait(lock, [this] { return !mPending.empty() || mFinishing; });
+            if (mPending.empty()) {
+                return;
+            }
+            next = std::move(mPending.front());
+            mPending.pop_front();
+        }
+        mChanged.notify_all();
+
+        bool written;
+        try {
+            PreparedFile file = next.get();
+            if (file.Compression == 0) {
+                written = mArchive->AddFile(file.Path, (uintptr_t)file.Data.data(), file.Data.size(), 0);
+            } else {
+                std::vector<const void*> sectors(file.SectorSizes.size());
+                size_t pos = 0;
+                for (size_t i = 0; i < sectors.size(); i++) {
+                    sectors[i] = file.Sectors.data() + pos;
+                    pos += file.SectorSizes[i];
+                }
+                written = mArchive->AddPrecompressedFile(file.Path, (uintptr_t)file.Data.data(), file.Data.size(),
+                                                         file.Compression, sectors.data(), file.SectorSizes.data());
+            }
+        } catch (const std::exception& e) {
+            SPDLOG_ERROR("Failed to prepare file for archive: {}", e.what());
+            written = false;
+        }
+
+        if (!written) {
+            const std::lock_guard<std::mutex> lock(mMutex);
+            mSuccess = false;
+        }
+    }
+}
+} // namespace Ship
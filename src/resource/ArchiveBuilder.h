@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <StormLib.h>
+#include "thread-pool/BS_thread_pool.hpp"
+
+namespace Ship {
+class Archive;
+
+enum class ArchiveCodec {
+    None,
+    Zlib,
+    Bzip2,
+    Lzma,
+    // Tries every codec on a sample of each file and keeps the smallest. Unlike the fixed codecs, files that don't
+    // shrink below 97% of their size are stored, reading them back then skips decompression.
+    Smallest,
+};
+
+// Builds an archive from many files at once. Producing each file's data, picking its compression and compressing its
+// sectors happen on a worker pool, a single writer thread adds the files to the archive in the order they were added to
+// the builder, so the same input always gives the same archive.
+class ArchiveBuilder {
+  public:
+    // A threadCount of 0 uses one worker per hardware thread
+    ArchiveBuilder(std::shared_ptr<Archive> archive, ArchiveCodec codec = ArchiveCodec::Zlib, size_t threadCount = 0);
+    ~ArchiveBuilder();
+
+    // Both return false once Finish was called
+    bool AddFile(const std::string& path, std::vector<char> data);
+    // The producer runs on a worker, use it for work like serializing an asset
+    bool AddFile(const std::string& path, std::function<std::vector<char>()> producer);
+    // Waits for every added file to be written. Returns false if any of them failed.
+    bool Finish();
+
+  private:
+    struct PreparedFile {
+        std::string Path;
+        std::vector<char> Data;
+        uint32_t Compression;
+        // The compressed sectors back to back, only when Compression is set
+        std::vector<char> Sectors;
+        std::vector<DWORD> SectorSizes;
+    };
+
+    PreparedFile Prepare(std::string path, std::vector<char> data);
+    uint32_t ChooseCompression(const std::vector<char>& data);
+    void CompressSectors(PreparedFile& file);
+    bool Enqueue(const std::string& path, std::function<PreparedFile()> prepare);
+    void WriterThreadMain();
+
+    std::shared_ptr<Archive> mArchive;
+    ArchiveCodec mCodec;
+    DWORD mSectorSize;
+    size_t mMaxPending;
+    BS::thread_pool mThreadPool;
+
+    std::mutex mMutex;
+    std::condition_variable mChanged;
+    std::deque<std::future<PreparedFile>> mPending;
+    bool mFinishing;
+    bool mSuccess;
+    std::thread mWriterThread;
+};
+} // namespace Ship
@@ -0,0 +1,325 @@
+#include "ContainerArchive.h"
+#include "Archive.h"
+#include "OtrFile.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <cstring>
+#include <StrHash64.h>
+#include <spdlog/spdlog.h>
+#include "Utils/StringHelper.h"
+
+#define CONTAINER_MAGIC "LUSC"
+#define CONTAINER_VERSION 1
+#define CONTAINER_HEADER_SIZE 32
+#define CONTAINER_ENTRY_SIZE 32
+#define CONTAINER_FRAME_ALIGNMENT 16
+// Same slack StormLib gives its compressors for data that grows
+#define CONTAINER_COMPRESS_SLACK 0x100
+
+namespace Ship {
+static void PutU32(uint8_t* dest, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        dest[i] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+static void PutU64(uint8_t* dest, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        dest[i] = (uint8_t)(value >> (i * 8));
+    }
+}
+
+static uint32_t GetU32(const uint8_t* src) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= (uint32_t)src[i] << (i * 8);
+    }
+    return value;
+}
+
+static uint64_t GetU64(const uint8_t* src) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= (uint64_t)src[i] << (i * 8);
+    }
+    return value;
+}
+
+// MPQ lookups ignore case and slash direction, the container has to match
+static std::string NormalizePath(const std::string& filePath) {
+    std::string normalized = filePath;
+    for (char& c : normalized) {
+        c = c == '\\' ? '/' : (char)tolower((unsigned char)c);
+    }
+
+    return normalized;
+}
+
+uint64_t ContainerPathHash(const std::string& filePath) {
+    return CRC64(NormalizePath(filePath).c_str());
+}
+
+bool ContainerArchive::IsContainerPath(const std::string& path) {
+    const std::string extension = CONTAINER_ARCHIVE_EXTENSION;
+    return path.size() >= extension.size() &&
+           StringHelper::IEquals(path.substr(path.size() - extension.size()), extension);
+}
+
+std::shared_ptr<ContainerArchive> ContainerArchive::Open(const std::string& path) {
+    std::shared_ptr<ContainerArchive> archive(new ContainerArchive());
+    archive->mPath = path;
+    archive->mStream.open(path, std::ios::in | std::ios::binary);
+    if (!archive->mStream.is_open()) {
+        SPDLOG_ERROR("Failed to open container {}", path);
+        return nullptr;
+    }
+
+    uint8_t header[CONTAINER_HEADER_SIZE];
+    if (!archive->mStream.read((char*)header, sizeof(header)) || memcmp(header, CONTAINER_MAGIC, 4) != 0 ||
+        GetU32(header + 4) != CONTAINER_VERSION) {
+        SPDLOG_ERROR("{} is not a supported container", path);
+        return nullptr;
+    }
+
+    const uint32_t fileCount = GetU32(header + 8);
+    const uint32_t namesSize = GetU32(header + 12);
+    const uint64_t directoryOffset = GetU64(header + 16);
+    const uint64_t namesOffset = GetU64(header + 24);
+
+    std::vector<uint8_t> directory((size_t)fileCount * CONTAINER_ENTRY_SIZE);
+    std::vector<char> names(namesSize);
+    archive->mStream.seekg(directoryOffset);
+    archive->mStream.read((char*)directory.data(), directory.size());
+    archive->mStream.seekg(namesOffset);
+    archive->mStream.read(names.data(), names.size());
+    if (!archive->mStream || (namesSize > 0 && names.back() != '\0')) {
+        SPDLOG_ERROR("The directory of container {} is truncated", path);
+        return nullptr;
+    }
+
+    archive->mEntries.reserve(fileCount);
+    archive->mNames.reserve(fileCount);
+    for (uint32_t i = 0; i < fileCount; i++) {
+        const uint8_t* raw = directory.data() + (size_t)i * CONTAINER_ENTRY_SIZE;
+        const uint32_t nameOffset = GetU32(raw + 24);
+        if (nameOffset >= namesSize) {
+            SPDLOG_ERROR("Container {} has a directory entry without a name", path);
+            return nullptr;
+        }
+
+        archive->mEntries.push_back(
+            { GetU64(raw), GetU64(raw + 8), GetU32(raw + 16), GetU32(raw + 20), i, (ContainerCodec)raw[28] });
+        archive->mNames.emplace_back(names.data() + nameOffset);
+    }
+
+    archive->mMapping = MappedFile::Open(path);
+
+    // Written sorted, sorting again only guards the binary search against other writers
+    std::stable_sort(archive->mEntries.begin(), archive->mEntries.end(),
+                     [](const Entry& a, const Entry& b) { return a.Hash < b.Hash; });
+
+    return archive;
+}
+
+const std::string& ContainerArchive::GetPath() const {
+    return mPath;
+}
+
+const std::vector<std::string>& ContainerArchive::GetFileNames() const {
+    return mNames;
+}
+
+const ContainerArchive::Entry* ContainerArchive::FindEntry(const std::string& filePath) const {
+    const std::string normalized = NormalizePath(filePath);
+    const uint64_t hash = CRC64(normalized.c_str());
+    auto it = std::lower_bound(mEntries.begin(), mEntries.end(), hash,
+                               [](const Entry& entry, uint64_t value) { return entry.Hash < value; });
+
+    // Entries sharing a hash are told apart by name
+    for (; it != mEntries.end() && it->Hash == hash; it++) {
+        if (NormalizePath(mNames[it->NameIndex]) == normalized) {
+            return &*it;
+        }
+    }
+
+    return nullptr;
+}
+
+bool ContainerArchive::HasFile(const std::string& filePath) const {
+    return FindEntry(filePath) != nullptr;
+}
+
+bool ContainerArchive::LoadFile(const std::string& filePath, OtrFile& file) {
+    const Entry* entry = FindEntry(filePath);
+    if (entry == nullptr) {
+        return false;
+    }
+
+    std::vector<char> stored;
+    char* storedData;
+    const bool mapped = mMapping != nullptr && entry->Offset + entry->StoredSize <= mMapping->GetSize();
+    if (mapped) {
+        storedData = mMapping->GetData() + entry->Offset;
+    } else {
+        stored.resize(entry->StoredSize);
+        storedData = stored.data();
+        const std::lock_guard<std::mutex> lock(mStreamMutex);
+        mStream.clear();
+        mStream.seekg(entry->Offset);
+        mStream.read(stored.data(), stored.size());
+        if (!mStream) {
+            SPDLOG_ERROR("Failed to read {} from container {}", filePath, mPath);
+            return false;
+        }
+    }
+
+    switch (entry->Codec) {
+        case ContainerCodec::Stored:
+            if (mapped) {
+                file.SetView(mMapping, storedData, entry->StoredSize);
+            } else {
+                file.SetBuffer(std::move(stored));
+            }
+            break;
+        case ContainerCodec::StormLib: {
+            int outSize = entry->Size;
+            // The decompressor of V2 MPQs, the only one that handles LZMA
+            if (!SCompDecompress2(file.Allocate(entry->Size), &outSize, storedData, (int)entry->StoredSize) ||
+                (uint32_t)outSize != entry->Size) {
+                SPDLOG_ERROR("Failed to decompress {} from container {}", filePath, mPath);
+                return false;
+            }
+            break;
+        }
+        default:
+            SPDLOG_ERROR("{} in container {} uses codec {} which this build doesn't support", filePath, mPath,
+                         (int)entry->Codec);
+            return false;
+    }
+
+    file.Path = filePath;
+    file.IsLoaded = true;
+    return true;
+}
+
+bool ContainerArchive::ConvertFromOtr(const std::string& otrPath, const std::string& outPath, uint32_t compression) {
+    auto archive = std::make_shared<Archive>(otrPath, "", std::unordered_set<uint32_t>(), false);
+    if (!archive->IsMainMPQValid()) {
+        return false;
+    }
+
+    ContainerWriter writer;
+    if (!writer.Open(outPath)) {
+        return false;
+    }
+
+    auto fileNames = archive->ListFiles("*");
+    for (const auto& fileName : *fileNames) {
+        // MPQ bookkeeping like (listfile) and (attributes), the container has its own directory
+        if (fileName.starts_with("(")) {
+            continue;
+        }
+
+        auto file = archive->LoadFile(fileName, false);
+        if (file == nullptr || !writer.AddFile(fileName, file->GetData(), file->GetSize(), compression)) {
+            SPDLOG_ERROR("Failed to convert {} from {}", fileName, otrPath);
+            return false;
+        }
+    }
+
+    return writer.Close();
+}
+
+bool ContainerWriter::Open(const std::string& path) {
+    mStream.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!mStream.is_open()) {
+        SPDLOG_ERROR("Failed to create container {}", path);
+        return false;
+    }
+
+    // The header is written for real once the directory offsets are known
+    const uint8_t header[CONTAINER_HEADER_SIZE] = { 0 };
+    mStream.write((const char*)header, sizeof(header));
+    mPosition = sizeof(header);
+    mEntries.clear();
+    mNames.clear();
+    return mStream.good();
+}
+
+bool ContainerWriter::AddFile(const std::string& filePath, const char* data, size_t size, uint32_t compression) {
+    if (size > UINT32_MAX) {
+        return false;
+    }
+
+    const uint64_t padding =
+        (CONTAINER_FRAME_ALIGNMENT - mPosition % CONTAINER_FRAME_ALIGNMENT) % CONTAINER_FRAME_ALIGNMENT;
+    const char zeros[CONTAINER_FRAME_ALIGNMENT] = { 0 };
+    mStream.write(zeros, padding);
+    mPosition += padding;
+
+    PendingEntry entry;
+    entry.Hash = ContainerPathHash(filePath);
+    entry.Offset = mPosition;
+    entry.Size = size;
+    entry.NameOffset = mNames.size();
+    entry.Codec = ContainerCodec::Stored;
+
+    std::vector<char> compressed;
+    if (compression != 0 && size > 0) {
+        compressed.resize(size + CONTAINER_COMPRESS_SLACK);
+        int outSize = compressed.size();
+        SCompCompress(compressed.data(), &outSize, (void*)data, (int)size, compression, 0, -1);
+        // Data that doesn't shrink is stored, it then loads without decompressing
+        if ((size_t)outSize < size) {
+            entry.Codec = ContainerCodec::StormLib;
+            data = compressed.data();
+            size = outSize;
+        }
+    }
+
+    entry.StoredSize = size;
+    mStream.write(data, size);
+    mPosition += size;
+
+    mNames.append(filePath);
+    mNames.push_back('\0');
+    mEntries.push_back(entry);
+    return mStream.good();
+}
+
+bool ContainerWriter::Close() {
+    if (!mStream.is_open()) {
+        return false;
+    }
+
+    std::stable_sort(mEntries.begin(), mEntries.end(),
+                     [](const PendingEntry& a, const PendingEntry& b) { return a.Hash < b.Hash; });
+
+    const uint64_t directoryOffset = mPosition;
+    for (const auto& entry : mEntries) {
+        uint8_t raw[CONTAINER_ENTRY_SIZE] = { 0 };
+        PutU64(raw, entry.Hash);
+        PutU64(raw + 8, entry.Offset);
+        PutU32(raw + 16, entry.StoredSize);
+        PutU32(raw + 20, entry.Size);
+        PutU32(raw + 24, entry.NameOffset);
+        raw[28] = (uint8_t)entry.Codec;
+        mStream.write((const char*)raw, sizeof(raw));
+    }
+    const uint64_t namesOffset = directoryOffset + mEntries.size() * CONTAINER_ENTRY_SIZE;
+    mStream.write(mNames.data(), mNames.size());
+
+    uint8_t header[CONTAINER_HEADER_SIZE] = { 0 };
+    memcpy(header, CONTAINER_MAGIC, 4);
+    PutU32(header + 4, CONTAINER_VERSION);
+    PutU32(header + 8, mEntries.size());
+    PutU32(header + 12, mNames.size());
+    PutU64(header + 16, directoryOffset);
+    PutU64(header + 24, namesOffset);
+    mStream.seekp(0);
+    mStream.write((const char*)header, sizeof(header));
+
+    mStream.close();
+    return !mStream.fail();
+}
+} // namespace Ship
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define CONTAINER_ARCHIVE_EXTENSION ".lus"
+
+// Container layout, all values little endian:
+//   Header (32 bytes): "LUSC", u32 version, u32 file count, u32 names size, u64 directory offset, u64 names offset
+//   File data: one frame per file, each starting on a 16 byte boundary
+//   Directory: one 32 byte entry per file, sorted by the CRC64 of the normalized path (lower case, '/' separators):
+//     u64 hash, u64 offset, u32 stored size, u32 size, u32 name offset, u8 codec, 3 bytes padding
+//   Names: the original paths, null terminated
+// Readers refuse any other version, a change to the layout bumps it. A new codec like LZ4 or zstd only adds a
+// ContainerCodec value, readers that don't know it fail to load just the files using it.
+namespace Ship {
+struct OtrFile;
+class MappedFile;
+
+enum class ContainerCodec : uint8_t {
+    Stored = 0,
+    // A StormLib compression frame, its first byte says which compressors were applied
+    StormLib = 1,
+};
+
+// Read side of the native container format. Every lookup is a binary search in the directory and every load a single
+// read of one frame, there are no per-file handles like with MPQs. Compressed frames still go through SCompDecompress2
+// like MPQ sectors do. Where the container can be mapped, stored frames are handed out as views into the mapping and
+// compressed ones are decompressed straight from it.
+class ContainerArchive {
+  public:
+    static std::shared_ptr<ContainerArchive> Open(const std::string& path);
+    static bool IsContainerPath(const std::string& path);
+    // Writes every file of an .otr into a new container, compressed with the given StormLib compression (0 stores)
+    static bool ConvertFromOtr(const std::string& otrPath, const std::string& outPath, uint32_t compression);
+
+    const std::string& GetPath() const;
+    bool HasFile(const std::string& filePath) const;
+    // Fills the buffer of file, returns false if the container doesn't have it or it can't be read
+    bool LoadFile(const std::string& filePath, OtrFile& file);
+    const std::vector<std::string>& GetFileNames() const;
+
+  private:
+    struct Entry {
+        uint64_t Hash;
+        uint64_t Offset;
+        uint32_t StoredSize;
+        uint32_t Size;
+        uint32_t NameIndex;
+        ContainerCodec Codec;
+    };
+
+    ContainerArchive() = default;
+    const Entry* FindEntry(const std::string& filePath) const;
+
+    std::string mPath;
+    std::ifstream mStream;
+    // Frames are read with a seek and a read on the one stream
+    std::mutex mStreamMutex;
+    std::shared_ptr<MappedFile> mMapping;
+    std::vector<Entry> mEntries;
+    std::vector<std::string> mNames;
+};
+
+// Writes a container. Frames go out as files are added, the directory is written on Close.
+class ContainerWriter {
+  public:
+    bool Open(const std::string& path);
+    bool AddFile(const std::string& filePath, const char* data, size_t size, uint32_t compression);
+    bool Close();
+
+  private:
+    struct PendingEntry {
+        uint64_t Hash;
+        uint64_t Offset;
+        uint32_t StoredSize;
+        uint32_t Size;
+        uint32_t NameOffset;
+        ContainerCodec Codec;
+    };
+
+    std::ofstream mStream;
+    uint64_t mPosition = 0;
+    std::vector<PendingEntry> mEntries;
+    std::string mNames;
+};
+
+uint64_t ContainerPathHash(const std::string& filePath);
+} // namespace Ship
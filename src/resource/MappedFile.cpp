@@ -0,0 +1,93 @@
+#include "MappedFile.h"
+#include <stdint.h>
+#include <cerrno>
+#include <spdlog/spdlog.h>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif (defined(__unix__) || defined(__APPLE__)) && !defined(__SWITCH__) && !defined(__vita__)
+#define MAPPED_FILE_POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Ship {
+std::shared_ptr<MappedFile> MappedFile::Open(const std::string& path) {
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0 || (uint64_t)size.QuadPart > SIZE_MAX) {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    // The view keeps the mapping and the file open, neither handle is needed once it exists
+    HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    CloseHandle(file);
+    if (mapping == NULL) {
+        SPDLOG_WARN("({}) Failed to map {}", GetLastError(), path);
+        return nullptr;
+    }
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data == NULL) {
+        SPDLOG_WARN("({}) Failed to map {}", GetLastError(), path);
+        return nullptr;
+    }
+
+    std::shared_ptr<MappedFile> mappedFile(new MappedFile());
+    mappedFile->mData = (char*)data;
+    mappedFile->mSize = (size_t)size.QuadPart;
+    return mappedFile;
+#elif defined(MAPPED_FILE_POSIX)
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0 || (uint64_t)st.st_size > SIZE_MAX) {
+        close(fd);
+        return nullptr;
+    }
+
+    void* data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        SPDLOG_WARN("({}) Failed to map {}", errno, path);
+        return nullptr;
+    }
+
+    std::shared_ptr<MappedFile> mappedFile(new MappedFile());
+    mappedFile->mData = (char*)data;
+    mappedFile->mSize = (size_t)st.st_size;
+    return mappedFile;
+#else
+    return nullptr;
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if defined(_WIN32)
+    UnmapViewOfFile(mData);
+#elif defined(MAPPED_FILE_POSIX)
+    munmap(mData, mSize);
+#endif
+}
+
+char* MappedFile::GetData() const {
+    return mData;
+}
+
+size_t MappedFile::GetSize() const {
+    return mSize;
+}
+} // namespace Ship
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <stddef.h>
+#include <memory>
+#include <string>
+
+namespace Ship {
+// A whole file mapped into memory. The mapping is private: writes through GetData() land in copies of the touched pages
+// and never reach the file, so data handed out of it can be patched like any heap buffer.
+class MappedFile {
+  public:
+    // Returns nullptr if the file can't be mapped, including on platforms without file mappings. Callers then read it.
+    static std::shared_ptr<MappedFile> Open(const std::string& path);
+    ~MappedFile();
+
+    char* GetData() const;
+    size_t GetSize() const;
+
+  private:
+    MappedFile() = default;
+
+    char* mData = nullptr;
+    size_t mSize = 0;
+};
+} // namespace Ship
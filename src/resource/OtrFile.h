@@ -10,7 +10,41 @@ class Archive;
 struct OtrFile {
     std::shared_ptr<Archive> Parent;
     std::string Path;
-    std::vector<char> Buffer;
     bool IsLoaded = false;
+
+    // Files stored uncompressed in a mapped archive aren't copied, they are a view into the mapping. GetData and
+    // GetSize handle both, the storage itself stays private so no reader can pick the wrong one.
+    char* GetData() {
+        return mView != nullptr ? mViewData : mBuffer.data();
+    }
+
+    size_t GetSize() const {
+        return mView != nullptr ? mViewSize : mBuffer.size();
+    }
+
+    // Returns size bytes owned by the file for the loader to fill
+    char* Allocate(size_t size) {
+        SetBuffer(std::vector<char>(size));
+        return mBuffer.data();
+    }
+
+    void SetBuffer(std::vector<char> buffer) {
+        mView = nullptr;
+        mBuffer = std::move(buffer);
+    }
+
+    // owner keeps the memory behind data alive for as long as the file is
+    void SetView(std::shared_ptr<void> owner, char* data, size_t size) {
+        mBuffer.clear();
+        mView = std::move(owner);
+        mViewData = data;
+        mViewSize = size;
+    }
+
+  private:
+    std::vector<char> mBuffer;
+    std::shared_ptr<void> mView;
+    char* mViewData = nullptr;
+    size_t mViewSize = 0;
 };
 } // namespace Ship
@@ -0,0 +1,85 @@
+#include "PathIndex.h"
+
+// Comes from stormlib. Matching with it keeps the index consistent with MPQ searches.
+extern bool SFileCheckWildCard(const char* szString, const char* szWildCard);
+
+namespace Ship {
+bool PathIndex::EntryLess::operator()(const Entry& a, const Entry& b) const {
+    // Paths that only differ in case are kept apart, the folded path decides the order first
+    return a.Folded != b.Folded ? a.Folded < b.Folded : a.Path < b.Path;
+}
+
+bool PathIndex::EntryLess::operator()(const Entry& a, std::string_view b) const {
+    return a.Folded < b;
+}
+
+bool PathIndex::EntryLess::operator()(std::string_view a, const Entry& b) const {
+    return a < b.Folded;
+}
+
+// Same folding StormLib applies when it hashes and compares names
+std::string PathIndex::Fold(std::string_view path) {
+    std::string folded(path);
+    for (char& c : folded) {
+        if (c == '/') {
+            c = '\\';
+        } else if (c >= 'a' && c <= 'z') {
+            c = c - 'a' + 'A';
+        }
+    }
+
+    return folded;
+}
+
+void PathIndex::Add(const std::string& path) {
+    mEntries.insert({ Fold(path), path });
+}
+
+void PathIndex::Remove(const std::string& path) {
+    mEntries.erase({ Fold(path), path });
+}
+
+void PathIndex::Clear() {
+    mEntries.clear();
+}
+
+size_t PathIndex::Size() const {
+    return mEntries.size();
+}
+
+bool PathIndex::Contains(const std::string& path) const {
+    const std::string folded = Fold(path);
+    auto it = mEntries.lower_bound(std::string_view(folded));
+    return it != mEntries.end() && it->Folded == folded;
+}
+
+template <typename F> void PathIndex::ForEachMatch(const std::string& searchMask, F onMatch) const {
+    const std::string prefix = Fold(searchMask.substr(0, searchMask.find_first_of("*?")));
+    for (auto it = mEntries.lower_bound(std::string_view(prefix));
+         it != mEntries.end() && it->Folded.compare(0, prefix.size(), prefix) == 0; it++) {
+        if (SFileCheckWildCard(it->Path.c_str(), searchMask.c_str()) && !onMatch(it->Path)) {
+            return;
+        }
+    }
+}
+
+std::vector<std::string> PathIndex::Find(const std::string& searchMask) const {
+    std::vector<std::string> result;
+    ForEachMatch(searchMask, [&result](const std::string& path) {
+        result.push_back(path);
+        return true;
+    });
+
+    return result;
+}
+
+bool PathIndex::HasMatch(const std::string& searchMask) const {
+    bool found = false;
+    ForEachMatch(searchMask, [&found](const std::string&) {
+        found = true;
+        return false;
+    });
+
+    return found;
+}
+} // namespace Ship
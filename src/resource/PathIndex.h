@@ -0,0 +1,46 @@
+#pragma once
+
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Ship {
+// Sorted set of paths answering the same wildcard masks StormLib searches take ('*' and '?', ignoring case and slash
+// direction). A query only visits the paths starting with the literal part of the mask before its first wildcard, so
+// "textures/foo/*" costs a lookup plus the files under textures/foo/. Masks starting with a wildcard still visit
+// every path.
+class PathIndex {
+  public:
+    void Add(const std::string& path);
+    void Remove(const std::string& path);
+    void Clear();
+    size_t Size() const;
+
+    // True if a path equal to this one, apart from case and slash direction, was added
+    bool Contains(const std::string& path) const;
+    std::vector<std::string> Find(const std::string& searchMask) const;
+    bool HasMatch(const std::string& searchMask) const;
+
+  private:
+    struct Entry {
+        std::string Folded;
+        std::string Path;
+    };
+
+    // Orders entries by their folded path, and can compare them against a bare folded prefix for lookups
+    struct EntryLess {
+        using is_transparent = void;
+
+        bool operator()(const Entry& a, const Entry& b) const;
+        bool operator()(const Entry& a, std::string_view b) const;
+        bool operator()(std::string_view a, const Entry& b) const;
+    };
+
+    static std::string Fold(std::string_view path);
+    // Calls onMatch for each matching path in order until it returns false
+    template <typename F> void ForEachMatch(const std::string& searchMask, F onMatch) const;
+
+    std::set<Entry, EntryLess> mEntries;
+};
+} // namespace Ship
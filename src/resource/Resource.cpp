@@ -2,6 +2,7 @@
 #include "resource/type/DisplayList.h"
 #include "resource/ResourceMgr.h"
 #include <spdlog/spdlog.h>
+#include "log/lustrace.h"
 #include "libultraship/libultra/gbi.h"
 
 namespace Ship {
@@ -34,7 +35,7 @@ Resource::~Resource() {
 
     Patches.clear();
 
-    SPDLOG_TRACE("Resource Unloaded: {}\n", InitData->Path);
+    LUSTRACE("Resource Unloaded: %s", InitData->Path.c_str());
 }
 
 void Resource::RegisterResourceAddressPatch(uint64_t crc, uint32_t instructionIndex, intptr_t originalData) {
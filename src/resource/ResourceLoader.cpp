@@ -46,7 +46,8 @@ std::shared_ptr<Resource> ResourceLoader::LoadResource(std::shared_ptr<OtrFile>
     std::shared_ptr<Resource> result = nullptr;
 
     if (fileToLoad != nullptr) {
-        auto stream = std::make_shared<MemoryStream>(fileToLoad->Buffer.data(), fileToLoad->Buffer.size());
+        // The stream reads the file in place, resources that keep parts of it (like texture pixels) hold on to the file
+        auto stream = std::make_shared<MemoryStream>(fileToLoad->GetData(), fileToLoad->GetSize(), fileToLoad);
         auto reader = std::make_shared<BinaryReader>(stream);
 
         // Determine if file is binary or XML...
@@ -8,9 +8,8 @@
 #include <Utils/StringHelper.h>
 #include <StormLib.h>
 #include "core/bridge/consolevariablebridge.h"
-
-// Comes from stormlib. May not be the most efficient, but it's also important to be consistent.
-extern bool SFileCheckWildCard(const char* szString, const char* szWildCard);
+#include "log/lustrace.h"
+#include "debug/TraceEvents.h"
 
 namespace Ship {
 
@@ -18,6 +17,7 @@ ResourceMgr::ResourceMgr(std::shared_ptr<Window> context, const std::string& mai
                          const std::unordered_set<uint32_t>& validHashes)
     : mContext(context) {
     mResourceLoader = std::make_shared<ResourceLoader>(context);
+    mHdAssets = context->GetConsoleVariables()->GetIntegerHandle("gHdAssets", 0);
     mArchive = std::make_shared<Archive>(mainPath, patchesPath, validHashes, false);
 #if defined(__SWITCH__) || defined(__WIIU__)
     size_t threadCount = 1;
@@ -36,6 +36,7 @@ ResourceMgr::ResourceMgr(std::shared_ptr<Window> context, const std::vector<std:
                          const std::unordered_set<uint32_t>& validHashes)
     : mContext(context) {
     mResourceLoader = std::make_shared<ResourceLoader>(context);
+    mHdAssets = context->GetConsoleVariables()->GetIntegerHandle("gHdAssets", 0);
     mArchive = std::make_shared<Archive>(otrFiles, validHashes, false);
 #if defined(__SWITCH__) || defined(__WIIU__)
     size_t threadCount = 1;
@@ -61,7 +62,7 @@ bool ResourceMgr::DidLoadSuccessfully() {
 std::shared_ptr<OtrFile> ResourceMgr::LoadFileProcess(const std::string& filePath) {
     auto file = mArchive->LoadFile(filePath, true);
     if (file != nullptr) {
-        SPDLOG_TRACE("Loaded File {} on ResourceMgr", file->Path);
+        LUSTRACE("Loaded File %s on ResourceMgr", file->Path.c_str());
     } else {
         SPDLOG_WARN("Could not load File {} in ResourceMgr", filePath);
     }
@@ -69,6 +70,8 @@ std::shared_ptr<OtrFile> ResourceMgr::LoadFileProcess(const std::string& filePat
 }
 
 std::shared_ptr<Resource> ResourceMgr::LoadResourceProcess(const std::string& filePath, bool loadExact) {
+    LUS_TRACE_SPAN_DETAIL("ResourceMgr::LoadResourceProcess", "resource", filePath);
+
     // Check for and remove the OTR signature
     if (OtrSignatureCheck(filePath.c_str())) {
         const auto newFilePath = filePath.substr(7);
@@ -76,7 +79,7 @@ std::shared_ptr<Resource> ResourceMgr::LoadResourceProcess(const std::string& fi
     }
 
     // Attempt to load the HD version of the asset, if we fail then we continue trying to load the standard asset.
-    if (!loadExact && CVarGetInteger("gHdAssets", 0) && filePath.substr(0, 3) != "hd/") {
+    if (!loadExact && mHdAssets.Get() && filePath.substr(0, 3) != "hd/") {
         const auto hdPath = "hd/" + filePath;
         auto hdResource = LoadResourceProcess(hdPath, loadExact);
 
@@ -94,7 +97,7 @@ std::shared_ptr<Resource> ResourceMgr::LoadResourceProcess(const std::string& fi
     }
 
     // If we are attempting to load an HD asset, we can return null
-    if (!loadExact && CVarGetInteger("gHdAssets", 0) && filePath.substr(0, 3) == "hd/") {
+    if (!loadExact && mHdAssets.Get() && filePath.substr(0, 3) == "hd/") {
         if (std::holds_alternative<ResourceLoadError>(cacheLine)) {
             try {
                 // If we have attempted to cache an HD asset, but failed, we return nullptr and rely on the calling
@@ -132,10 +135,11 @@ std::shared_ptr<Resource> ResourceMgr::LoadResourceProcess(const std::string& fi
         } else {
             mResourceCache[filePath] = ResourceLoadError::NotFound;
         }
+        mCachedPaths.Add(filePath);
     }
 
     if (resource != nullptr) {
-        SPDLOG_TRACE("Loaded Resource {} on ResourceMgr", filePath);
+        LUSTRACE("Loaded Resource %s on ResourceMgr", filePath.c_str());
     } else {
         SPDLOG_WARN("Resource load FAILED {} on ResourceMgr", filePath);
     }
@@ -185,7 +189,7 @@ std::shared_ptr<Resource> ResourceMgr::LoadResource(const std::string& filePath)
 
 std::variant<ResourceMgr::ResourceLoadError, std::shared_ptr<Resource>>
 ResourceMgr::CheckCache(const std::string& filePath, bool loadExact) {
-    if (!loadExact && CVarGetInteger("gHdAssets", 0) && filePath.substr(0, 3) != "hd/") {
+    if (!loadExact && mHdAssets.Get() && filePath.substr(0, 3) != "hd/") {
         const auto hdPath = "hd/" + filePath;
         auto hdCacheResult = CheckCache(hdPath, loadExact);
 
@@ -264,16 +268,8 @@ std::shared_ptr<std::vector<std::shared_ptr<Resource>>> ResourceMgr::LoadDirecto
 }
 
 std::shared_ptr<std::vector<std::string>> ResourceMgr::FindLoadedFiles(const std::string& searchMask) {
-    const char* wildCard = searchMask.c_str();
-    auto list = std::make_shared<std::vector<std::string>>();
-
-    for (const auto& [key, value] : mResourceCache) {
-        if (SFileCheckWildCard(key.c_str(), wildCard)) {
-            list->push_back(key);
-        }
-    }
-
-    return list;
+    const std::lock_guard<std::mutex> lock(mMutex);
+    return std::make_shared<std::vector<std::string>>(mCachedPaths.Find(searchMask));
 }
 
 void ResourceMgr::DirtyDirectory(const std::string& searchMask) {
@@ -324,6 +320,7 @@ size_t ResourceMgr::UnloadResource(const std::string& filePath) {
         const std::lock_guard<std::mutex> lock(mMutex);
         value = mResourceCache[filePath];
         ret = mResourceCache.erase(filePath);
+        mCachedPaths.Remove(filePath);
     }
 
     return ret;
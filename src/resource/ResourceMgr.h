@@ -9,6 +9,7 @@
 #include "Resource.h"
 #include "ResourceLoader.h"
 #include "Archive.h"
+#include "PathIndex.h"
 #include "thread-pool/BS_thread_pool.hpp"
 
 namespace Ship {
@@ -60,9 +61,12 @@ class ResourceMgr {
   private:
     std::shared_ptr<Window> mContext;
     std::unordered_map<std::string, std::variant<ResourceLoadError, std::shared_ptr<Resource>>> mResourceCache;
+    // The keys of mResourceCache, for wildcard lookups
+    PathIndex mCachedPaths;
     std::shared_ptr<ResourceLoader> mResourceLoader;
     std::shared_ptr<Archive> mArchive;
     std::shared_ptr<BS::thread_pool> mThreadPool;
     std::mutex mMutex;
+    CVarHandle<int32_t> mHdAssets;
 };
 } // namespace Ship
@@ -4,6 +4,15 @@
 
 namespace Ship {
 
+// Pixels are used straight from the loaded file when the reader allows it, they are only copied out otherwise
+static void ReadImageData(std::shared_ptr<BinaryReader> reader, std::shared_ptr<Texture> texture, uint32_t dataSize) {
+    texture->ImageData = (uint8_t*)reader->ReadView(dataSize, texture->ImageDataOwner);
+    if (texture->ImageData == nullptr) {
+        texture->ImageData = new uint8_t[dataSize];
+        reader->Read((char*)texture->ImageData, dataSize);
+    }
+}
+
 std::shared_ptr<Resource> TextureFactory::ReadResource(std::shared_ptr<ResourceMgr> resourceMgr,
                                                        std::shared_ptr<ResourceInitData> initData,
                                                        std::shared_ptr<BinaryReader> reader) {
@@ -40,9 +49,7 @@ void TextureFactoryV0::ParseFileBinary(std::shared_ptr<BinaryReader> reader, std
     uint32_t dataSize = reader->ReadUInt32();
 
     texture->ImageDataSize = dataSize;
-    texture->ImageData = new uint8_t[dataSize];
-
-    reader->Read((char*)texture->ImageData, dataSize);
+    ReadImageData(reader, texture, dataSize);
 }
 
 void TextureFactoryV1::ParseFileBinary(std::shared_ptr<BinaryReader> reader, std::shared_ptr<Resource> resource) {
@@ -59,8 +66,6 @@ void TextureFactoryV1::ParseFileBinary(std::shared_ptr<BinaryReader> reader, std
     uint32_t dataSize = reader->ReadUInt32();
 
     texture->ImageDataSize = dataSize;
-    texture->ImageData = new uint8_t[dataSize];
-
-    reader->Read((char*)texture->ImageData, dataSize);
+    ReadImageData(reader, texture, dataSize);
 }
 } // namespace Ship
@@ -10,8 +10,8 @@ size_t Texture::GetPointerSize() {
 }
 
 Texture::~Texture() {
-    if (ImageData != nullptr) {
-        delete ImageData;
+    if (ImageData != nullptr && ImageDataOwner == nullptr) {
+        delete[] ImageData;
     }
 }
 } // namespace Ship
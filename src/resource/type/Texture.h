@@ -33,6 +33,8 @@ class Texture : public Resource {
     float VPixelScale = 1.0;
     uint32_t ImageDataSize;
     uint8_t* ImageData = nullptr;
+    // Set when ImageData points into the file the texture was loaded from instead of its own allocation
+    std::shared_ptr<void> ImageDataOwner;
 
     ~Texture();
 };
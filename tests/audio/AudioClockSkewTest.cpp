@@ -0,0 +1,146 @@
+// Clock skew harness for the audio latency controller. A simulated game queues 1/60 s of audio per tick on its own clock
+// while a simulated device pulls blocks on a clock that runs a little fast or slow, through the same resampler, latency
+// controller and ring buffer AudioPlayer uses. Without the controller the queued amount drifts by the skew every second
+// until the ring buffer overruns or the device underruns, with it the amount has to settle.
+#include "audio/AudioResampler.h"
+#include "audio/AudioRingBuffer.h"
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#define GAME_RATE 44100
+#define GAME_TICK_FRAMES (GAME_RATE / 60)
+#define DEVICE_BLOCK_FRAMES 512
+#define DESIRED_FRAMES 2480
+#define FRAME_SIZE 4
+#define RING_BUFFER_SIZE (8192 * FRAME_SIZE)
+#define SETTLE_SECONDS 60
+#define MEASURE_SECONDS 240
+
+namespace {
+struct SkewResult {
+    uint64_t Underruns;
+    uint64_t Overruns;
+    double FirstHalfQueued;
+    double SecondHalfQueued;
+};
+
+SkewResult Simulate(int deviceRate, double skew) {
+    Ship::AudioResampler resampler;
+    Ship::AudioLatencyController controller;
+    Ship::AudioRingBuffer ring(RING_BUFFER_SIZE);
+    std::vector<int16_t> tick(GAME_TICK_FRAMES * 2);
+    std::vector<int16_t> resampled;
+    std::vector<uint8_t> block(DEVICE_BLOCK_FRAMES * FRAME_SIZE);
+    SkewResult result = {};
+    double queuedSum[2] = {};
+    uint64_t queuedCount[2] = {};
+
+    const double actualDeviceRate = deviceRate * (1.0 + skew);
+    uint64_t ticks = 0;
+    uint64_t blocks = 0;
+    uint64_t phase = 0;
+    const double duration = SETTLE_SECONDS + MEASURE_SECONDS;
+    while (true) {
+        const double tickTime = ticks / 60.0;
+        const double blockTime = blocks * DEVICE_BLOCK_FRAMES / actualDeviceRate;
+        const double now = std::min(tickTime, blockTime);
+        if (now >= duration) {
+            break;
+        }
+        const bool measuring = now >= SETTLE_SECONDS;
+        const int half = now >= SETTLE_SECONDS + MEASURE_SECONDS / 2;
+
+        if (tickTime <= blockTime) {
+            for (size_t i = 0; i < GAME_TICK_FRAMES; i++) {
+                const int16_t sample = (int16_t)(8000 * std::sin(phase++ * 0.0627));
+                tick[i * 2] = sample;
+                tick[i * 2 + 1] = sample;
+            }
+
+            // Queued frames converted to the game rate, like AudioPlayer::RingBuffered
+            const int queued = (int)((int64_t)(ring.Size() / FRAME_SIZE) * GAME_RATE / deviceRate);
+            const double ratio = controller.Update((double)deviceRate / GAME_RATE, queued, DESIRED_FRAMES);
+            resampled.clear();
+            resampler.Process(tick.data(), GAME_TICK_FRAMES, ratio, resampled);
+            const size_t size = resampled.size() * sizeof(int16_t);
+            if (ring.Write((const uint8_t*)resampled.data(), size) < size && measuring) {
+                result.Overruns++;
+            }
+            if (measuring) {
+                queuedSum[half] += queued;
+                queuedCount[half]++;
+            }
+            ticks++;
+        } else {
+            if (ring.Read(block.data(), block.size()) < block.size() && measuring) {
+                result.Underruns++;
+            }
+            blocks++;
+        }
+    }
+
+    result.FirstHalfQueued = queuedSum[0] / queuedCount[0];
+    result.SecondHalfQueued = queuedSum[1] / queuedCount[1];
+    return result;
+}
+
+bool TestSkew(int deviceRate, double skew) {
+    const SkewResult result = Simulate(deviceRate, skew);
+    // A skew the controller can't absorb would keep moving the queued amount by about skew * rate every second
+    const double drift = std::abs(result.SecondHalfQueued - result.FirstHalfQueued);
+    const bool passed = result.Underruns == 0 && result.Overruns == 0 && drift < DESIRED_FRAMES * 0.05;
+
+    printf("%s %5d Hz, skew %+.2f%%: %llu underruns, %llu overruns, queued %.0f then %.0f frames\n",
+           passed ? "ok  " : "FAIL", deviceRate, skew * 100, (unsigned long long)result.Underruns,
+           (unsigned long long)result.Overruns, result.FirstHalfQueued, result.SecondHalfQueued);
+    return passed;
+}
+
+// At a ratio of exactly 1 the Hermite weights at whole positions pick single input frames, so the output has to be the
+// input delayed by the two history frames, however the input is split into calls
+bool TestIdentity() {
+    Ship::AudioResampler resampler;
+    std::vector<int16_t> in(1000 * 2);
+    for (size_t i = 0; i < in.size(); i++) {
+        in[i] = (int16_t)(i * 37);
+    }
+
+    std::vector<int16_t> out;
+    const size_t chunks[] = { 1, 7, 300, 2, 690 };
+    size_t offset = 0;
+    for (size_t chunk : chunks) {
+        resampler.Process(in.data() + offset * 2, chunk, 1.0, out);
+        offset += chunk;
+    }
+
+    if (out.size() != in.size()) {
+        printf("FAIL resampling at ratio 1 gave %zu frames for %zu\n", out.size() / 2, in.size() / 2);
+        return false;
+    }
+    for (size_t i = 0; i < out.size(); i++) {
+        const int16_t expected = i < 4 ? 0 : in[i - 4];
+        if (out[i] != expected) {
+            printf("FAIL resampling at ratio 1 changed sample %zu\n", i);
+            return false;
+        }
+    }
+
+    printf("ok   resampling at ratio 1 passes the input through\n");
+    return true;
+}
+} // namespace
+
+int main() {
+    bool passed = TestIdentity();
+    const int deviceRates[] = { 44100, 48000 };
+    const double skews[] = { -0.003, -0.001, 0.0, 0.001, 0.003 };
+    for (int deviceRate : deviceRates) {
+        for (double skew : skews) {
+            passed = TestSkew(deviceRate, skew) && passed;
+        }
+    }
+
+    printf("%s\n", passed ? "Latency settles under clock skew" : "Latency doesn't settle under clock skew");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+// Times each audio command of Ship::AudioMixer on its own. Buffers are sized like one voice of an audio update in the
+// games, 0x170 bytes of samples, so the numbers show which kernels dominate a command list.
+#include "audio/AudioMixer.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#ifndef _SHIFTL
+#define _SHIFTL(v, s, w) ((u32)(((u32)(v) & ((0x01 << (w)) - 1)) << (s)))
+#endif
+
+#define UPDATE_BYTES 0x170
+#define RUN_COUNT 200000
+#define STATE_SEGMENT 1
+#define STATE_ADDR ((u32)STATE_SEGMENT << 24)
+#define BOOK_SEGMENT 2
+#define BOOK_ADDR ((u32)BOOK_SEGMENT << 24)
+
+namespace {
+int16_t sState[16];
+int16_t sBook[8][2][8];
+
+void Randomize(void* data, size_t size) {
+    std::mt19937 rng(0x4C5553);
+    uint8_t* bytes = (uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (uint8_t)rng();
+    }
+}
+
+// Runs the setup commands once, then the timed commands RUN_COUNT times
+void Bench(Ship::AudioMixer& mixer, const char* name, const Acmd* setup, size_t setupCount, const Acmd* cmds,
+           size_t count) {
+    Randomize(mixer.GetDmem(0), AUDIO_MIXER_DMEM_SIZE);
+    Randomize(sBook, sizeof(sBook));
+    memset(sState, 0, sizeof(sState));
+    mixer.Execute(setup, setupCount);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < RUN_COUNT; i++) {
+        mixer.Execute(cmds, count);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const double ns = std::chrono::duration<double, std::nano>(elapsed).count() / RUN_COUNT;
+    printf("%-14s %8.1f ns/command %8.1f MB/s\n", name, ns, UPDATE_BYTES / ns * 1000.0);
+}
+} // namespace
+
+int main() {
+    Ship::AudioMixer mixer;
+    mixer.SetSegment(STATE_SEGMENT, sState);
+    mixer.SetSegment(BOOK_SEGMENT, sBook);
+    Acmd setup[3];
+    Acmd cmds[2];
+
+    aLoadADPCM(&setup[0], sizeof(sBook), BOOK_ADDR);
+    aSetBuffer(&setup[1], 0, 0x100, 0x400, UPDATE_BYTES);
+    aADPCMdec(&cmds[0], 0, STATE_ADDR);
+    Bench(mixer, "A_ADPCM", setup, 2, cmds, 1);
+
+    aSetBuffer(&setup[0], 0, 0x100, 0x400, UPDATE_BYTES);
+    aS8Dec(&cmds[0], 0, STATE_ADDR);
+    Bench(mixer, "A_S8DEC", setup, 1, cmds, 1);
+
+    aSetBuffer(&setup[0], 0, 0x200, 0x800, UPDATE_BYTES);
+    aResample(&cmds[0], 0, 0x6000, STATE_ADDR);
+    Bench(mixer, "A_RESAMPLE", setup, 1, cmds, 1);
+
+    aEnvSetup1(&setup[0], 0x40, 0x10, 0x20, 0x20);
+    aEnvSetup2(&setup[1], 0x4000, 0x3000);
+    aEnvMixer(&cmds[0], 0x100, UPDATE_BYTES / 2, 0, 0, 0, 0, 0, (0x40 << 24) | (0x58 << 16) | (0x70 << 8) | 0x88,
+              _SHIFTL(A_ENVMIXER, 24, 8));
+    Bench(mixer, "A_ENVMIXER", setup, 2, cmds, 1);
+
+    aMix(&cmds[0], UPDATE_BYTES >> 4, 0x4000, 0x200, 0x800);
+    Bench(mixer, "A_MIXER", setup, 0, cmds, 1);
+
+    aAddMixer(&cmds[0], UPDATE_BYTES, 0x200, 0x800, 0);
+    Bench(mixer, "A_ADDMIXER", setup, 0, cmds, 1);
+
+    aFilter(&setup[0], 2, UPDATE_BYTES, BOOK_ADDR);
+    aFilter(&cmds[0], 0, 0x300, STATE_ADDR);
+    Bench(mixer, "A_FILTER", setup, 1, cmds, 1);
+
+    aInterleave(&cmds[0], 0x800, 0x200, 0x500, UPDATE_BYTES);
+    Bench(mixer, "A_INTERLEAVE", setup, 0, cmds, 1);
+
+    aHiLoGain(&cmds[0], 0x20, UPDATE_BYTES, 0x400, 0);
+    Bench(mixer, "A_HILOGAIN", setup, 0, cmds, 1);
+
+    aDuplicate(&cmds[0], UPDATE_BYTES / 128, 0x100, 0x200, 0);
+    Bench(mixer, "A_DUPLICATE", setup, 0, cmds, 1);
+
+    aDMEMMove(&cmds[0], 0x200, 0x800, UPDATE_BYTES);
+    Bench(mixer, "A_DMEMMOVE", setup, 0, cmds, 1);
+
+    return 0;
+}
@@ -0,0 +1,691 @@
+// Golden output test of Ship::AudioMixer against the reference C mixer (mixer.c of the decompilation ports), which is
+// what games ran their command lists through before. The reference kernels below are kept as close to that code as
+// possible, including its integer promotions, so any difference in output is a bug in the native mixer.
+#include "audio/AudioMixer.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+#ifndef _SHIFTL
+#define _SHIFTL(v, s, w) ((u32)(((u32)(v) & ((0x01 << (w)) - 1)) << (s)))
+#endif
+
+#define ROUND_UP_32(v) (((v) + 31) & ~31)
+#define ROUND_UP_16(v) (((v) + 15) & ~15)
+#define ROUND_UP_8(v) (((v) + 7) & ~7)
+#define ROUND_DOWN_16(v) ((v) & ~0xF)
+
+#define STATE_SEGMENT 1
+#define STATE_ADDR(offset) (((u32)STATE_SEGMENT << 24) | (offset))
+#define BOOK_SEGMENT 2
+#define BOOK_ADDR ((u32)BOOK_SEGMENT << 24)
+#define LOOP_SEGMENT 3
+#define LOOP_ADDR ((u32)LOOP_SEGMENT << 24)
+
+namespace {
+struct ReferenceMixer {
+    uint16_t in;
+    uint16_t out;
+    uint16_t nbytes;
+    uint16_t vol[2];
+    uint16_t rate[2];
+    uint16_t volWet;
+    uint16_t rateWet;
+    int16_t adpcmTable[8][2][8];
+    const int16_t* adpcmLoopState;
+    int filterCount;
+    int16_t filter[8];
+    alignas(16) uint8_t dmem[AUDIO_MIXER_DMEM_SIZE];
+
+    int16_t* BufS16(uint16_t addr) {
+        return (int16_t*)(dmem + addr);
+    }
+};
+
+// Stored unsigned like the native table, the reference reads it as int16_t
+const uint16_t sRefResampleTable[64][4] = {
+    { 0x0c39, 0x66ad, 0x0d46, 0xffdf }, { 0x0b39, 0x6696, 0x0e5f, 0xffd8 },
+    { 0x0a44, 0x6669, 0x0f83, 0xffd0 }, { 0x095a, 0x6626, 0x10b4, 0xffc8 },
+    { 0x087d, 0x65cd, 0x11f0, 0xffbf }, { 0x07ab, 0x655e, 0x1338, 0xffb6 },
+    { 0x06e4, 0x64d9, 0x148c, 0xffac }, { 0x0628, 0x643f, 0x15eb, 0xffa1 },
+    { 0x0577, 0x638f, 0x1756, 0xff96 }, { 0x04d1, 0x62cb, 0x18cb, 0xff8a },
+    { 0x0435, 0x61f3, 0x1a4c, 0xff7e }, { 0x03a4, 0x6106, 0x1bd7, 0xff71 },
+    { 0x031c, 0x6007, 0x1d6c, 0xff64 }, { 0x029f, 0x5ef5, 0x1f0b, 0xff56 },
+    { 0x022a, 0x5dd0, 0x20b3, 0xff48 }, { 0x01be, 0x5c9a, 0x2264, 0xff3a },
+    { 0x015b, 0x5b53, 0x241e, 0xff2c }, { 0x0101, 0x59fc, 0x25e0, 0xff1e },
+    { 0x00ae, 0x5896, 0x27a9, 0xff10 }, { 0x0063, 0x5720, 0x297a, 0xff02 },
+    { 0x001f, 0x559d, 0x2b50, 0xfef4 }, { 0xffe2, 0x540d, 0x2d2c, 0xfee8 },
+    { 0xffac, 0x5270, 0x2f0d, 0xfedb }, { 0xff7c, 0x50c7, 0x30f3, 0xfed0 },
+    { 0xff53, 0x4f14, 0x32dc, 0xfec6 }, { 0xff2e, 0x4d57, 0x34c8, 0xfebd },
+    { 0xff0f, 0x4b91, 0x36b6, 0xfeb6 }, { 0xfef5, 0x49c2, 0x38a5, 0xfeb0 },
+    { 0xfedf, 0x47ed, 0x3a95, 0xfeac }, { 0xfece, 0x4611, 0x3c85, 0xfeab },
+    { 0xfec0, 0x4430, 0x3e74, 0xfeac }, { 0xfeb6, 0x424a, 0x4060, 0xfeaf },
+    { 0xfeaf, 0x4060, 0x424a, 0xfeb6 }, { 0xfeac, 0x3e74, 0x4430, 0xfec0 },
+    { 0xfeab, 0x3c85, 0x4611, 0xfece }, { 0xfeac, 0x3a95, 0x47ed, 0xfedf },
+    { 0xfeb0, 0x38a5, 0x49c2, 0xfef5 }, { 0xfeb6, 0x36b6, 0x4b91, 0xff0f },
+    { 0xfebd, 0x34c8, 0x4d57, 0xff2e }, { 0xfec6, 0x32dc, 0x4f14, 0xff53 },
+    { 0xfed0, 0x30f3, 0x50c7, 0xff7c }, { 0xfedb, 0x2f0d, 0x5270, 0xffac },
+    { 0xfee8, 0x2d2c, 0x540d, 0xffe2 }, { 0xfef4, 0x2b50, 0x559d, 0x001f },
+    { 0xff02, 0x297a, 0x5720, 0x0063 }, { 0xff10, 0x27a9, 0x5896, 0x00ae },
+    { 0xff1e, 0x25e0, 0x59fc, 0x0101 }, { 0xff2c, 0x241e, 0x5b53, 0x015b },
+    { 0xff3a, 0x2264, 0x5c9a, 0x01be }, { 0xff48, 0x20b3, 0x5dd0, 0x022a },
+    { 0xff56, 0x1f0b, 0x5ef5, 0x029f }, { 0xff64, 0x1d6c, 0x6007, 0x031c },
+    { 0xff71, 0x1bd7, 0x6106, 0x03a4 }, { 0xff7e, 0x1a4c, 0x61f3, 0x0435 },
+    { 0xff8a, 0x18cb, 0x62cb, 0x04d1 }, { 0xff96, 0x1756, 0x638f, 0x0577 },
+    { 0xffa1, 0x15eb, 0x643f, 0x0628 }, { 0xffac, 0x148c, 0x64d9, 0x06e4 },
+    { 0xffb6, 0x1338, 0x655e, 0x07ab }, { 0xffbf, 0x11f0, 0x65cd, 0x087d },
+    { 0xffc8, 0x10b4, 0x6626, 0x095a }, { 0xffd0, 0x0f83, 0x6669, 0x0a44 },
+    { 0xffd8, 0x0e5f, 0x6696, 0x0b39 }, { 0xffdf, 0x0d46, 0x66ad, 0x0c39 },
+};
+
+ReferenceMixer sRef;
+std::mt19937 sRng(0x4C5553);
+
+int16_t Clamp16(int32_t v) {
+    return (int16_t)std::clamp<int32_t>(v, INT16_MIN, INT16_MAX);
+}
+
+void RefEnvMixer(uint16_t inAddr, uint16_t nSamples, bool swapReverb, bool neg3, bool neg2, bool negLeft,
+                 bool negRight, uint32_t wetDryAddr) {
+    int16_t* in = sRef.BufS16(inAddr);
+    int16_t* dry[2] = { sRef.BufS16(((wetDryAddr >> 24) & 0xFF) << 4), sRef.BufS16(((wetDryAddr >> 16) & 0xFF) << 4) };
+    int16_t* wet[2] = { sRef.BufS16(((wetDryAddr >> 8) & 0xFF) << 4), sRef.BufS16((wetDryAddr & 0xFF) << 4) };
+    int16_t negs[4] = { (int16_t)(negLeft ? -1 : 0), (int16_t)(negRight ? -1 : 0), (int16_t)(neg3 ? -4 : 0),
+                        (int16_t)(neg2 ? -2 : 0) };
+    int swapped[2] = { swapReverb ? 1 : 0, swapReverb ? 0 : 1 };
+    int n = ROUND_UP_16(nSamples);
+
+    uint16_t vols[2] = { sRef.vol[0], sRef.vol[1] };
+    uint16_t volWet = sRef.volWet;
+
+    do {
+        for (int i = 0; i < 8; i++) {
+            int16_t samples[2] = { *in, *in };
+            in++;
+            for (int j = 0; j < 2; j++) {
+                samples[j] = (samples[j] * vols[j] >> 16) ^ negs[j];
+            }
+            for (int j = 0; j < 2; j++) {
+                *dry[j] = Clamp16(*dry[j] + samples[j]);
+                dry[j]++;
+                *wet[j] = Clamp16(*wet[j] + ((samples[swapped[j]] * volWet >> 16) ^ negs[2 + j]));
+                wet[j]++;
+            }
+        }
+        vols[0] += sRef.rate[0];
+        vols[1] += sRef.rate[1];
+        volWet += sRef.rateWet;
+        n -= 8;
+    } while (n > 0);
+}
+
+void RefMix(int16_t count, int16_t gain, uint16_t inAddr, uint16_t outAddr) {
+    int nbytes = ROUND_UP_32(ROUND_DOWN_16(count << 4));
+    int16_t* in = sRef.BufS16(inAddr);
+    int16_t* out = sRef.BufS16(outAddr);
+
+    if (gain == -0x8000) {
+        while (nbytes > 0) {
+            for (int i = 0; i < 16; i++) {
+                int32_t sample = *out - *in++;
+                *out++ = Clamp16(sample);
+            }
+            nbytes -= 16 * sizeof(int16_t);
+        }
+    }
+
+    while (nbytes > 0) {
+        for (int i = 0; i < 16; i++) {
+            int32_t sample = ((*out * 0x7fff + *in++ * gain) + 0x4000) >> 15;
+            *out++ = Clamp16(sample);
+        }
+        nbytes -= 16 * sizeof(int16_t);
+    }
+}
+
+void RefADPCMDec(uint8_t flags, int16_t* state) {
+    uint8_t* in = sRef.dmem + sRef.in;
+    int16_t* out = sRef.BufS16(sRef.out);
+    int nbytes = ROUND_UP_32(sRef.nbytes);
+    if (flags & A_INIT) {
+        memset(out, 0, 16 * sizeof(int16_t));
+    } else {
+        memcpy(out, state, 16 * sizeof(int16_t));
+    }
+    out += 16;
+
+    while (nbytes > 0) {
+        int shift = *in >> 4;
+        int tableIndex = *in++ & 0xf;
+        int16_t(*tbl)[8] = sRef.adpcmTable[tableIndex];
+
+        for (int i = 0; i < 2; i++) {
+            int16_t ins[8];
+            int16_t prev1 = out[-1];
+            int16_t prev2 = out[-2];
+            // The reference shifts signed ints into the sign bit, done on unsigned here to keep it defined
+            if (flags & 4) {
+                for (int j = 0; j < 2; j++) {
+                    ins[j * 4] = (int16_t)(((int32_t)((uint32_t)(*in >> 6) << 30) >> 30) << shift);
+                    ins[j * 4 + 1] = (int16_t)(((int32_t)((uint32_t)((*in >> 4) & 0x3) << 30) >> 30) << shift);
+                    ins[j * 4 + 2] = (int16_t)(((int32_t)((uint32_t)((*in >> 2) & 0x3) << 30) >> 30) << shift);
+                    ins[j * 4 + 3] = (int16_t)(((int32_t)((uint32_t)(*in++ & 0x3) << 30) >> 30) << shift);
+                }
+            } else {
+                for (int j = 0; j < 4; j++) {
+                    ins[j * 2] = (int16_t)(((int32_t)((uint32_t)(*in >> 4) << 28) >> 28) << shift);
+                    ins[j * 2 + 1] = (int16_t)(((int32_t)((uint32_t)(*in++ & 0xf) << 28) >> 28) << shift);
+                }
+            }
+            for (int j = 0; j < 8; j++) {
+                int32_t acc = tbl[0][j] * prev2 + tbl[1][j] * prev1 + (ins[j] << 11);
+                for (int k = 0; k < j; k++) {
+                    acc += tbl[1][((j - k) - 1)] * ins[k];
+                }
+                acc >>= 11;
+                *out++ = Clamp16(acc);
+            }
+        }
+        nbytes -= 16 * sizeof(int16_t);
+    }
+    memcpy(state, out - 16, 16 * sizeof(int16_t));
+}
+
+void RefS8Dec(uint8_t flags, int16_t* state) {
+    uint8_t* in = sRef.dmem + sRef.in;
+    int16_t* out = sRef.BufS16(sRef.out);
+    int nbytes = ROUND_UP_32(sRef.nbytes);
+    if (flags & A_INIT) {
+        memset(out, 0, 16 * sizeof(int16_t));
+    } else if (flags & A_LOOP) {
+        memcpy(out, sRef.adpcmLoopState, 16 * sizeof(int16_t));
+    } else {
+        memcpy(out, state, 16 * sizeof(int16_t));
+    }
+    out += 16;
+
+    while (nbytes > 0) {
+        for (int i = 0; i < 16; i++) {
+            *out++ = (int16_t)(*in++ << 8);
+        }
+        nbytes -= 16 * sizeof(int16_t);
+    }
+
+    memcpy(state, out - 16, 16 * sizeof(int16_t));
+}
+
+void RefResample(uint8_t flags, uint16_t pitch, int16_t* state) {
+    int16_t tmp[16];
+    int16_t* inInitial = sRef.BufS16(sRef.in);
+    int16_t* in = inInitial;
+    int16_t* out = sRef.BufS16(sRef.out);
+    int nbytes = ROUND_UP_16(sRef.nbytes);
+    uint32_t pitchAccumulator;
+    int i;
+
+    // The reference only clears the first 5 entries, the look-behind words it leaves undefined are zeroed here
+    if (flags & A_INIT) {
+        memset(tmp, 0, sizeof(tmp));
+    } else {
+        memcpy(tmp, state, 16 * sizeof(int16_t));
+    }
+    if (flags & 2) {
+        memcpy(in - 8, tmp + 8, 8 * sizeof(int16_t));
+        // tmp[5] / sizeof(int16_t) in the reference, the unsigned division wraps to this for negative offsets
+        in -= tmp[5] >> 1;
+    }
+    in -= 4;
+    pitchAccumulator = (uint16_t)tmp[4];
+    memcpy(in, tmp, 4 * sizeof(int16_t));
+
+    do {
+        for (i = 0; i < 8; i++) {
+            const int16_t* tbl = (const int16_t*)sRefResampleTable[pitchAccumulator * 64 >> 16];
+            int32_t sample = ((in[0] * tbl[0] + 0x4000) >> 15) + ((in[1] * tbl[1] + 0x4000) >> 15) +
+                             ((in[2] * tbl[2] + 0x4000) >> 15) + ((in[3] * tbl[3] + 0x4000) >> 15);
+            *out++ = Clamp16(sample);
+
+            pitchAccumulator += (pitch << 1);
+            in += pitchAccumulator >> 16;
+            pitchAccumulator %= 0x10000;
+        }
+        nbytes -= 8 * sizeof(int16_t);
+    } while (nbytes > 0);
+
+    state[4] = (int16_t)pitchAccumulator;
+    memcpy(state, in, 4 * sizeof(int16_t));
+    i = (in - inInitial + 4) & 7;
+    in -= i;
+    if (i != 0) {
+        i = -8 - i;
+    }
+    state[5] = i;
+    memcpy(state + 8, in, 8 * sizeof(int16_t));
+}
+
+void RefFilter(uint8_t flags, uint16_t countOrBuf, int16_t* stateOrFilter) {
+    if (flags > A_INIT) {
+        sRef.filterCount = ROUND_UP_16(countOrBuf);
+        memcpy(sRef.filter, stateOrFilter, sizeof(sRef.filter));
+    } else {
+        int16_t tmp[16], tmp2[8];
+        int count = sRef.filterCount;
+        int16_t* buf = sRef.BufS16(countOrBuf);
+
+        if (flags == A_INIT) {
+            memset(tmp, 0, 8 * sizeof(int16_t));
+            memset(tmp2, 0, 8 * sizeof(int16_t));
+        } else {
+            memcpy(tmp, stateOrFilter, 8 * sizeof(int16_t));
+            memcpy(tmp2, stateOrFilter + 8, 8 * sizeof(int16_t));
+        }
+
+        for (int i = 0; i < 8; i++) {
+            sRef.filter[i] = (tmp2[i] + sRef.filter[i]) / 2;
+        }
+
+        do {
+            memcpy(tmp + 8, buf, 8 * sizeof(int16_t));
+            for (int i = 0; i < 8; i++) {
+                int64_t sample = 0x4000;
+                for (int j = 0; j < 8; j++) {
+                    sample += tmp[i + j] * sRef.filter[7 - j];
+                }
+                buf[i] = Clamp16((int32_t)(sample >> 15));
+            }
+            memcpy(tmp, tmp + 8, 8 * sizeof(int16_t));
+
+            buf += 8;
+            count -= 8 * sizeof(int16_t);
+        } while (count > 0);
+
+        memcpy(stateOrFilter, tmp, 8 * sizeof(int16_t));
+        memcpy(stateOrFilter + 8, sRef.filter, 8 * sizeof(int16_t));
+    }
+}
+
+void RefInterleave(uint16_t dest, uint16_t left, uint16_t right, uint16_t c) {
+    int count = ROUND_UP_8(c) / sizeof(int16_t) / 4;
+    int16_t* l = sRef.BufS16(left);
+    int16_t* r = sRef.BufS16(right);
+    int16_t* d = sRef.BufS16(dest);
+    while (count > 0) {
+        int16_t l0 = *l++;
+        int16_t l1 = *l++;
+        int16_t l2 = *l++;
+        int16_t l3 = *l++;
+        int16_t r0 = *r++;
+        int16_t r1 = *r++;
+        int16_t r2 = *r++;
+        int16_t r3 = *r++;
+        *d++ = l0;
+        *d++ = r0;
+        *d++ = l1;
+        *d++ = r1;
+        *d++ = l2;
+        *d++ = r2;
+        *d++ = l3;
+        *d++ = r3;
+        --count;
+    }
+}
+
+void RefHiLoGain(uint8_t g, uint16_t count, uint16_t addr) {
+    int16_t* samples = sRef.BufS16(addr);
+    int nbytes = ROUND_UP_32(count);
+
+    do {
+        for (int i = 0; i < 8; i++) {
+            *samples = Clamp16((*samples * g) >> 4);
+            samples++;
+        }
+        nbytes -= 16;
+    } while (nbytes > 0);
+}
+
+void RefDuplicate(uint16_t count, uint16_t inAddr, uint16_t outAddr) {
+    uint8_t* in = sRef.dmem + inAddr;
+    uint8_t* out = sRef.dmem + outAddr;
+    uint8_t tmp[128];
+    memcpy(tmp, in, 128);
+    do {
+        memcpy(out, tmp, 128);
+        out += 128;
+    } while (count-- > 0);
+}
+
+void Randomize(void* data, size_t size) {
+    uint8_t* bytes = (uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        bytes[i] = (uint8_t)sRng();
+    }
+}
+
+// Gives both mixers the same random DMEM
+void FillDmem(Ship::AudioMixer& mixer) {
+    Randomize(sRef.dmem, sizeof(sRef.dmem));
+    memcpy(mixer.GetDmem(0), sRef.dmem, sizeof(sRef.dmem));
+}
+
+bool CompareDmem(Ship::AudioMixer& mixer, const char* name, int iteration) {
+    const int16_t* native = mixer.GetDmem(0);
+    const int16_t* reference = sRef.BufS16(0);
+    for (size_t i = 0; i < AUDIO_MIXER_DMEM_SIZE / sizeof(int16_t); i++) {
+        if (native[i] != reference[i]) {
+            printf("%s #%d: DMEM 0x%03zX is %d, the reference mixer gives %d\n", name, iteration, i * sizeof(int16_t),
+                   native[i], reference[i]);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TestEnvMixer(Ship::AudioMixer& mixer) {
+    for (int flags = 0; flags < 32; flags++) {
+        for (int iteration = 0; iteration < 8; iteration++) {
+            FillDmem(mixer);
+
+            const uint8_t initialVolWet = (uint8_t)sRng();
+            const uint16_t rateWet = (uint16_t)sRng();
+            const uint16_t rateLeft = (uint16_t)sRng();
+            const uint16_t rateRight = (uint16_t)sRng();
+            const uint16_t volLeft = (uint16_t)sRng();
+            const uint16_t volRight = (uint16_t)sRng();
+            const uint8_t count = (uint8_t)(sRng() % 0xC0 + 1);
+            const uint32_t wetDry = (0x40 << 24) | (0x58 << 16) | (0x70 << 8) | 0x88;
+
+            Acmd cmds[3];
+            aEnvSetup1(&cmds[0], initialVolWet, rateWet, rateLeft, rateRight);
+            aEnvSetup2(&cmds[1], volLeft, volRight);
+            aEnvMixer(&cmds[2], 0x100, count, (flags >> 4) & 1, (flags >> 3) & 1, (flags >> 2) & 1, (flags >> 1) & 1,
+                      flags & 1, wetDry, _SHIFTL(A_ENVMIXER, 24, 8));
+            mixer.Execute(cmds, 3);
+
+            sRef.volWet = (uint16_t)(initialVolWet << 8);
+            sRef.rateWet = rateWet;
+            sRef.rate[0] = rateLeft;
+            sRef.rate[1] = rateRight;
+            sRef.vol[0] = volLeft;
+            sRef.vol[1] = volRight;
+            RefEnvMixer(0x100, count, (flags >> 4) & 1, (flags >> 3) & 1, (flags >> 2) & 1, (flags >> 1) & 1,
+                        flags & 1, wetDry);
+
+            if (!CompareDmem(mixer, "A_ENVMIXER", flags * 8 + iteration)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool TestMix(Ship::AudioMixer& mixer) {
+    for (int iteration = 0; iteration < 64; iteration++) {
+        FillDmem(mixer);
+
+        int16_t gain = (int16_t)sRng();
+        if (iteration == 0) {
+            gain = -0x8000;
+        } else if (iteration == 1) {
+            gain = 0x7FFF;
+        }
+        const uint8_t count = (uint8_t)(sRng() % 0x40 + 1);
+
+        Acmd cmd;
+        aMix(&cmd, count, gain, 0x200, 0x800);
+        mixer.Execute(&cmd, 1);
+        RefMix(count, gain, 0x200, 0x800);
+
+        if (!CompareDmem(mixer, "A_MIXER", iteration)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TestADPCMDecode(Ship::AudioMixer& mixer) {
+    int16_t book[8][2][8];
+    int16_t state[16];
+    int16_t refState[16];
+    mixer.SetSegment(STATE_SEGMENT, state);
+    mixer.SetSegment(BOOK_SEGMENT, book);
+
+    for (int iteration = 0; iteration < 64; iteration++) {
+        FillDmem(mixer);
+        Randomize(book, sizeof(book));
+        Randomize(state, sizeof(state));
+        memcpy(sRef.adpcmTable, book, sizeof(book));
+        memcpy(refState, state, sizeof(state));
+
+        // Frame headers pick one of the 8 predictors and a shift the encoder can produce
+        const bool twoBit = (iteration & 1) != 0;
+        const int frameSize = twoBit ? 5 : 9;
+        const int frames = sRng() % 16 + 1;
+        const uint16_t in = 0x100;
+        for (int frame = 0; frame < frames; frame++) {
+            sRef.dmem[in + frame * frameSize] = (uint8_t)((sRng() % 13) << 4 | (sRng() % 8));
+        }
+        memcpy(mixer.GetDmem(0), sRef.dmem, sizeof(sRef.dmem));
+
+        const uint8_t flags = (uint8_t)((iteration & 2 ? A_INIT : 0) | (twoBit ? 4 : 0));
+        Acmd cmds[3];
+        aLoadADPCM(&cmds[0], sizeof(book), BOOK_ADDR);
+        aSetBuffer(&cmds[1], 0, in, 0x400, frames * 32);
+        aADPCMdec(&cmds[2], flags, STATE_ADDR(0));
+        mixer.Execute(cmds, 3);
+
+        sRef.in = in;
+        sRef.out = 0x400;
+        sRef.nbytes = (uint16_t)(frames * 32);
+        RefADPCMDec(flags, refState);
+
+        if (!CompareDmem(mixer, "A_ADPCM", iteration)) {
+            return false;
+        }
+        if (memcmp(state, refState, sizeof(state)) != 0) {
+            printf("A_ADPCM #%d: the saved state differs from the reference mixer\n", iteration);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TestS8Decode(Ship::AudioMixer& mixer) {
+    int16_t state[16];
+    int16_t refState[16];
+    int16_t loopState[16];
+    mixer.SetSegment(STATE_SEGMENT, state);
+    mixer.SetSegment(LOOP_SEGMENT, loopState);
+    sRef.adpcmLoopState = loopState;
+
+    for (int iteration = 0; iteration < 48; iteration++) {
+        FillDmem(mixer);
+        Randomize(state, sizeof(state));
+        Randomize(loopState, sizeof(loopState));
+        memcpy(refState, state, sizeof(state));
+
+        const uint8_t flags = (uint8_t)(iteration % 3 == 0 ? A_INIT : (iteration % 3 == 1 ? A_LOOP : 0));
+        const uint16_t nbytes = (uint16_t)(sRng() % 0x200 + 1);
+        Acmd cmds[3];
+        aSetLoop(&cmds[0], LOOP_ADDR);
+        aSetBuffer(&cmds[1], 0, 0x100, 0x400, nbytes);
+        aS8Dec(&cmds[2], flags, STATE_ADDR(0));
+        mixer.Execute(cmds, 3);
+
+        sRef.in = 0x100;
+        sRef.out = 0x400;
+        sRef.nbytes = nbytes;
+        RefS8Dec(flags, refState);
+
+        if (!CompareDmem(mixer, "A_S8DEC", iteration)) {
+            return false;
+        }
+        if (memcmp(state, refState, sizeof(state)) != 0) {
+            printf("A_S8DEC #%d: the saved state differs from the reference mixer\n", iteration);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TestResample(Ship::AudioMixer& mixer) {
+    int16_t state[16];
+    int16_t refState[16];
+    mixer.SetSegment(STATE_SEGMENT, state);
+
+    // Each sequence starts from A_INIT and carries the saved state on, the later calls take the look-behind path with
+    // the offset and samples the previous call left
+    for (int sequence = 0; sequence < 32; sequence++) {
+        const uint16_t pitch = sequence == 0 ? 0x8000 : (uint16_t)sRng();
+        for (int call = 0; call < 6; call++) {
+            FillDmem(mixer);
+            uint8_t flags = call == 0 ? A_INIT : 0;
+            if (call > 0 && (sequence & 1) == 0) {
+                flags |= 2;
+            }
+            if (call == 0) {
+                memset(state, 0, sizeof(state));
+                memcpy(refState, state, sizeof(state));
+            }
+
+            const uint16_t nbytes = (uint16_t)(sRng() % 0x180 + 1);
+            Acmd cmds[2];
+            aSetBuffer(&cmds[0], 0, 0x200, 0x800, nbytes);
+            aResample(&cmds[1], flags, pitch, STATE_ADDR(0));
+            mixer.Execute(cmds, 2);
+
+            sRef.in = 0x200;
+            sRef.out = 0x800;
+            sRef.nbytes = nbytes;
+            RefResample(flags, pitch, refState);
+
+            const int iteration = sequence * 6 + call;
+            if (!CompareDmem(mixer, "A_RESAMPLE", iteration)) {
+                return false;
+            }
+            if (memcmp(state, refState, sizeof(state)) != 0) {
+                printf("A_RESAMPLE #%d: the saved state differs from the reference mixer\n", iteration);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool TestFilter(Ship::AudioMixer& mixer) {
+    int16_t taps[8];
+    int16_t state[16];
+    int16_t refState[16];
+
+    for (int iteration = 0; iteration < 64; iteration++) {
+        FillDmem(mixer);
+        Randomize(taps, sizeof(taps));
+        Randomize(state, sizeof(state));
+        memcpy(refState, state, sizeof(state));
+
+        // Setup latches the count and taps, the second command filters with them and the saved state
+        const uint16_t count = (uint16_t)(sRng() % 0x200 + 1);
+        const uint8_t flags = (iteration & 1) ? A_INIT : 0;
+        mixer.SetSegment(STATE_SEGMENT, taps);
+        Acmd setup;
+        aFilter(&setup, 2, count, STATE_ADDR(0));
+        mixer.Execute(&setup, 1);
+        mixer.SetSegment(STATE_SEGMENT, state);
+        Acmd filter;
+        aFilter(&filter, flags, 0x300, STATE_ADDR(0));
+        mixer.Execute(&filter, 1);
+
+        RefFilter(2, count, taps);
+        RefFilter(flags, 0x300, refState);
+
+        if (!CompareDmem(mixer, "A_FILTER", iteration)) {
+            return false;
+        }
+        if (memcmp(state, refState, sizeof(state)) != 0) {
+            printf("A_FILTER #%d: the saved state differs from the reference mixer\n", iteration);
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TestInterleave(Ship::AudioMixer& mixer) {
+    for (int iteration = 0; iteration < 64; iteration++) {
+        FillDmem(mixer);
+
+        // The byte count is stored divided by 16. The last iterations write over the left input like the games do.
+        const uint16_t nbytes = (uint16_t)((sRng() % 0x30 + 1) << 4);
+        const uint16_t dest = iteration < 48 ? 0x800 : 0x200;
+        Acmd cmd;
+        aInterleave(&cmd, dest, 0x200, 0x500, nbytes);
+        mixer.Execute(&cmd, 1);
+        RefInterleave(dest, 0x200, 0x500, nbytes);
+
+        if (!CompareDmem(mixer, "A_INTERLEAVE", iteration)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TestHiLoGain(Ship::AudioMixer& mixer) {
+    for (int iteration = 0; iteration < 64; iteration++) {
+        FillDmem(mixer);
+
+        const uint8_t gain = iteration == 0 ? 0xFF : (uint8_t)sRng();
+        const uint16_t nbytes = (uint16_t)(sRng() % 0x400 + 1);
+        Acmd cmd;
+        aHiLoGain(&cmd, gain, nbytes, 0x400, 0);
+        mixer.Execute(&cmd, 1);
+        RefHiLoGain(gain, nbytes, 0x400);
+
+        if (!CompareDmem(mixer, "A_HILOGAIN", iteration)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TestDuplicate(Ship::AudioMixer& mixer) {
+    for (int iteration = 0; iteration < 32; iteration++) {
+        FillDmem(mixer);
+
+        const uint8_t count = (uint8_t)(sRng() % 16);
+        Acmd cmd;
+        aDuplicate(&cmd, count, 0x100, 0x200, 0);
+        mixer.Execute(&cmd, 1);
+        RefDuplicate(count, 0x100, 0x200);
+
+        if (!CompareDmem(mixer, "A_DUPLICATE", iteration)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+} // namespace
+
+int main() {
+    Ship::AudioMixer mixer;
+    bool passed = TestEnvMixer(mixer);
+    passed = TestMix(mixer) && passed;
+    passed = TestADPCMDecode(mixer) && passed;
+    passed = TestS8Decode(mixer) && passed;
+    passed = TestResample(mixer) && passed;
+    passed = TestFilter(mixer) && passed;
+    passed = TestInterleave(mixer) && passed;
+    passed = TestHiLoGain(mixer) && passed;
+    passed = TestDuplicate(mixer) && passed;
+
+    printf("%s\n", passed ? "AudioMixer matches the reference mixer" : "AudioMixer differs from the reference mixer");
+    return passed ? 0 : 1;
+}
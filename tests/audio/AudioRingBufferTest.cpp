@@ -0,0 +1,132 @@
+// Tests Ship::AudioRingBuffer's accounting: a full buffer takes only what fits, an empty one gives only what is there,
+// and one producer and one consumer thread pass a byte stream through it without losing, repeating or reordering bytes.
+#include "audio/AudioRingBuffer.h"
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#define STREAM_SIZE (4 * 1024 * 1024)
+
+namespace {
+bool Check(bool condition, const char* what) {
+    if (!condition) {
+        printf("AudioRingBuffer: %s\n", what);
+    }
+    return condition;
+}
+
+bool TestCapacity() {
+    Ship::AudioRingBuffer exact(4096);
+    Ship::AudioRingBuffer rounded(3000);
+    return Check(exact.Capacity() == 4096, "a power of two capacity was changed") &&
+           Check(rounded.Capacity() == 4096, "the capacity wasn't rounded up to a power of two");
+}
+
+bool TestOverrun() {
+    Ship::AudioRingBuffer ring(256);
+    std::vector<uint8_t> data(300, 0xAB);
+    bool passed = Check(ring.Write(data.data(), 200) == 200, "a write that fits was cut short");
+    passed = Check(ring.Write(data.data(), 100) == 56, "a write past the capacity didn't stop at the free space") &&
+             passed;
+    passed = Check(ring.Write(data.data(), 1) == 0, "a full buffer accepted a write") && passed;
+    passed = Check(ring.Size() == 256, "a full buffer doesn't report its capacity as size") && passed;
+    return passed;
+}
+
+bool TestUnderrun() {
+    Ship::AudioRingBuffer ring(256);
+    std::vector<uint8_t> data(100);
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = (uint8_t)i;
+    }
+    ring.Write(data.data(), data.size());
+
+    std::vector<uint8_t> out(200, 0xFF);
+    bool passed = Check(ring.Read(out.data(), 200) == 100, "a read past the queued bytes didn't stop at them");
+    for (size_t i = 0; i < data.size(); i++) {
+        passed = Check(out[i] == data[i], "an underrunning read returned the wrong bytes") && passed;
+    }
+    passed = Check(out[100] == 0xFF, "an underrunning read wrote past what it returned") && passed;
+    passed = Check(ring.Read(out.data(), 1) == 0, "an empty buffer returned bytes") && passed;
+    passed = Check(ring.Size() == 0, "an empty buffer reports a size") && passed;
+    return passed;
+}
+
+bool TestWrapAround() {
+    Ship::AudioRingBuffer ring(256);
+    std::vector<uint8_t> in(96), out(96);
+    uint8_t next = 0;
+    uint8_t expected = 0;
+    // 96 doesn't divide 256, so writes and reads straddle the end of the storage in every position
+    for (int round = 0; round < 64; round++) {
+        for (auto& byte : in) {
+            byte = next++;
+        }
+        if (!Check(ring.Write(in.data(), in.size()) == in.size(), "a write that fits was cut short") ||
+            !Check(ring.Read(out.data(), out.size()) == out.size(), "a read of queued bytes was cut short")) {
+            return false;
+        }
+        for (auto byte : out) {
+            if (!Check(byte == expected++, "bytes changed order across the end of the storage")) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool TestThreads() {
+    Ship::AudioRingBuffer ring(4096);
+
+    // Odd chunk sizes on both sides so the positions go through every alignment
+    std::thread producer([&ring] {
+        uint8_t chunk[333];
+        size_t sent = 0;
+        while (sent < STREAM_SIZE) {
+            const size_t len = std::min<size_t>(sizeof(chunk), STREAM_SIZE - sent);
+            for (size_t i = 0; i < len; i++) {
+                chunk[i] = (uint8_t)((sent + i) * 7);
+            }
+            size_t written = 0;
+            while (written < len) {
+                const size_t count = ring.Write(chunk + written, len - written);
+                if (count == 0) {
+                    std::this_thread::yield();
+                }
+                written += count;
+            }
+            sent += len;
+        }
+    });
+
+    bool passed = true;
+    uint8_t chunk[517];
+    size_t received = 0;
+    while (received < STREAM_SIZE) {
+        const size_t len = ring.Read(chunk, sizeof(chunk));
+        if (len == 0) {
+            std::this_thread::yield();
+        }
+        for (size_t i = 0; i < len && passed; i++) {
+            passed = Check(chunk[i] == (uint8_t)((received + i) * 7), "the consumer saw a byte out of order");
+        }
+        received += len;
+    }
+    producer.join();
+
+    return Check(received == STREAM_SIZE, "the consumer got more bytes than were sent") && passed;
+}
+} // namespace
+
+int main() {
+    bool passed = TestCapacity();
+    passed = TestOverrun() && passed;
+    passed = TestUnderrun() && passed;
+    passed = TestWrapAround() && passed;
+    passed = TestThreads() && passed;
+
+    printf("%s\n", passed ? "AudioRingBuffer passed" : "AudioRingBuffer failed");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,185 @@
+// Round trip of InputRecorder and the decoder ReplayController plays recordings with. Random pad sequences are
+// recorded to a file, decoded again and expanded frame by frame the way ReplayController advances, every frame has to
+// come back bit for bit. ReplayController itself needs the SDL controller base class, so it isn't built here.
+#include "controller/InputRecorder.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace {
+std::mt19937 sRng(0x4C5553);
+
+std::string TempPath() {
+    return (std::filesystem::temp_directory_path() / "lus_input_recording_test.bin").string();
+}
+
+std::vector<uint8_t> ReadFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<uint8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+// Mostly unchanged frames with occasional changes to single fields, like a player holding the stick
+void NextFrame(OSContPad* pads) {
+    for (int32_t i = 0; i < MAXCONTROLLERS; i++) {
+        if (sRng() % 4 != 0) {
+            continue;
+        }
+
+        OSContPad& pad = pads[i];
+        switch (sRng() % 8) {
+            case 0:
+                pad.button = (uint16_t)sRng();
+                break;
+            case 1:
+                pad.stick_x = (int8_t)sRng();
+                break;
+            case 2:
+                pad.stick_y = (int8_t)sRng();
+                break;
+            case 3:
+                pad.right_stick_x = (int8_t)sRng();
+                break;
+            case 4:
+                pad.right_stick_y = (int8_t)sRng();
+                break;
+            case 5: {
+                // Any bit pattern, including negative zero and NaNs, has to survive
+                const uint32_t bits = sRng();
+                memcpy(&pad.gyro_x, &bits, sizeof(float));
+                break;
+            }
+            case 6:
+                pad.gyro_y = (float)(sRng() % 2000) / 100.0f - 10.0f;
+                break;
+            case 7:
+                pad.err_no = (uint8_t)(sRng() % 2 ? CONT_NO_RESPONSE_ERROR : 0);
+                break;
+        }
+    }
+}
+
+bool SamePad(const OSContPad& a, const OSContPad& b) {
+    return a.button == b.button && a.stick_x == b.stick_x && a.stick_y == b.stick_y &&
+           a.right_stick_x == b.right_stick_x && a.right_stick_y == b.right_stick_y && a.err_no == b.err_no &&
+           memcmp(&a.gyro_x, &b.gyro_x, sizeof(float)) == 0 && memcmp(&a.gyro_y, &b.gyro_y, sizeof(float)) == 0;
+}
+
+// Expands keyframes like ReplayController::AdvanceFrame and compares with the recorded frames
+bool ComparePlayback(const char* name, const std::vector<Ship::InputKeyframe>& keyframes,
+                     const std::vector<std::array<OSContPad, MAXCONTROLLERS>>& frames, uint64_t frameCount) {
+    std::array<OSContPad, MAXCONTROLLERS> current = {};
+    size_t next = 0;
+    for (uint64_t frame = 0; frame < frameCount; frame++) {
+        while (next < keyframes.size() && keyframes[next].Frame <= frame) {
+            current = keyframes[next++].Pads;
+        }
+        for (int32_t i = 0; i < MAXCONTROLLERS; i++) {
+            if (!SamePad(current[i], frames[frame][i])) {
+                printf("%s: slot %d differs at frame %llu\n", name, i, (unsigned long long)frame);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool TestRoundTrip() {
+    const std::string path = TempPath();
+    for (int iteration = 0; iteration < 16; iteration++) {
+        // Long gaps make the frame deltas take more than one varint byte
+        const int frameTotal = iteration == 0 ? 0 : (int)(sRng() % 5000 + 1);
+        const int idleEvery = iteration % 4 == 3 ? 1000 : 0;
+
+        Ship::InputRecorder recorder;
+        if (!recorder.Start(path)) {
+            printf("Could not start recording to %s\n", path.c_str());
+            return false;
+        }
+
+        std::vector<std::array<OSContPad, MAXCONTROLLERS>> frames;
+        std::array<OSContPad, MAXCONTROLLERS> pads = {};
+        for (int frame = 0; frame < frameTotal; frame++) {
+            if (idleEvery == 0 || frame % idleEvery == 0) {
+                NextFrame(pads.data());
+            }
+            recorder.RecordFrame(pads.data());
+            frames.push_back(pads);
+        }
+        recorder.Stop();
+
+        std::vector<Ship::InputKeyframe> keyframes;
+        uint64_t frameCount;
+        bool truncated;
+        if (!Ship::DecodeInputRecording(ReadFile(path), keyframes, frameCount, truncated) || truncated) {
+            printf("Round trip #%d: the recording doesn't decode\n", iteration);
+            return false;
+        }
+        if (frameCount != (uint64_t)frameTotal) {
+            printf("Round trip #%d: %llu frames decoded, %d recorded\n", iteration, (unsigned long long)frameCount,
+                   frameTotal);
+            return false;
+        }
+        if (!ComparePlayback("Round trip", keyframes, frames, frameCount)) {
+            return false;
+        }
+    }
+
+    std::filesystem::remove(path);
+    return true;
+}
+
+bool TestTruncated() {
+    const std::string path = TempPath();
+    Ship::InputRecorder recorder;
+    recorder.Start(path);
+    std::vector<std::array<OSContPad, MAXCONTROLLERS>> frames;
+    std::array<OSContPad, MAXCONTROLLERS> pads = {};
+    for (int frame = 0; frame < 600; frame++) {
+        NextFrame(pads.data());
+        recorder.RecordFrame(pads.data());
+        frames.push_back(pads);
+    }
+    recorder.Stop();
+    const std::vector<uint8_t> data = ReadFile(path);
+    std::filesystem::remove(path);
+
+    // Every cut decodes what came before it and nothing past the recording
+    for (size_t size = 6; size < data.size(); size += 7) {
+        const std::vector<uint8_t> cut(data.begin(), data.begin() + size);
+        std::vector<Ship::InputKeyframe> keyframes;
+        uint64_t frameCount;
+        bool truncated;
+        if (!Ship::DecodeInputRecording(cut, keyframes, frameCount, truncated) || !truncated) {
+            printf("Truncated to %zu bytes: not reported as truncated\n", size);
+            return false;
+        }
+        if (frameCount > frames.size() || !ComparePlayback("Truncated", keyframes, frames, frameCount)) {
+            return false;
+        }
+    }
+
+    std::vector<Ship::InputKeyframe> keyframes;
+    uint64_t frameCount;
+    bool truncated;
+    std::vector<uint8_t> badVersion = data;
+    badVersion[4]++;
+    if (Ship::DecodeInputRecording(badVersion, keyframes, frameCount, truncated)) {
+        printf("A recording with another version was accepted\n");
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+int main() {
+    bool passed = TestRoundTrip();
+    passed = TestTruncated() && passed;
+
+    printf("%s\n", passed ? "Input recordings round trip" : "Input recordings don't round trip");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,109 @@
+// Checks the stick response tables against the stick processing as it was before the tables, for every raw position
+// of the int8 range at several deadzone and notch settings. The reference below is a copy of that ProcessStick, the
+// tables have to reproduce it exactly.
+#include "controller/StickResponse.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#define M_TAU 6.2831853071795864769252867665590057 // 2 * pi
+#define MINIMUM_RADIUS_TO_MAP_NOTCH 0.9
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+double RefGetClosestNotch(double angle, double approximationThreshold) {
+    constexpr auto octagonAngle = M_TAU / 8;
+    const auto closestNotch = std::round(angle / octagonAngle) * octagonAngle;
+    const auto distanceToNotch = std::abs(fmod(closestNotch - angle + M_PI, M_TAU) - M_PI);
+    return distanceToNotch < approximationThreshold / 2 ? closestNotch : angle;
+}
+
+void RefProcessStick(int8_t& x, int8_t& y, float deadzoneX, float deadzoneY, int32_t notchProxmityThreshold) {
+    auto ux = fabs(x);
+    auto uy = fabs(y);
+
+    // create scaled circular dead-zone in range {-15 ... +15}
+    auto len = sqrt(ux * ux + uy * uy);
+    if (len < deadzoneX) {
+        len = 0;
+    } else if (len > MAX_AXIS_RANGE) {
+        len = MAX_AXIS_RANGE / len;
+    } else {
+        len = (len - deadzoneX) * MAX_AXIS_RANGE / (MAX_AXIS_RANGE - deadzoneX) / len;
+    }
+    ux *= len;
+    uy *= len;
+
+    // bound diagonals to an octagonal range {-68 ... +68}
+    if (ux != 0.0 && uy != 0.0) {
+        auto slope = uy / ux;
+        auto edgex = copysign(MAX_AXIS_RANGE / (fabs(slope) + 16.0 / 69.0), ux);
+        auto edgey = copysign(std::min(fabs(edgex * slope), MAX_AXIS_RANGE / (1.0 / fabs(slope) + 16.0 / 69.0)), y);
+        edgex = edgey / slope;
+
+        auto scale = sqrt(edgex * edgex + edgey * edgey) / MAX_AXIS_RANGE;
+        ux *= scale;
+        uy *= scale;
+    }
+
+    // map to virtual notches
+    const double notchProximityValRadians = notchProxmityThreshold * M_TAU / 360;
+
+    const double distance = std::sqrt((ux * ux) + (uy * uy)) / MAX_AXIS_RANGE;
+    if (distance >= MINIMUM_RADIUS_TO_MAP_NOTCH) {
+        auto angle = atan2(uy, ux) + M_TAU;
+        auto newAngle = RefGetClosestNotch(angle, notchProximityValRadians);
+
+        ux = cos(newAngle) * distance * MAX_AXIS_RANGE;
+        uy = sin(newAngle) * distance * MAX_AXIS_RANGE;
+    }
+
+    // assign back to original sign
+    x = copysign(ux, x);
+    y = copysign(uy, y);
+}
+
+bool TestSetting(float deadzone, int32_t notch) {
+    const auto table = Ship::GetStickResponseTable(deadzone, notch);
+    if (table != Ship::GetStickResponseTable(deadzone, notch)) {
+        printf("Deadzone %.1f, notch %d: the table isn't shared\n", deadzone, notch);
+        return false;
+    }
+
+    for (int32_t rawX = INT8_MIN; rawX <= INT8_MAX; rawX++) {
+        for (int32_t rawY = INT8_MIN; rawY <= INT8_MAX; rawY++) {
+            int8_t x = rawX;
+            int8_t y = rawY;
+            RefProcessStick(x, y, deadzone, deadzone, notch);
+
+            const int8_t* response = table->Response[(uint8_t)rawX << 8 | (uint8_t)rawY];
+            if (response[0] != x || response[1] != y) {
+                printf("Deadzone %.1f, notch %d: (%d, %d) gives (%d, %d), the reference gives (%d, %d)\n", deadzone,
+                       notch, rawX, rawY, response[0], response[1], x, y);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+} // namespace
+
+int main() {
+    // The default deadzone is 16 and the editor's notch slider goes from 0 to 45
+    const float deadzones[] = { 0.0f, 1.0f, 8.0f, 16.0f, 20.5f, 42.0f, 84.0f };
+    const int32_t notches[] = { 0, 1, 11, 23, 45 };
+
+    bool passed = true;
+    for (float deadzone : deadzones) {
+        for (int32_t notch : notches) {
+            passed = TestSetting(deadzone, notch) && passed;
+        }
+    }
+
+    printf("%s\n", passed ? "Stick responses match the reference" : "Stick responses differ from the reference");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+// Compares reading a CVar by name with reading it through a CVarHandle. The store is filled with as many variables as a
+// game with all of its enhancement menus registers, names are looked up the way the renderer and resource loader do it.
+#include "core/ConsoleVariable.h"
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#define VARIABLE_COUNT 2000
+#define READ_COUNT 10000000
+
+namespace {
+double NanosecondsPerRead(std::chrono::steady_clock::time_point start) {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / READ_COUNT;
+}
+} // namespace
+
+int main() {
+    Ship::ConsoleVariable cvars;
+    std::vector<std::string> names;
+    cvars.BeginBatch();
+    for (int i = 0; i < VARIABLE_COUNT; i++) {
+        names.push_back("gBenchVariable" + std::to_string(i));
+        cvars.SetInteger(names.back().c_str(), i);
+    }
+    cvars.EndBatch();
+
+    // A handful of hot variables, read in turn like a frame does
+    const char* hot[4] = { names[17].c_str(), names[512].c_str(), names[1024].c_str(), names[1999].c_str() };
+    Ship::CVarHandle<int32_t> handles[4];
+    for (int i = 0; i < 4; i++) {
+        handles[i] = cvars.GetIntegerHandle(hot[i], 0);
+    }
+
+    volatile int64_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < READ_COUNT; i++) {
+        sink = sink + cvars.GetInteger(hot[i & 3], 0);
+    }
+    const double byName = NanosecondsPerRead(start);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < READ_COUNT; i++) {
+        sink = sink + handles[i & 3].Get();
+    }
+    const double byHandle = NanosecondsPerRead(start);
+
+    printf("%d variables, %d reads\n", VARIABLE_COUNT, READ_COUNT);
+    printf("GetInteger by name: %.2f ns/read\n", byName);
+    printf("CVarHandle:         %.2f ns/read\n", byHandle);
+    return 0;
+}
@@ -0,0 +1,48 @@
+// Round trip latency of two threads passing a message back and forth through blocking message queues, the pattern of a
+// game thread handing work to the audio or graphics thread and waiting for the reply.
+#include "libultraship/libultra/message.h"
+#include "core/libultra/os.h"
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+#define ROUND_TRIPS 100000
+
+extern "C" {
+int32_t osSendMesg(OSMesgQueue* mq, OSMesg msg, int32_t flag);
+int32_t osRecvMesg(OSMesgQueue* mq, OSMesg* msg, int32_t flag);
+void osCreateMesgQueue(OSMesgQueue* mq, OSMesg* msgBuf, int32_t count);
+}
+
+int main() {
+    osSetMesgQueueBlocking(1);
+
+    OSMesg pingBuffer[1];
+    OSMesg pongBuffer[1];
+    OSMesgQueue ping;
+    OSMesgQueue pong;
+    osCreateMesgQueue(&ping, pingBuffer, 1);
+    osCreateMesgQueue(&pong, pongBuffer, 1);
+
+    std::thread responder([&] {
+        for (int i = 0; i < ROUND_TRIPS; i++) {
+            OSMesg msg;
+            osRecvMesg(&ping, &msg, OS_MESG_BLOCK);
+            osSendMesg(&pong, msg, OS_MESG_BLOCK);
+        }
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ROUND_TRIPS; i++) {
+        OSMesg msg;
+        msg.data32 = i;
+        osSendMesg(&ping, msg, OS_MESG_BLOCK);
+        osRecvMesg(&pong, &msg, OS_MESG_BLOCK);
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    responder.join();
+
+    const double ns = std::chrono::duration<double, std::nano>(elapsed).count() / ROUND_TRIPS;
+    printf("Blocking ping-pong: %.0f ns per round trip, %.0f round trips/s\n", ns, 1e9 / ns);
+    return 0;
+}
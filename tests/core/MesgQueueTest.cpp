@@ -0,0 +1,161 @@
+// Stress test of the libultra message queue with blocking on. Several producers send and jam into a small queue while
+// several consumers receive, every message has to arrive exactly once and each consumer has to see the messages of a
+// sending producer in the order they were sent. The queue semantics are checked on a single thread first.
+#include "libultraship/libultra/message.h"
+#include "core/libultra/os.h"
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#define QUEUE_SIZE 8
+#define SEND_PRODUCERS 3
+#define CONSUMERS 3
+#define MESSAGES_PER_PRODUCER 20000
+// Producer index that jams instead of sending, its messages overtake each other so only their count is checked
+#define JAM_PRODUCER SEND_PRODUCERS
+#define PRODUCERS (SEND_PRODUCERS + 1)
+#define STOP_MESSAGE 0xFFFFFFFF
+
+extern "C" {
+int32_t osSendMesg(OSMesgQueue* mq, OSMesg msg, int32_t flag);
+int32_t osJamMesg(OSMesgQueue* mq, OSMesg msg, int32_t flag);
+int32_t osRecvMesg(OSMesgQueue* mq, OSMesg* msg, int32_t flag);
+void osCreateMesgQueue(OSMesgQueue* mq, OSMesg* msgBuf, int32_t count);
+}
+
+namespace {
+OSMesg Message(uint32_t value) {
+    OSMesg msg;
+    msg.data32 = value;
+    return msg;
+}
+
+bool TestSingleThread() {
+    OSMesg buffer[3];
+    OSMesgQueue mq;
+    osCreateMesgQueue(&mq, buffer, 3);
+
+    OSMesg msg;
+    if (osRecvMesg(&mq, &msg, OS_MESG_NOBLOCK) != -1) {
+        printf("Receiving from an empty queue didn't fail\n");
+        return false;
+    }
+
+    // Jammed messages go in front of the queued ones
+    osSendMesg(&mq, Message(1), OS_MESG_NOBLOCK);
+    osSendMesg(&mq, Message(2), OS_MESG_NOBLOCK);
+    osJamMesg(&mq, Message(0), OS_MESG_NOBLOCK);
+    if (mq.validCount != 3 || osSendMesg(&mq, Message(3), OS_MESG_NOBLOCK) != -1 ||
+        osJamMesg(&mq, Message(3), OS_MESG_NOBLOCK) != -1) {
+        printf("A full queue accepted another message\n");
+        return false;
+    }
+
+    for (uint32_t expected = 0; expected < 3; expected++) {
+        if (osRecvMesg(&mq, &msg, OS_MESG_NOBLOCK) != 0 || msg.data32 != expected) {
+            printf("Received %u, expected %u\n", msg.data32, expected);
+            return false;
+        }
+    }
+
+    // With blocking off OS_MESG_BLOCK returns right away
+    osSetMesgQueueBlocking(0);
+    if (osRecvMesg(&mq, &msg, OS_MESG_BLOCK) != -1) {
+        printf("A blocking receive waited with blocking off\n");
+        return false;
+    }
+
+    return true;
+}
+
+bool TestStress() {
+    osSetMesgQueueBlocking(1);
+
+    OSMesg buffer[QUEUE_SIZE];
+    OSMesgQueue mq;
+    osCreateMesgQueue(&mq, buffer, QUEUE_SIZE);
+
+    std::vector<std::thread> producers;
+    for (uint32_t producer = 0; producer < PRODUCERS; producer++) {
+        producers.emplace_back([&mq, producer] {
+            for (uint32_t i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+                const OSMesg msg = Message(producer << 24 | i);
+                if (producer == JAM_PRODUCER) {
+                    osJamMesg(&mq, msg, OS_MESG_BLOCK);
+                } else {
+                    osSendMesg(&mq, msg, OS_MESG_BLOCK);
+                }
+            }
+        });
+    }
+
+    std::mutex resultMutex;
+    std::vector<std::vector<uint8_t>> received(PRODUCERS, std::vector<uint8_t>(MESSAGES_PER_PRODUCER, 0));
+    bool ordered = true;
+    std::vector<std::thread> consumers;
+    for (int consumer = 0; consumer < CONSUMERS; consumer++) {
+        consumers.emplace_back([&] {
+            std::vector<int64_t> last(PRODUCERS, -1);
+            std::vector<uint32_t> mine;
+            while (true) {
+                OSMesg msg;
+                osRecvMesg(&mq, &msg, OS_MESG_BLOCK);
+                if (msg.data32 == STOP_MESSAGE) {
+                    break;
+                }
+                mine.push_back(msg.data32);
+            }
+
+            const std::lock_guard<std::mutex> lock(resultMutex);
+            for (uint32_t value : mine) {
+                const uint32_t producer = value >> 24;
+                const uint32_t index = value & 0xFFFFFF;
+                received[producer][index]++;
+                if (producer != JAM_PRODUCER) {
+                    ordered &= (int64_t)index > last[producer];
+                    last[producer] = index;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    for (int consumer = 0; consumer < CONSUMERS; consumer++) {
+        osSendMesg(&mq, Message(STOP_MESSAGE), OS_MESG_BLOCK);
+    }
+    for (auto& thread : consumers) {
+        thread.join();
+    }
+
+    for (uint32_t producer = 0; producer < PRODUCERS; producer++) {
+        for (uint32_t i = 0; i < MESSAGES_PER_PRODUCER; i++) {
+            if (received[producer][i] != 1) {
+                printf("Message %u of producer %u arrived %d times\n", i, producer, received[producer][i]);
+                return false;
+            }
+        }
+    }
+    if (!ordered) {
+        printf("A consumer received the messages of a producer out of order\n");
+        return false;
+    }
+    if (mq.validCount != 0) {
+        printf("%d messages were left in the queue\n", mq.validCount);
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+int main() {
+    bool passed = TestSingleThread();
+    passed = TestStress() && passed;
+
+    printf("%s\n", passed ? "Message queues deliver every message once and in order"
+                          : "Message queues lost, duplicated or reordered messages");
+    return passed ? 0 : 1;
+}
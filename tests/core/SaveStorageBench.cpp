@@ -0,0 +1,53 @@
+// Measures how many saves per second reach the disk. Synchronous mode writes and syncs the file on every write, the
+// default mode coalesces a burst of writes into one file write. Sizes are those of SRAM and flash saves.
+#include "core/SaveStorage.h"
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#define SYNC_SAVE_COUNT 50
+#define BURST_WRITE_COUNT 10000
+#define BURST_CHUNK_SIZE 128
+
+namespace {
+double SecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+} // namespace
+
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "lus_save_storage_bench";
+    std::filesystem::create_directories(directory);
+    const size_t sizes[] = { 0x8000, 0x20000 };
+
+    for (size_t size : sizes) {
+        const std::filesystem::path path = directory / "save.bin";
+        std::vector<uint8_t> data(size, 0x5A);
+
+        Ship::SaveStorage storage;
+        storage.SetSynchronous(true);
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < SYNC_SAVE_COUNT; i++) {
+            data[i % size]++;
+            storage.Write(path, 0, data.data(), size);
+        }
+        const double syncSeconds = SecondsSince(start);
+        printf("%6zu KiB synchronous: %8.1f saves/s %8.2f ms/save\n", size / 1024, SYNC_SAVE_COUNT / syncSeconds,
+               syncSeconds * 1000.0 / SYNC_SAVE_COUNT);
+
+        // A game writing its save in small chunks, like SRAM DMA, then waiting for it to land
+        storage.SetSynchronous(false);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BURST_WRITE_COUNT; i++) {
+            storage.Write(path, (i * BURST_CHUNK_SIZE) % size, data.data(), BURST_CHUNK_SIZE);
+        }
+        const double writeSeconds = SecondsSince(start);
+        storage.Flush();
+        const double burstSeconds = SecondsSince(start);
+        printf("%6zu KiB coalesced:   %8.0f writes/s, burst on disk after %.2f ms\n", size / 1024,
+               BURST_WRITE_COUNT / writeSeconds, burstSeconds * 1000.0);
+    }
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
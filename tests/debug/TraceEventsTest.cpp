@@ -0,0 +1,128 @@
+// Records trace spans on a few threads, saves them and parses the file back as JSON. Checks what chrome://tracing and
+// Perfetto need: complete events with pid, tid, ts and dur, nested spans inside their parent, and details with quotes,
+// backslashes and control characters escaped.
+#include "debug/TraceEvents.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <thread>
+#include <vector>
+
+#define SPANS_PER_THREAD 100
+#define THREAD_COUNT 3
+
+namespace {
+const std::string sDetail = "quote \" backslash \\ tab \t newline \n bell \x07 utf-8 \xc3\xa9";
+
+void RecordFrames() {
+    for (int i = 0; i < SPANS_PER_THREAD; i++) {
+        LUS_TRACE_SPAN("frame", "gfx");
+        {
+            LUS_TRACE_SPAN_DETAIL("load", "resource", sDetail);
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool TestSave() {
+    const std::string path = (std::filesystem::temp_directory_path() / "lus_trace_events_test.json").string();
+
+    // Spans before the start aren't recorded, nor are those still open at the stop
+    RecordFrames();
+    Ship::TraceEventsStart();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        threads.emplace_back(RecordFrames);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    {
+        LUS_TRACE_SPAN("open", "gfx");
+        Ship::TraceEventsStop();
+    }
+    RecordFrames();
+
+    if (!Ship::TraceEventsSave(path)) {
+        printf("Could not save %s\n", path.c_str());
+        return false;
+    }
+
+    nlohmann::json trace;
+    try {
+        std::ifstream file(path);
+        trace = nlohmann::json::parse(file);
+    } catch (const std::exception& e) {
+        printf("The saved trace isn't valid JSON: %s\n", e.what());
+        return false;
+    }
+    std::filesystem::remove(path);
+
+    const auto& events = trace["traceEvents"];
+    if (!events.is_array() || events.size() != THREAD_COUNT * SPANS_PER_THREAD * 2) {
+        printf("Expected %d events, the trace has %zu\n", THREAD_COUNT * SPANS_PER_THREAD * 2, events.size());
+        return false;
+    }
+
+    // Per thread, each load has to lie inside the frame that follows it, spans are saved when they close
+    std::map<int, std::vector<nlohmann::json>> byThread;
+    for (const auto& event : events) {
+        if (event["ph"] != "X" || event["pid"] != 1 || !event["ts"].is_number_unsigned() ||
+            !event["dur"].is_number_unsigned()) {
+            printf("Malformed event %s\n", event.dump().c_str());
+            return false;
+        }
+        byThread[event["tid"].get<int>()].push_back(event);
+    }
+    if (byThread.size() != THREAD_COUNT) {
+        printf("Expected spans from %d threads, the trace has %zu\n", THREAD_COUNT, byThread.size());
+        return false;
+    }
+
+    for (const auto& [tid, spans] : byThread) {
+        for (size_t i = 0; i < spans.size(); i += 2) {
+            const auto& load = spans[i];
+            const auto& frame = spans[i + 1];
+            if (load["name"] != "load" || load["cat"] != "resource" || frame["name"] != "frame" ||
+                frame["cat"] != "gfx" || frame.contains("args")) {
+                printf("Thread %d: unexpected spans %s, %s\n", tid, load.dump().c_str(), frame.dump().c_str());
+                return false;
+            }
+            if (load["args"]["detail"] != sDetail) {
+                printf("Thread %d: the detail didn't survive, got %s\n", tid, load["args"]["detail"].dump().c_str());
+                return false;
+            }
+            const uint64_t loadEnd = load["ts"].get<uint64_t>() + load["dur"].get<uint64_t>();
+            const uint64_t frameEnd = frame["ts"].get<uint64_t>() + frame["dur"].get<uint64_t>();
+            if (load["ts"] < frame["ts"] || loadEnd > frameEnd) {
+                printf("Thread %d: a load isn't inside its frame\n", tid);
+                return false;
+            }
+        }
+    }
+
+    // A new start begins an empty recording
+    Ship::TraceEventsStart();
+    Ship::TraceEventsStop();
+    Ship::TraceEventsSave(path);
+    std::ifstream file(path);
+    const auto empty = nlohmann::json::parse(file);
+    file.close();
+    std::filesystem::remove(path);
+    if (!empty["traceEvents"].empty()) {
+        printf("Starting again kept %zu old events\n", empty["traceEvents"].size());
+        return false;
+    }
+
+    return true;
+}
+} // namespace
+
+int main() {
+    const bool passed = TestSave();
+
+    printf("%s\n", passed ? "Trace events save as valid Chrome trace JSON" : "Trace events don't save correctly");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,197 @@
+// Builds the same synthetic archive with Ship::ArchiveBuilder at 1, 2, 4 and one worker per hardware thread, printing
+// the throughput of each. The files mix text-like data, noise that doesn't compress and zeros, like the assets of an
+// OTR. Every build must store the same bytes at the same place, the (attributes) file is skipped since it holds the
+// time each file was added.
+#include "resource/Archive.h"
+#include "resource/ArchiveBuilder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <thread>
+
+#define FILE_COUNT 384
+#define MAX_FILE_SIZE (96 * 1024)
+
+namespace {
+struct StoredFile {
+    std::string Name;
+    ULONGLONG Offset;
+    DWORD Flags;
+    std::vector<char> Bytes;
+
+    bool operator==(const StoredFile& other) const {
+        return Name == other.Name && Offset == other.Offset && Flags == other.Flags && Bytes == other.Bytes;
+    }
+};
+
+std::vector<std::vector<char>> MakeFiles() {
+    static const char* sWords[] = { "gDPSetPrimColor", "Vtx", "0x00", "gsSPEndDisplayList", "DL_", "Tex", "1024" };
+    std::mt19937 rng(0x4F5452);
+    std::vector<std::vector<char>> files(FILE_COUNT);
+    for (size_t i = 0; i < files.size(); i++) {
+        std::vector<char>& data = files[i];
+        data.resize(rng() % MAX_FILE_SIZE + 1);
+        switch (i % 3) {
+            case 0:
+                for (size_t pos = 0; pos < data.size();) {
+                    const char* word = sWords[rng() % std::size(sWords)];
+                    while (*word != 0 && pos < data.size()) {
+                        data[pos++] = *word++;
+                    }
+                    if (pos < data.size()) {
+                        data[pos++] = ' ';
+                    }
+                }
+                break;
+            case 1:
+                std::generate(data.begin(), data.end(), [&rng] { return (char)rng(); });
+                break;
+            default:
+                std::fill(data.begin(), data.end(), 0);
+                break;
+        }
+    }
+
+    return files;
+}
+
+std::string FileName(size_t index) {
+    return "objects/bench/file_" + std::to_string(index);
+}
+
+// Returns the seconds the build took, or a negative value on failure
+double Build(const std::string& path, const std::vector<std::vector<char>>& files, size_t threadCount) {
+    std::filesystem::remove(path);
+    auto archive = Ship::Archive::CreateArchive(path, FILE_COUNT + 16);
+    if (archive == nullptr) {
+        return -1.0;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    Ship::ArchiveBuilder builder(archive, Ship::ArchiveCodec::Zlib, threadCount);
+    for (size_t i = 0; i < files.size(); i++) {
+        builder.AddFile(FileName(i), files[i]);
+    }
+    const bool success = builder.Finish();
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return success ? std::chrono::duration<double>(elapsed).count() : -1.0;
+}
+
+// Reads back where and how every file landed in the archive, and checks each one still reads as what was added
+bool ReadStoredFiles(const std::string& path, const std::vector<std::vector<char>>& files,
+                     std::vector<StoredFile>& stored) {
+    std::ifstream stream(path, std::ios::binary);
+    const std::vector<char> archiveBytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+
+    HANDLE mpq;
+    if (!SFileOpenArchive(path.c_str(), 0, MPQ_OPEN_READ_ONLY, &mpq)) {
+        printf("Failed to open %s\n", path.c_str());
+        return false;
+    }
+
+    bool success = true;
+    SFILE_FIND_DATA findData;
+    HANDLE find = SFileFindFirstFile(mpq, "*", &findData, nullptr);
+    for (bool found = find != nullptr; found && success; found = SFileFindNextFile(find, &findData)) {
+        if (strcmp(findData.cFileName, ATTRIBUTES_NAME) == 0) {
+            continue;
+        }
+
+        HANDLE file;
+        if (!SFileOpenFileEx(mpq, findData.cFileName, 0, &file)) {
+            printf("Failed to open %s in %s\n", findData.cFileName, path.c_str());
+            success = false;
+            break;
+        }
+
+        StoredFile entry;
+        entry.Name = findData.cFileName;
+        DWORD storedSize = 0;
+        SFileGetFileInfo(file, SFileInfoByteOffset, &entry.Offset, sizeof(entry.Offset), nullptr);
+        SFileGetFileInfo(file, SFileInfoCompressedSize, &storedSize, sizeof(storedSize), nullptr);
+        SFileGetFileInfo(file, SFileInfoFlags, &entry.Flags, sizeof(entry.Flags), nullptr);
+        if (entry.Offset + storedSize > archiveBytes.size()) {
+            printf("%s lies outside of %s\n", entry.Name.c_str(), path.c_str());
+            success = false;
+        } else {
+            entry.Bytes.assign(archiveBytes.begin() + entry.Offset, archiveBytes.begin() + entry.Offset + storedSize);
+        }
+
+        const std::string prefix = FileName(0).substr(0, FileName(0).size() - 1);
+        if (success && entry.Name.compare(0, prefix.size(), prefix) == 0) {
+            const std::vector<char>& expected = files[std::stoul(entry.Name.substr(prefix.size()))];
+            std::vector<char> data(SFileGetFileSize(file, nullptr));
+            DWORD read = 0;
+            SFileReadFile(file, data.data(), (DWORD)data.size(), &read, nullptr);
+            if (read != data.size() || data != expected) {
+                printf("%s doesn't read back as the data added\n", entry.Name.c_str());
+                success = false;
+            }
+        }
+
+        SFileCloseFile(file);
+        stored.push_back(std::move(entry));
+    }
+
+    if (find != nullptr) {
+        SFileFindClose(find);
+    }
+    SFileCloseArchive(mpq);
+
+    if (success && stored.size() != files.size() + 1) {
+        printf("%s has %zu files, expected %zu and the listfile\n", path.c_str(), stored.size(), files.size());
+        success = false;
+    }
+    return success;
+}
+} // namespace
+
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "lus_archive_builder_bench";
+    std::filesystem::create_directories(directory);
+    const std::vector<std::vector<char>> files = MakeFiles();
+    size_t totalSize = 0;
+    for (const std::vector<char>& data : files) {
+        totalSize += data.size();
+    }
+
+    std::vector<size_t> threadCounts = { 1, 2, 4 };
+    const size_t hardwareThreads = std::max(1U, std::thread::hardware_concurrency());
+    if (std::find(threadCounts.begin(), threadCounts.end(), hardwareThreads) == threadCounts.end()) {
+        threadCounts.push_back(hardwareThreads);
+    }
+
+    printf("%d files, %.1f MB\n", FILE_COUNT, totalSize / 1e6);
+    bool identical = true;
+    std::vector<StoredFile> reference;
+    for (size_t threadCount : threadCounts) {
+        const std::string path = (directory / ("bench_" + std::to_string(threadCount) + ".otr")).string();
+        const double seconds = Build(path, files, threadCount);
+        if (seconds < 0.0) {
+            printf("Building %s failed\n", path.c_str());
+            return 1;
+        }
+        printf("%3zu threads: %8.1f MB/s\n", threadCount, totalSize / seconds / 1e6);
+
+        std::vector<StoredFile> stored;
+        if (!ReadStoredFiles(path, files, stored)) {
+            return 1;
+        }
+        if (reference.empty()) {
+            reference = std::move(stored);
+        } else if (stored != reference) {
+            printf("The archive built with %zu threads differs from the one built with %zu\n", threadCount,
+                   threadCounts[0]);
+            identical = false;
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+    return identical ? 0 : 1;
+}
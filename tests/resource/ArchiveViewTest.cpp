@@ -0,0 +1,199 @@
+// Views into mapped archives against reads through StormLib. A read only Archive hands out files stored uncompressed
+// as views into a MappedFile. They have to match what SFileReadFile reads from the same archives and the bytes that
+// were added, also for files a patch MPQ replaces, for sizes around the sector size and for compressed files that
+// can't be viewed. Views have to stay valid after their archive is gone, and writing to one must not reach the disk.
+#include "resource/Archive.h"
+#include "resource/MappedFile.h"
+#include "resource/OtrFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+
+namespace {
+std::mt19937 sRng(0x4C5553);
+
+std::vector<char> RandomData(size_t size) {
+    std::vector<char> data(size);
+    std::generate(data.begin(), data.end(), [] { return (char)sRng(); });
+    return data;
+}
+
+std::vector<char> ReadFile(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+bool Matches(const std::shared_ptr<Ship::OtrFile>& file, const std::vector<char>& expected) {
+    return file != nullptr && file->IsLoaded && file->GetSize() == expected.size() &&
+           std::equal(expected.begin(), expected.end(), file->GetData());
+}
+
+bool CreateMpq(const std::filesystem::path& path, const std::map<std::string, std::vector<char>>& files,
+               DWORD compression) {
+    std::filesystem::remove(path);
+    auto archive = Ship::Archive::CreateArchive(path.string(), (int)files.size() + 8);
+    if (archive == nullptr) {
+        return false;
+    }
+
+    // Archive refuses an .otr without a version, little endian 0x12345678 here
+    const char version[] = { 0, 0x78, 0x56, 0x34, 0x12 };
+    bool success = archive->AddFile("version", (uintptr_t)version, sizeof(version), 0);
+    for (const auto& [name, data] : files) {
+        success = archive->AddFile(name, (uintptr_t)data.data(), data.size(), compression) && success;
+    }
+
+    return success;
+}
+
+bool TestMappedFile(const std::filesystem::path& directory) {
+    const std::filesystem::path path = directory / "mapped.bin";
+    const std::vector<char> data = RandomData(10000);
+    std::ofstream(path, std::ios::binary).write(data.data(), data.size());
+
+    bool passed = true;
+    auto mapping = Ship::MappedFile::Open(path.string());
+    if (mapping == nullptr) {
+        printf("Failed to map %s\n", path.string().c_str());
+        return false;
+    }
+    if (mapping->GetSize() != data.size() || !std::equal(data.begin(), data.end(), mapping->GetData())) {
+        printf("The mapping of %s doesn't show its bytes\n", path.string().c_str());
+        passed = false;
+    }
+
+    // The mapping is private, writes stay in this process
+    std::fill(mapping->GetData(), mapping->GetData() + mapping->GetSize(), 0x5A);
+    if (ReadFile(path) != data) {
+        printf("Writing to the mapping of %s changed the file\n", path.string().c_str());
+        passed = false;
+    }
+    auto otherMapping = Ship::MappedFile::Open(path.string());
+    if (otherMapping == nullptr || !std::equal(data.begin(), data.end(), otherMapping->GetData())) {
+        printf("Writing to one mapping of %s changed another\n", path.string().c_str());
+        passed = false;
+    }
+
+    std::ofstream(directory / "empty.bin", std::ios::binary);
+    if (Ship::MappedFile::Open((directory / "empty.bin").string()) != nullptr ||
+        Ship::MappedFile::Open((directory / "missing.bin").string()) != nullptr) {
+        printf("Mapped an empty or missing file\n");
+        passed = false;
+    }
+
+    return passed;
+}
+
+bool TestViewsMatchReads(const std::filesystem::path& directory) {
+    const std::filesystem::path mainPath = directory / "main.otr";
+    const std::filesystem::path patchesPath = directory / "patches";
+    std::filesystem::create_directories(patchesPath);
+
+    // Sizes around the 4 KiB sectors of a new archive, stored files are viewed and compressed ones read
+    std::map<std::string, std::vector<char>> storedFiles;
+    std::map<std::string, std::vector<char>> compressedFiles;
+    for (size_t size : { 1, 100, 4095, 4096, 4097, 50000, 200000 }) {
+        storedFiles["stored/file_" + std::to_string(size)] = RandomData(size);
+        compressedFiles["compressed/file_" + std::to_string(size)] = std::vector<char>(size, (char)size);
+    }
+    std::map<std::string, std::vector<char>> patchFiles = {
+        { "stored/file_4096", RandomData(4096) },
+        { "stored/file_50000", RandomData(1234) },
+        { "patch/new_file", RandomData(7000) },
+    };
+    if (!CreateMpq(mainPath, storedFiles, 0) ||
+        !CreateMpq(directory / "compressed.otr", compressedFiles, MPQ_COMPRESSION_ZLIB) ||
+        !CreateMpq(patchesPath / "patch.otr", patchFiles, 0)) {
+        printf("Failed to create the archives\n");
+        return false;
+    }
+
+    std::map<std::string, std::vector<char>> expected = storedFiles;
+    expected.insert(compressedFiles.begin(), compressedFiles.end());
+    for (const auto& [name, data] : patchFiles) {
+        expected[name] = data;
+    }
+
+    // The reference reads the same layers without Archive: the main MPQ read only, the patch applied on top
+    HANDLE mpqs[2];
+    if (!SFileOpenArchive(mainPath.string().c_str(), 0, MPQ_OPEN_READ_ONLY, &mpqs[0]) ||
+        !SFileOpenPatchArchive(mpqs[0], (patchesPath / "patch.otr").string().c_str(), "", 0) ||
+        !SFileOpenArchive((directory / "compressed.otr").string().c_str(), 0, MPQ_OPEN_READ_ONLY, &mpqs[1])) {
+        printf("Failed to open the archives with StormLib\n");
+        return false;
+    }
+    std::map<std::string, std::vector<char>> reads;
+    for (const auto& [path, data] : expected) {
+        HANDLE file;
+        if (SFileOpenFileEx(mpqs[path.starts_with("compressed/") ? 1 : 0], path.c_str(), 0, &file)) {
+            std::vector<char>& read = reads[path];
+            read.resize(SFileGetFileSize(file, nullptr));
+            DWORD readSize = 0;
+            SFileReadFile(file, read.data(), (DWORD)read.size(), &readSize, nullptr);
+            read.resize(readSize);
+            SFileCloseFile(file);
+        }
+    }
+    SFileCloseArchive(mpqs[0]);
+    SFileCloseArchive(mpqs[1]);
+
+    bool passed = true;
+    auto archive = std::make_shared<Ship::Archive>(mainPath.string(), patchesPath.string(),
+                                                   std::unordered_set<uint32_t>(), false, false);
+    Ship::Archive compressedArchive(std::vector<std::string>{ (directory / "compressed.otr").string() },
+                                    std::unordered_set<uint32_t>(), false, false);
+    for (const auto& [path, data] : expected) {
+        auto file = path.starts_with("compressed/") ? compressedArchive.LoadFile(path, false)
+                                                    : archive->LoadFile(path, false);
+        if (!Matches(file, reads[path]) || !Matches(file, data)) {
+            printf("%s doesn't match SFileReadFile and what was added\n", path.c_str());
+            passed = false;
+        }
+    }
+
+    // Platforms without mappings read every file
+    if (Ship::MappedFile::Open(mainPath.string()) == nullptr) {
+        return passed;
+    }
+
+    // Stored files of a read only archive are views, loading one twice hands out the same memory
+    auto first = archive->LoadFile("stored/file_200000", false);
+    auto second = archive->LoadFile("stored/file_200000", false);
+    if (first->GetData() != second->GetData()) {
+        printf("Stored files weren't handed out as views\n");
+        passed = false;
+    }
+
+    // A view keeps its mapping alive, writes to it stay in memory
+    archive.reset();
+    std::fill(first->GetData(), first->GetData() + first->GetSize(), 0);
+    if (!Matches(second, std::vector<char>(first->GetSize(), 0))) {
+        printf("A view didn't outlive its archive\n");
+        passed = false;
+    }
+    Ship::Archive reopened(mainPath.string(), "", std::unordered_set<uint32_t>(), false, false);
+    if (!Matches(reopened.LoadFile("stored/file_200000", false), storedFiles["stored/file_200000"])) {
+        printf("Writing to a view changed the archive on disk\n");
+        passed = false;
+    }
+
+    return passed;
+}
+} // namespace
+
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "lus_archive_view_test";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    bool passed = TestMappedFile(directory);
+    passed = TestViewsMatchReads(directory) && passed;
+
+    std::filesystem::remove_all(directory);
+    printf("%s\n", passed ? "Archive views match reads" : "Archive views don't match reads");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,219 @@
+// Round trip of ContainerWriter and ContainerArchive. Files of every kind are written with each StormLib compression
+// and have to load back byte for byte, looked up with any case and slash direction. Containers with a wrong magic or
+// version or a cut off directory have to be refused, and converting an .otr has to keep every file but the MPQ's own.
+#include "resource/Archive.h"
+#include "resource/ContainerArchive.h"
+#include "resource/OtrFile.h"
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+namespace {
+struct TestFile {
+    std::string Path;
+    std::vector<char> Data;
+};
+
+std::string TempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::vector<TestFile> MakeFiles() {
+    std::mt19937 rng(0x4C5553);
+    std::vector<TestFile> files;
+
+    TestFile text = { "objects/gameplay_keep/Text_Sample", {} };
+    const std::string line = "gsSPVertex(0x06001000, 32, 0), gsSP2Triangles(0, 1, 2, 0, 3, 4, 5, 0),\n";
+    for (int i = 0; i < 400; i++) {
+        text.Data.insert(text.Data.end(), line.begin(), line.end());
+    }
+    files.push_back(std::move(text));
+
+    TestFile noise = { "textures/Noise_Tex", std::vector<char>(20000) };
+    std::generate(noise.Data.begin(), noise.Data.end(), [&rng] { return (char)rng(); });
+    files.push_back(std::move(noise));
+
+    files.push_back({ "misc/zeros", std::vector<char>(70000, 0) });
+    files.push_back({ "misc/empty", {} });
+    files.push_back({ "misc/one_byte", { 0x42 } });
+    return files;
+}
+
+// Looks a path up the way an MPQ would accept it too
+std::string OtherSpelling(const std::string& path) {
+    std::string spelled = path;
+    for (char& c : spelled) {
+        c = c == '/' ? '\\' : (char)toupper((unsigned char)c);
+    }
+
+    return spelled;
+}
+
+bool WriteContainer(const std::string& path, const std::vector<TestFile>& files, uint32_t compression) {
+    Ship::ContainerWriter writer;
+    if (!writer.Open(path)) {
+        return false;
+    }
+    for (const TestFile& file : files) {
+        if (!writer.AddFile(file.Path, file.Data.data(), file.Data.size(), compression)) {
+            return false;
+        }
+    }
+
+    return writer.Close();
+}
+
+bool CheckFiles(Ship::ContainerArchive& container, const std::vector<TestFile>& files, const char* name) {
+    bool passed = true;
+    if (container.GetFileNames().size() != files.size()) {
+        printf("%s: %zu file names, expected %zu\n", name, container.GetFileNames().size(), files.size());
+        passed = false;
+    }
+
+    for (const TestFile& expected : files) {
+        for (const std::string& path : { expected.Path, OtherSpelling(expected.Path) }) {
+            Ship::OtrFile file;
+            if (!container.HasFile(path) || !container.LoadFile(path, file)) {
+                printf("%s: can't load %s\n", name, path.c_str());
+                passed = false;
+                continue;
+            }
+            if (file.GetSize() != expected.Data.size() ||
+                !std::equal(expected.Data.begin(), expected.Data.end(), file.GetData())) {
+                printf("%s: %s doesn't load back as written\n", name, path.c_str());
+                passed = false;
+            }
+        }
+    }
+
+    Ship::OtrFile missing;
+    if (container.HasFile("misc/missing") || container.LoadFile("misc/missing", missing)) {
+        printf("%s: found a file that was never written\n", name);
+        passed = false;
+    }
+
+    return passed;
+}
+
+bool TestRoundTrip() {
+    static const struct {
+        const char* Name;
+        uint32_t Compression;
+    } sCompressions[] = {
+        { "stored", 0 },
+        { "zlib", MPQ_COMPRESSION_ZLIB },
+        { "bzip2", MPQ_COMPRESSION_BZIP2 },
+        { "lzma", MPQ_COMPRESSION_LZMA },
+    };
+
+    const std::vector<TestFile> files = MakeFiles();
+    const std::string path = TempPath("lus_container_test.lus");
+    bool passed = true;
+    uintmax_t storedSize = 0;
+    for (const auto& compression : sCompressions) {
+        if (!WriteContainer(path, files, compression.Compression)) {
+            printf("%s: failed to write %s\n", compression.Name, path.c_str());
+            passed = false;
+            continue;
+        }
+
+        // The text and the zeros have to shrink, the noise has to fall back to being stored
+        const uintmax_t size = std::filesystem::file_size(path);
+        if (compression.Compression == 0) {
+            storedSize = size;
+        } else if (size >= storedSize - 70000) {
+            printf("%s: %ju bytes, the files weren't compressed\n", compression.Name, size);
+            passed = false;
+        }
+
+        auto container = Ship::ContainerArchive::Open(path);
+        if (container == nullptr) {
+            printf("%s: failed to open %s\n", compression.Name, path.c_str());
+            passed = false;
+            continue;
+        }
+        passed = CheckFiles(*container, files, compression.Name) && passed;
+    }
+
+    std::filesystem::remove(path);
+    return passed;
+}
+
+bool TestBadHeaders() {
+    const std::string path = TempPath("lus_container_test.lus");
+    if (!WriteContainer(path, MakeFiles(), MPQ_COMPRESSION_ZLIB)) {
+        printf("Failed to write %s\n", path.c_str());
+        return false;
+    }
+    std::ifstream stream(path, std::ios::binary);
+    const std::vector<char> good((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    stream.close();
+
+    bool passed = true;
+    auto check = [&](const char* name, std::vector<char> data) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(data.data(), data.size());
+        if (Ship::ContainerArchive::Open(path) != nullptr) {
+            printf("A container with %s was opened\n", name);
+            passed = false;
+        }
+    };
+
+    std::vector<char> data = good;
+    data[0] = 'X';
+    check("the wrong magic", data);
+    data = good;
+    data[4]++;
+    check("a newer version", data);
+    data = good;
+    data.resize(data.size() - 1);
+    check("its names cut off", data);
+    check("only half a header", std::vector<char>(good.begin(), good.begin() + 16));
+
+    std::filesystem::remove(path);
+    return passed;
+}
+
+bool TestConvertFromOtr() {
+    const std::string otrPath = TempPath("lus_container_test.otr");
+    const std::string containerPath = TempPath("lus_container_test.lus");
+    std::vector<TestFile> files = MakeFiles();
+    // Archive refuses an .otr without a version, little endian 0x12345678 here
+    files.push_back({ "version", { 0, 0x78, 0x56, 0x34, 0x12 } });
+    std::filesystem::remove(otrPath);
+    {
+        auto archive = Ship::Archive::CreateArchive(otrPath, 16);
+        if (archive == nullptr) {
+            printf("Failed to create %s\n", otrPath.c_str());
+            return false;
+        }
+        for (const TestFile& file : files) {
+            archive->AddFile(file.Path, (uintptr_t)file.Data.data(), file.Data.size());
+        }
+    }
+
+    bool passed = Ship::ContainerArchive::ConvertFromOtr(otrPath, containerPath, MPQ_COMPRESSION_ZLIB);
+    auto container = passed ? Ship::ContainerArchive::Open(containerPath) : nullptr;
+    if (container == nullptr) {
+        printf("Failed to convert %s\n", otrPath.c_str());
+        passed = false;
+    } else {
+        passed = CheckFiles(*container, files, "converted");
+    }
+
+    std::filesystem::remove(otrPath);
+    std::filesystem::remove(containerPath);
+    return passed;
+}
+} // namespace
+
+int main() {
+    bool passed = TestRoundTrip();
+    passed = TestBadHeaders() && passed;
+    passed = TestConvertFromOtr() && passed;
+
+    printf("%s\n", passed ? "Containers round trip" : "Containers don't round trip");
+    return passed ? 0 : 1;
+}
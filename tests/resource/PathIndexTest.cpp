@@ -0,0 +1,160 @@
+// PathIndex against SFileCheckWildCard run over every path, which is how StormLib answers a search. Paths like those of
+// an OTR, with mixed case and both slash directions, are queried with masks built from them: exact paths, prefixes with
+// '*', '?' in place of single characters and masks starting with a wildcard. Find has to return exactly the paths the
+// full scan matches, HasMatch whether there are any, and both have to follow removals.
+#include "resource/PathIndex.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <set>
+
+extern bool SFileCheckWildCard(const char* szString, const char* szWildCard);
+
+namespace {
+std::mt19937 sRng(0x4C5553);
+
+std::string RandomPath() {
+    static const char* sFolders[] = { "objects", "Objects", "textures", "scenes", "overlays", "audio", "misc" };
+    static const char* sNames[] = { "gameplay_keep", "Tex", "DL", "Vtx", "Room", "seq", "a", "ab", "abc", "object" };
+
+    std::string path;
+    const int depth = (int)(sRng() % 3) + 1;
+    for (int i = 0; i < depth; i++) {
+        path += sFolders[sRng() % std::size(sFolders)];
+        path += sRng() % 4 == 0 ? '\\' : '/';
+    }
+    path += sNames[sRng() % std::size(sNames)];
+    if (sRng() % 2 == 0) {
+        path += "_" + std::to_string(sRng() % 64);
+    }
+
+    return path;
+}
+
+// Changes the case of some letters and swaps some slashes, the mask then has to match like the path itself
+std::string Respell(std::string path) {
+    for (char& c : path) {
+        if (sRng() % 4 != 0) {
+            continue;
+        }
+        if (c == '/' || c == '\\') {
+            c = c == '/' ? '\\' : '/';
+        } else if (c >= 'a' && c <= 'z') {
+            c = c - 'a' + 'A';
+        } else if (c >= 'A' && c <= 'Z') {
+            c = c - 'A' + 'a';
+        }
+    }
+
+    return path;
+}
+
+std::string RandomMask(const std::vector<std::string>& paths) {
+    std::string mask = Respell(paths[sRng() % paths.size()]);
+    switch (sRng() % 6) {
+        case 0:
+            return mask;
+        case 1:
+            return mask.substr(0, sRng() % (mask.size() + 1)) + "*";
+        case 2:
+            for (int i = 0; i < 3; i++) {
+                mask[sRng() % mask.size()] = '?';
+            }
+            return mask;
+        case 3:
+            return "*" + mask.substr(sRng() % mask.size());
+        case 4: {
+            const size_t star = sRng() % mask.size();
+            return mask.substr(0, star) + "*" + mask.substr(star + sRng() % (mask.size() - star));
+        }
+        default:
+            return sRng() % 2 == 0 ? "*" : "*_?";
+    }
+}
+
+bool Check(const Ship::PathIndex& index, const std::multiset<std::string>& paths, const std::string& mask) {
+    std::multiset<std::string> expected;
+    for (const std::string& path : paths) {
+        if (SFileCheckWildCard(path.c_str(), mask.c_str())) {
+            expected.insert(path);
+        }
+    }
+
+    const std::vector<std::string> found = index.Find(mask);
+    if (std::multiset<std::string>(found.begin(), found.end()) != expected) {
+        printf("Find(\"%s\") returned %zu paths, a full scan matches %zu\n", mask.c_str(), found.size(),
+               expected.size());
+        return false;
+    }
+    if (index.HasMatch(mask) != !expected.empty()) {
+        printf("HasMatch(\"%s\") disagrees with a full scan\n", mask.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+bool TestMatchesFullScan() {
+    Ship::PathIndex index;
+    std::multiset<std::string> paths;
+    std::vector<std::string> added;
+    for (int i = 0; i < 3000; i++) {
+        const std::string path = RandomPath();
+        // Adding a path twice keeps one copy, like a file name found in two archives
+        if (paths.count(path) == 0) {
+            paths.insert(path);
+            added.push_back(path);
+        }
+        index.Add(path);
+    }
+    if (index.Size() != paths.size()) {
+        printf("The index holds %zu paths, %zu were added\n", index.Size(), paths.size());
+        return false;
+    }
+
+    bool passed = true;
+    for (int i = 0; i < 4000 && passed; i++) {
+        passed = Check(index, paths, RandomMask(added));
+    }
+
+    // Removing has to leave the other spellings of a path in place
+    std::shuffle(added.begin(), added.end(), sRng);
+    for (size_t i = 0; i < added.size() / 2 && passed; i++) {
+        index.Remove(added[i]);
+        paths.erase(added[i]);
+        passed = Check(index, paths, RandomMask(added)) && Check(index, paths, Respell(added[i]));
+    }
+
+    return passed;
+}
+
+bool TestContains() {
+    Ship::PathIndex index;
+    index.Add("objects/gameplay_keep/Tex");
+    index.Add("Objects\\Gameplay_Keep\\DL");
+
+    bool passed = true;
+    for (const char* path : { "objects/gameplay_keep/Tex", "OBJECTS\\GAMEPLAY_KEEP\\TEX", "objects/gameplay_keep/dl" }) {
+        if (!index.Contains(path)) {
+            printf("Contains(\"%s\") is false\n", path);
+            passed = false;
+        }
+    }
+    for (const char* path : { "objects/gameplay_keep", "objects/gameplay_keep/Te", "objects/gameplay_keep/Tex2" }) {
+        if (index.Contains(path)) {
+            printf("Contains(\"%s\") is true\n", path);
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+} // namespace
+
+int main() {
+    bool passed = TestMatchesFullScan();
+    passed = TestContains() && passed;
+
+    printf("%s\n", passed ? "The path index matches StormLib" : "The path index doesn't match StormLib");
+    return passed ? 0 : 1;
+}